@@ -0,0 +1,74 @@
+// Copyright 2021 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::rocksdb::{
+    BlockBasedOptions, Cache, ColumnFamilyOptions, DBCompressionType, DBOptions, LRUCacheOptions,
+    Writable, DB,
+};
+use super::test::Bencher;
+
+const PRIMARY_CACHE_CAPACITY: usize = 1024 * 1024;
+const NUM_KEYS: usize = 16 * 1024;
+
+// The uncompressed working set is about 16MB, 16 times the primary cache.
+fn run_bench_block_cache(b: &mut Bencher, name: &str, compressed_secondary_capacity: usize) {
+    let path = tempfile::Builder::new().prefix(name).tempdir().expect("");
+    let path_str = path.path().to_str().unwrap();
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+
+    let mut cache_opts = LRUCacheOptions::new();
+    cache_opts.set_capacity(PRIMARY_CACHE_CAPACITY);
+    cache_opts.set_compressed_secondary_capacity(compressed_secondary_capacity);
+    let mut block_opts = BlockBasedOptions::new();
+    block_opts.set_block_cache(&Cache::new_lru_cache(cache_opts));
+    let mut cf_opts = ColumnFamilyOptions::new();
+    cf_opts.set_block_based_table_factory(&block_opts);
+    cf_opts.compression(DBCompressionType::Lz4);
+
+    let db = DB::open_cf(opts, path_str, vec![("default", cf_opts)]).unwrap();
+
+    // Half of each value is repeated so that blocks compress to roughly 50%.
+    let mut value = vec![0; 1024];
+    for i in 0..NUM_KEYS {
+        for (j, v) in value.iter_mut().enumerate().take(512) {
+            *v = (i * 31 + j * 7) as u8;
+        }
+        db.put(format!("key_{:08}", i).as_bytes(), &value).unwrap();
+    }
+    db.flush(true).unwrap();
+
+    let mut i = 0;
+    b.iter(|| {
+        // A fixed stride walks the whole key space in a cache-unfriendly order.
+        let key = format!("key_{:08}", (i * 7919) % NUM_KEYS);
+        db.get(key.as_bytes()).unwrap();
+        i += 1;
+    });
+
+    drop(db);
+}
+
+#[bench]
+fn bench_block_cache_without_compressed_secondary(b: &mut Bencher) {
+    run_bench_block_cache(b, "_rust_rocksdb_block_cache_without_secondary", 0);
+}
+
+#[bench]
+fn bench_block_cache_with_compressed_secondary(b: &mut Bencher) {
+    run_bench_block_cache(
+        b,
+        "_rust_rocksdb_block_cache_with_secondary",
+        16 * PRIMARY_CACHE_CAPACITY,
+    );
+}
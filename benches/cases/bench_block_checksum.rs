@@ -0,0 +1,94 @@
+// Copyright 2021 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::rocksdb::{
+    BlockBasedOptions, ColumnFamilyOptions, DBChecksumType, DBCompressionType, DBOptions,
+    ReadOptions, Writable, DB,
+};
+use super::test::Bencher;
+
+const NUM_KEYS: usize = 16 * 1024;
+
+// Every get reads its block from the file and verifies it, so the cost of the
+// block checksum shows up in the time per get. Without a block cache the
+// order of the keys doesn't matter, so they are read in order.
+fn run_bench_block_checksum(b: &mut Bencher, name: &str, checksum: DBChecksumType) {
+    let path = tempfile::Builder::new().prefix(name).tempdir().expect("");
+    let path_str = path.path().to_str().unwrap();
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+
+    let mut block_opts = BlockBasedOptions::new();
+    block_opts.set_checksum(checksum);
+    block_opts.set_no_block_cache(true);
+    block_opts.set_block_size(64 * 1024);
+    let mut cf_opts = ColumnFamilyOptions::new();
+    cf_opts.set_block_based_table_factory(&block_opts);
+    cf_opts.compression(DBCompressionType::No);
+
+    let db = DB::open_cf(opts, path_str, vec![("default", cf_opts)]).unwrap();
+    let mut value = vec![0; 1024];
+    for i in 0..NUM_KEYS {
+        for (j, v) in value.iter_mut().enumerate() {
+            *v = (i * 31 + j * 7) as u8;
+        }
+        db.put(format!("key_{:08}", i).as_bytes(), &value).unwrap();
+    }
+    db.flush(true).unwrap();
+
+    let mut read_opts = ReadOptions::new();
+    read_opts.set_verify_checksums(true);
+    read_opts.fill_cache(false);
+    let mut i = 0;
+    b.iter(|| {
+        let key = format!("key_{:08}", i % NUM_KEYS);
+        db.get_opt(key.as_bytes(), &read_opts).unwrap().unwrap();
+        i += 1;
+    });
+}
+
+#[bench]
+fn bench_block_checksum_none(b: &mut Bencher) {
+    run_bench_block_checksum(
+        b,
+        "_rust_rocksdb_block_checksum_none",
+        DBChecksumType::NoChecksum,
+    );
+}
+
+#[bench]
+fn bench_block_checksum_crc32c(b: &mut Bencher) {
+    run_bench_block_checksum(
+        b,
+        "_rust_rocksdb_block_checksum_crc32c",
+        DBChecksumType::CRC32c,
+    );
+}
+
+#[bench]
+fn bench_block_checksum_xxhash(b: &mut Bencher) {
+    run_bench_block_checksum(
+        b,
+        "_rust_rocksdb_block_checksum_xxhash",
+        DBChecksumType::XXHash,
+    );
+}
+
+#[bench]
+fn bench_block_checksum_xxhash64(b: &mut Bencher) {
+    run_bench_block_checksum(
+        b,
+        "_rust_rocksdb_block_checksum_xxhash64",
+        DBChecksumType::XXHash64,
+    );
+}
@@ -0,0 +1,103 @@
+// Copyright 2021 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::rocksdb::{
+    ColumnFamilyOptions, CompactOptions, DBBottommostLevelCompaction, DBCompressionType, DBOptions,
+    Writable, DB,
+};
+use super::test::Bencher;
+
+const NUM_KEYS: usize = 8 * 1024;
+const VALUE_SIZE: usize = 512;
+
+// With zstd at a high level nearly all flush and compaction time is spent
+// compressing blocks.
+fn open_db(name: &str, zstd_level: i32) -> (tempfile::TempDir, DB) {
+    let path = tempfile::Builder::new().prefix(name).tempdir().expect("");
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    opts.set_max_background_jobs(4);
+    let mut cf_opts = ColumnFamilyOptions::new();
+    cf_opts.compression(DBCompressionType::Zstd);
+    cf_opts.set_compression_options(-14, zstd_level, 0, 0, 0);
+    cf_opts.set_disable_auto_compactions(true);
+    // Several output files give subcompactions boundaries to split at.
+    cf_opts.set_target_file_size_base(512 * 1024);
+    let db = DB::open_cf(
+        opts,
+        path.path().to_str().unwrap(),
+        vec![("default", cf_opts)],
+    )
+    .unwrap();
+    (path, db)
+}
+
+fn fill(db: &DB, round: usize) {
+    for i in 0..NUM_KEYS {
+        let value: Vec<u8> = (0..VALUE_SIZE)
+            .map(|j| ((i * 31 + j / 8 + round) % 61) as u8)
+            .collect();
+        db.put(format!("key_{:08}", i).as_bytes(), &value).unwrap();
+    }
+    db.flush(true).unwrap();
+}
+
+fn run_bench_flush(b: &mut Bencher, name: &str, zstd_level: i32) {
+    let (_path, db) = open_db(name, zstd_level);
+    let mut round = 0;
+    b.iter(|| {
+        fill(&db, round);
+        round += 1;
+    });
+}
+
+fn run_bench_compaction(b: &mut Bencher, name: &str, zstd_level: i32, subcompactions: i32) {
+    let (_path, db) = open_db(name, zstd_level);
+    for round in 0..4 {
+        fill(&db, round);
+    }
+    let mut compact_opts = CompactOptions::new();
+    compact_opts.set_max_subcompactions(subcompactions);
+    compact_opts.set_bottommost_level_compaction(DBBottommostLevelCompaction::Force);
+    let cf = db.cf_handle("default").unwrap();
+    db.compact_range_cf_opt(cf, &compact_opts, None, None);
+    // Every round recompresses the whole data set.
+    b.iter(|| {
+        db.compact_range_cf_opt(cf, &compact_opts, None, None);
+    });
+}
+
+#[bench]
+fn bench_flush_zstd_level_3(b: &mut Bencher) {
+    run_bench_flush(b, "_rust_rocksdb_bench_flush_zstd_level_3", 3);
+}
+
+#[bench]
+fn bench_flush_zstd_level_19(b: &mut Bencher) {
+    run_bench_flush(b, "_rust_rocksdb_bench_flush_zstd_level_19", 19);
+}
+
+#[bench]
+fn bench_compaction_zstd_level_19(b: &mut Bencher) {
+    run_bench_compaction(b, "_rust_rocksdb_bench_compaction_zstd_level_19", 19, 1);
+}
+
+#[bench]
+fn bench_compaction_zstd_level_19_subcompactions_4(b: &mut Bencher) {
+    run_bench_compaction(
+        b,
+        "_rust_rocksdb_bench_compaction_zstd_level_19_subcompactions_4",
+        19,
+        4,
+    );
+}
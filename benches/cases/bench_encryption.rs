@@ -0,0 +1,129 @@
+// Copyright 2021 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::Arc;
+
+#[cfg(feature = "encryption")]
+use super::rocksdb::DBEncryptionMethod;
+use super::rocksdb::{
+    BlockBasedOptions, ColumnFamilyOptions, DBCompressionType, DBOptions, Env, Writable, DB,
+};
+use super::test::Bencher;
+
+const NUM_KEYS: usize = 4 * 1024;
+
+fn plain_env() -> Arc<Env> {
+    Arc::new(Env::default())
+}
+
+#[cfg(feature = "encryption")]
+fn aes_ctr_env() -> Arc<Env> {
+    Arc::new(
+        Env::new_aes_ctr_encrypted_env(plain_env(), DBEncryptionMethod::Aes256Ctr, &[7; 32])
+            .unwrap(),
+    )
+}
+
+// Without compression or a block cache, every flushed, compacted or read
+// byte goes through the env.
+fn open_db(name: &str, env: Arc<Env>) -> (tempfile::TempDir, DB) {
+    let path = tempfile::Builder::new().prefix(name).tempdir().expect("");
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    opts.set_env(env);
+    let mut block_opts = BlockBasedOptions::new();
+    block_opts.set_no_block_cache(true);
+    let mut cf_opts = ColumnFamilyOptions::new();
+    cf_opts.set_block_based_table_factory(&block_opts);
+    cf_opts.compression(DBCompressionType::No);
+    cf_opts.set_disable_auto_compactions(true);
+    let db = DB::open_cf(
+        opts,
+        path.path().to_str().unwrap(),
+        vec![("default", cf_opts)],
+    )
+    .unwrap();
+    (path, db)
+}
+
+fn fill(db: &DB, round: usize) {
+    let value = vec![round as u8; 1024];
+    for i in 0..NUM_KEYS {
+        db.put(format!("key_{:08}", i).as_bytes(), &value).unwrap();
+    }
+    db.flush(true).unwrap();
+}
+
+fn run_bench_flush(b: &mut Bencher, name: &str, env: Arc<Env>) {
+    let (_path, db) = open_db(name, env);
+    let mut round = 0;
+    b.iter(|| {
+        fill(&db, round);
+        round += 1;
+    });
+}
+
+fn run_bench_compaction(b: &mut Bencher, name: &str, env: Arc<Env>) {
+    let (_path, db) = open_db(name, env);
+    for round in 0..4 {
+        fill(&db, round);
+    }
+    // Every round rewrites the whole data set.
+    b.iter(|| {
+        db.compact_range(None, None);
+    });
+}
+
+fn run_bench_point_read(b: &mut Bencher, name: &str, env: Arc<Env>) {
+    let (_path, db) = open_db(name, env);
+    fill(&db, 0);
+    let mut i = 0;
+    b.iter(|| {
+        let key = format!("key_{:08}", (i * 7919) % NUM_KEYS);
+        db.get(key.as_bytes()).unwrap();
+        i += 1;
+    });
+}
+
+#[bench]
+fn bench_flush_plain(b: &mut Bencher) {
+    run_bench_flush(b, "_rust_rocksdb_bench_flush_plain", plain_env());
+}
+
+#[cfg(feature = "encryption")]
+#[bench]
+fn bench_flush_aes_ctr(b: &mut Bencher) {
+    run_bench_flush(b, "_rust_rocksdb_bench_flush_aes_ctr", aes_ctr_env());
+}
+
+#[bench]
+fn bench_compaction_plain(b: &mut Bencher) {
+    run_bench_compaction(b, "_rust_rocksdb_bench_compaction_plain", plain_env());
+}
+
+#[cfg(feature = "encryption")]
+#[bench]
+fn bench_compaction_aes_ctr(b: &mut Bencher) {
+    run_bench_compaction(b, "_rust_rocksdb_bench_compaction_aes_ctr", aes_ctr_env());
+}
+
+#[bench]
+fn bench_point_read_plain(b: &mut Bencher) {
+    run_bench_point_read(b, "_rust_rocksdb_bench_point_read_plain", plain_env());
+}
+
+#[cfg(feature = "encryption")]
+#[bench]
+fn bench_point_read_aes_ctr(b: &mut Bencher) {
+    run_bench_point_read(b, "_rust_rocksdb_bench_point_read_aes_ctr", aes_ctr_env());
+}
@@ -0,0 +1,130 @@
+// Copyright 2021 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::fs;
+use std::path::Path;
+
+use super::rocksdb::{ColumnFamilyOptions, DBOptions, Writable, DB};
+use super::test::Bencher;
+
+const NUM_FILES: usize = 256;
+const KEYS_PER_FILE: usize = 64;
+
+fn cf_options() -> ColumnFamilyOptions {
+    let mut cf_opts = ColumnFamilyOptions::new();
+    // Keep every flushed file around to be opened.
+    cf_opts.set_disable_auto_compactions(true);
+    cf_opts
+}
+
+fn prepare_db(name: &str) -> tempfile::TempDir {
+    let dir = tempfile::Builder::new().prefix(name).tempdir().unwrap();
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    let db = DB::open_cf(
+        opts,
+        dir.path().to_str().unwrap(),
+        vec![("default", cf_options())],
+    )
+    .unwrap();
+    for f in 0..NUM_FILES {
+        for k in 0..KEYS_PER_FILE {
+            db.put(format!("key_{:06}_{:04}", k, f).as_bytes(), &[b'v'; 64])
+                .unwrap();
+        }
+        db.flush(true).unwrap();
+    }
+    dir
+}
+
+// Every reopen loads all table readers, as with `max_open_files` = -1.
+fn run_bench_open(b: &mut Bencher, name: &str, threads: i32, skip_checks: bool) {
+    let dir = prepare_db(name);
+    b.iter(|| {
+        let mut opts = DBOptions::new();
+        opts.set_max_open_files(-1);
+        opts.set_max_file_opening_threads(threads);
+        opts.set_skip_stats_update_on_db_open(skip_checks);
+        opts.set_skip_checking_sst_file_sizes_on_db_open(skip_checks);
+        let (_db, profile) = DB::open_cf_with_profile(
+            opts,
+            dir.path().to_str().unwrap(),
+            vec![("default", cf_options())],
+        )
+        .unwrap();
+        assert!(profile.table_opening.file_count >= NUM_FILES as u64);
+    });
+}
+
+#[bench]
+fn bench_open_1_thread(b: &mut Bencher) {
+    run_bench_open(b, "bench_open_1_thread", 1, false);
+}
+
+#[bench]
+fn bench_open_16_threads(b: &mut Bencher) {
+    run_bench_open(b, "bench_open_16_threads", 16, false);
+}
+
+#[bench]
+fn bench_open_16_threads_skip_checks(b: &mut Bencher) {
+    run_bench_open(b, "bench_open_16_threads_skip_checks", 16, true);
+}
+
+const WAL_KEYS: usize = 64 * 1024;
+
+fn copy_dir(src: &Path, dst: &Path) {
+    fs::create_dir(dst).unwrap();
+    for entry in fs::read_dir(src).unwrap() {
+        let entry = entry.unwrap();
+        fs::copy(entry.path(), dst.join(entry.file_name())).unwrap();
+    }
+}
+
+// Each iteration recovers a copy of a DB closed with all its data only in
+// the WAL, so the copy is part of the measured time in both cases.
+fn run_bench_recovery(b: &mut Bencher, name: &str, avoid_flush: bool) {
+    let dir = tempfile::Builder::new().prefix(name).tempdir().unwrap();
+    let src = dir.path().join("src");
+    {
+        let mut opts = DBOptions::new();
+        opts.create_if_missing(true);
+        opts.set_avoid_flush_during_shutdown(true);
+        let db = DB::open(opts, src.to_str().unwrap()).unwrap();
+        for i in 0..WAL_KEYS {
+            db.put(format!("key_{:08}", i).as_bytes(), &[b'v'; 128])
+                .unwrap();
+        }
+    }
+    let mut n = 0;
+    b.iter(|| {
+        let dst = dir.path().join(format!("dst_{}", n));
+        n += 1;
+        copy_dir(&src, &dst);
+        let mut opts = DBOptions::new();
+        opts.set_avoid_flush_during_recovery(avoid_flush);
+        let cfds: Vec<&str> = vec![];
+        let (_db, profile) = DB::open_cf_with_profile(opts, dst.to_str().unwrap(), cfds).unwrap();
+        assert_eq!(profile.wal_recovered_entries, WAL_KEYS as u64);
+    });
+}
+
+#[bench]
+fn bench_recovery_flush(b: &mut Bencher) {
+    run_bench_recovery(b, "bench_recovery_flush", false);
+}
+
+#[bench]
+fn bench_recovery_avoid_flush(b: &mut Bencher) {
+    run_bench_recovery(b, "bench_recovery_avoid_flush", true);
+}
@@ -0,0 +1,110 @@
+// Copyright 2021 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Arc;
+use std::thread;
+
+use super::rocksdb::{DBOptions, SeekKey, Writable, DB};
+use super::test::Bencher;
+
+const NUM_KEYS: usize = 64 * 1024;
+const VALUE_SIZE: usize = 128;
+const NUM_SCANNERS: usize = 4;
+
+fn open_primary(path: &str) -> Arc<DB> {
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    // Required by secondary instances.
+    opts.set_max_open_files(-1);
+    let db = DB::open(opts, path).unwrap();
+    for i in 0..NUM_KEYS {
+        db.put(format!("key_{:08}", i).as_bytes(), &[b'v'; VALUE_SIZE])
+            .unwrap();
+    }
+    db.flush(true).unwrap();
+    Arc::new(db)
+}
+
+// Runs NUM_SCANNERS full scans of `scan_db` at once while a writer keeps
+// updating the primary, as foreground traffic would. When `catch_up` is set,
+// `scan_db` is a secondary and tails the primary before every round of scans.
+fn run_bench_scans(b: &mut Bencher, primary: Arc<DB>, scan_db: Arc<DB>, catch_up: bool) {
+    let stop = Arc::new(AtomicBool::new(false));
+    let writer = {
+        let (primary, stop) = (primary.clone(), stop.clone());
+        thread::spawn(move || {
+            let mut i = 0;
+            while !stop.load(Ordering::Relaxed) {
+                let key = format!("key_{:08}", i % NUM_KEYS);
+                primary.put(key.as_bytes(), &[b'w'; VALUE_SIZE]).unwrap();
+                i += 1;
+            }
+        })
+    };
+    b.iter(|| {
+        if catch_up {
+            scan_db.try_catch_up_with_primary().unwrap();
+        }
+        let scanners: Vec<_> = (0..NUM_SCANNERS)
+            .map(|_| {
+                let db = scan_db.clone();
+                thread::spawn(move || {
+                    let mut iter = db.iter();
+                    let mut count = 0;
+                    iter.seek(SeekKey::Start).unwrap();
+                    while iter.valid().unwrap() {
+                        count += 1;
+                        iter.next().unwrap();
+                    }
+                    assert_eq!(count, NUM_KEYS);
+                })
+            })
+            .collect();
+        for scanner in scanners {
+            scanner.join().unwrap();
+        }
+    });
+    stop.store(true, Ordering::Relaxed);
+    writer.join().unwrap();
+}
+
+#[bench]
+fn bench_scans_on_primary(b: &mut Bencher) {
+    let dir = tempfile::Builder::new()
+        .prefix("bench_scans_on_primary")
+        .tempdir()
+        .unwrap();
+    let primary = open_primary(dir.path().to_str().unwrap());
+    run_bench_scans(b, primary.clone(), primary, false);
+}
+
+#[bench]
+fn bench_scans_on_secondary(b: &mut Bencher) {
+    let dir = tempfile::Builder::new()
+        .prefix("bench_scans_on_secondary")
+        .tempdir()
+        .unwrap();
+    let path = dir.path().join("primary");
+    let primary = open_primary(path.to_str().unwrap());
+    let mut opts = DBOptions::new();
+    opts.set_max_open_files(-1);
+    // The secondary has its own block cache and mutex.
+    let secondary = DB::open_as_secondary(
+        opts,
+        path.to_str().unwrap(),
+        dir.path().join("secondary").to_str().unwrap(),
+    )
+    .unwrap();
+    run_bench_scans(b, primary, Arc::new(secondary), true);
+}
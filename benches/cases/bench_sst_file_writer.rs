@@ -0,0 +1,150 @@
+// Copyright 2021 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::rocksdb::{
+    ColumnFamilyOptions, DBCompressionType, DBOptions, EnvOptions, ParallelSstFileWriter,
+    SnapshotExporter, SstFileWriter, Writable, DB,
+};
+use super::test::Bencher;
+
+const NUM_KEYS: usize = 64 * 1024;
+const VALUE_SIZE: usize = 256;
+const TARGET_FILE_SIZE: u64 = 2 * 1024 * 1024;
+
+// Compression dominates the cost of building a file.
+fn cf_options() -> ColumnFamilyOptions {
+    let mut opts = ColumnFamilyOptions::new();
+    opts.compression(DBCompressionType::Zstd);
+    opts
+}
+
+fn value(i: usize) -> Vec<u8> {
+    (0..VALUE_SIZE)
+        .map(|j| ((i * 7 + j / 16) % 251) as u8)
+        .collect()
+}
+
+#[bench]
+fn bench_sst_file_writer_sequential(b: &mut Bencher) {
+    let dir = tempfile::Builder::new()
+        .prefix("bench_sst_file_writer_sequential")
+        .tempdir()
+        .unwrap();
+    b.iter(|| {
+        let mut writer = SstFileWriter::new(EnvOptions::new(), cf_options());
+        let mut file_num = 0;
+        let mut open = false;
+        // Cut by input size, like ParallelSstFileWriter does.
+        let mut input_size = 0;
+        for i in 0..NUM_KEYS {
+            if !open {
+                let path = dir.path().join(format!("{:06}.sst", file_num));
+                writer.open(path.to_str().unwrap()).unwrap();
+                open = true;
+            }
+            let key = format!("key_{:08}", i);
+            writer.put(key.as_bytes(), &value(i)).unwrap();
+            input_size += (key.len() + VALUE_SIZE) as u64;
+            if input_size >= TARGET_FILE_SIZE {
+                writer.finish().unwrap();
+                file_num += 1;
+                open = false;
+                input_size = 0;
+            }
+        }
+        if open {
+            writer.finish().unwrap();
+        }
+    });
+}
+
+fn run_bench_parallel(b: &mut Bencher, num_threads: usize) {
+    let dir = tempfile::Builder::new()
+        .prefix("bench_sst_file_writer_parallel")
+        .tempdir()
+        .unwrap();
+    let prefix = dir.path().join("bulk_");
+    b.iter(|| {
+        let mut writer = ParallelSstFileWriter::new(
+            EnvOptions::new(),
+            cf_options(),
+            prefix.to_str().unwrap(),
+            TARGET_FILE_SIZE,
+            num_threads,
+        );
+        for i in 0..NUM_KEYS {
+            writer
+                .put(format!("key_{:08}", i).as_bytes(), &value(i))
+                .unwrap();
+        }
+        writer.finish().unwrap();
+    });
+}
+
+#[bench]
+fn bench_sst_file_writer_parallel_1(b: &mut Bencher) {
+    run_bench_parallel(b, 1);
+}
+
+#[bench]
+fn bench_sst_file_writer_parallel_4(b: &mut Bencher) {
+    run_bench_parallel(b, 4);
+}
+
+fn run_bench_snapshot_export(b: &mut Bencher, num_threads: usize) {
+    let dir = tempfile::Builder::new()
+        .prefix("bench_snapshot_export")
+        .tempdir()
+        .unwrap();
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    let db = DB::open_cf(
+        opts,
+        dir.path().join("db").to_str().unwrap(),
+        vec![("default", cf_options())],
+    )
+    .unwrap();
+    for i in 0..NUM_KEYS {
+        db.put(format!("key_{:08}", i).as_bytes(), &value(i))
+            .unwrap();
+    }
+    db.flush(true).unwrap();
+    let cf = db.cf_handle("default").unwrap();
+    let snap = db.snapshot();
+    let mut n = 0;
+    b.iter(|| {
+        let out = dir.path().join(format!("export_{}", n));
+        n += 1;
+        std::fs::create_dir(&out).unwrap();
+        let mut exporter = SnapshotExporter::new(&snap, out.to_str().unwrap(), num_threads);
+        // Four regions of equal size.
+        let bounds: Vec<String> = (0..=4)
+            .map(|r| format!("key_{:08}", r * NUM_KEYS / 4))
+            .collect();
+        for r in 0..4 {
+            let end = if r == 3 { "" } else { bounds[r + 1].as_str() };
+            exporter.add_range(cf, bounds[r].as_bytes(), end.as_bytes());
+        }
+        exporter.run().unwrap();
+    });
+}
+
+#[bench]
+fn bench_snapshot_export_1(b: &mut Bencher) {
+    run_bench_snapshot_export(b, 1);
+}
+
+#[bench]
+fn bench_snapshot_export_4(b: &mut Bencher) {
+    run_bench_snapshot_export(b, 4);
+}
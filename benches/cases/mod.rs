@@ -5,4 +5,11 @@ extern crate rand;
 extern crate rocksdb;
 extern crate tempfile;
 
+mod bench_block_cache;
+mod bench_block_checksum;
+mod bench_compression;
+mod bench_encryption;
+mod bench_open;
+mod bench_secondary;
+mod bench_sst_file_writer;
 mod bench_wal;
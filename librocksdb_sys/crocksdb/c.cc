@@ -11,9 +11,21 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "db/column_family.h"
+#include "monitoring/histogram.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/compaction_filter.h"
 #include "rocksdb/comparator.h"
@@ -32,6 +44,7 @@
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/options.h"
 #include "rocksdb/perf_context.h"
+#include "rocksdb/persistent_cache.h"
 #include "rocksdb/rate_limiter.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/sst_dump_tool.h"
@@ -41,22 +54,38 @@
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
 #include "rocksdb/table_properties.h"
+#include "rocksdb/threadpool.h"
+#include "rocksdb/trace_reader_writer.h"
 #include "rocksdb/types.h"
 #include "rocksdb/universal_compaction.h"
 #include "rocksdb/utilities/backupable_db.h"
+#include "rocksdb/utilities/checkpoint.h"
 #include "rocksdb/utilities/db_ttl.h"
 #include "rocksdb/utilities/debug.h"
 #include "rocksdb/utilities/options_util.h"
 #include "rocksdb/utilities/table_properties_collectors.h"
+#include "rocksdb/wal_filter.h"
 #include "rocksdb/write_batch.h"
+#include "rocksdb/write_buffer_manager.h"
 #include "src/blob_format.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/sst_file_writer_collectors.h"
 #include "table/table_reader.h"
+#include "trace_replay/block_cache_tracer.h"
+#include "trace_replay/trace_replay.h"
 #include "titan/db.h"
 #include "titan/options.h"
 #include "util/coding.h"
+#include "util/crc32c.h"
 #include "util/file_reader_writer.h"
+#include "util/file_util.h"
+#include "util/mutexlock.h"
+#include "util/xxhash.h"
+
+#ifdef OPENSSL
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#endif
 
 #if !defined(ROCKSDB_MAJOR) || !defined(ROCKSDB_MINOR) || \
     !defined(ROCKSDB_PATCH)
@@ -74,6 +103,7 @@ using rocksdb::BackupInfo;
 using rocksdb::BlockBasedTableOptions;
 using rocksdb::BlockCipher;
 using rocksdb::Cache;
+using rocksdb::Checkpoint;
 using rocksdb::ColumnFamilyDescriptor;
 using rocksdb::ColumnFamilyHandle;
 using rocksdb::ColumnFamilyOptions;
@@ -105,6 +135,7 @@ using rocksdb::FlushJobInfo;
 using rocksdb::FlushOptions;
 using rocksdb::HistogramData;
 using rocksdb::InfoLogLevel;
+using rocksdb::IngestExternalFileArg;
 using rocksdb::IngestExternalFileOptions;
 using rocksdb::Iterator;
 using rocksdb::KeyVersion;
@@ -143,10 +174,13 @@ using rocksdb::TableProperties;
 using rocksdb::TablePropertiesCollection;
 using rocksdb::TablePropertiesCollector;
 using rocksdb::TablePropertiesCollectorFactory;
+using rocksdb::TraceReader;
+using rocksdb::TraceWriter;
 using rocksdb::UserCollectedProperties;
 using rocksdb::WALRecoveryMode;
 using rocksdb::WritableFile;
 using rocksdb::WriteBatch;
+using rocksdb::WriteBufferManager;
 using rocksdb::WriteOptions;
 using rocksdb::WriteStallCondition;
 using rocksdb::WriteStallInfo;
@@ -166,15 +200,18 @@ using rocksdb::LDBTool;
 using rocksdb::LevelMetaData;
 using rocksdb::PerfContext;
 using rocksdb::PerfLevel;
+using rocksdb::PersistentCache;
 using rocksdb::PutFixed64;
 using rocksdb::RandomAccessFile;
 using rocksdb::RandomAccessFileReader;
 using rocksdb::RandomRWFile;
+using rocksdb::ReadLock;
 using rocksdb::SSTDumpTool;
 using rocksdb::SstFileMetaData;
 using rocksdb::TableReader;
 using rocksdb::TableReaderOptions;
 using rocksdb::VectorRepFactory;
+using rocksdb::WriteLock;
 
 using rocksdb::kMaxSequenceNumber;
 
@@ -204,8 +241,18 @@ extern "C" {
 
 const char* block_base_table_str = "BlockBasedTable";
 
+// Which user of DB::StartTrace is running on a DB. The DB takes one trace at
+// a time, and 6.4 silently replaces a running one.
+struct TraceState {
+  enum Kind { kNone, kQueryTrace, kBlockCacheRecording };
+  std::mutex mutex;
+  Kind running = kNone;
+};
 struct crocksdb_t {
   DB* rep;
+  // Env installed for the lifetime of the DB by an open with profile.
+  std::unique_ptr<Env> profiling_env;
+  TraceState trace_state;
 };
 struct crocksdb_status_ptr_t {
   Status* rep;
@@ -219,6 +266,11 @@ struct crocksdb_backup_engine_info_t {
 struct crocksdb_restore_options_t {
   RestoreOptions rep;
 };
+struct crocksdb_backupable_db_options_t {
+  explicit crocksdb_backupable_db_options_t(const std::string& backup_dir)
+      : rep(backup_dir) {}
+  BackupableDBOptions rep;
+};
 struct crocksdb_iterator_t {
   Iterator* rep;
 };
@@ -242,8 +294,12 @@ struct crocksdb_readoptions_t {
 struct crocksdb_writeoptions_t {
   WriteOptions rep;
 };
+class PriorityRateLimiter;
 struct crocksdb_options_t {
   Options rep;
+  // The limiter set through crocksdb_options_set_ratelimiter, if it is a
+  // PriorityRateLimiter. Only valid while it is still `rep.rate_limiter`.
+  std::shared_ptr<PriorityRateLimiter> priority_rate_limiter;
 };
 struct crocksdb_column_family_descriptor {
   ColumnFamilyDescriptor rep;
@@ -309,9 +365,23 @@ struct crocksdb_logger_impl_t : public Logger {
 };
 struct crocksdb_lru_cache_options_t {
   LRUCacheOptions rep;
+  size_t compressed_secondary_capacity = 0;
+  int compressed_secondary_num_shard_bits = -1;
+  shared_ptr<PersistentCache> persistent_cache;
 };
 struct crocksdb_cache_t {
   shared_ptr<Cache> rep;
+  // Optional tier keeping blocks in compressed form behind `rep`. It is wired
+  // in as `block_cache_compressed` of the block based table options.
+  shared_ptr<Cache> compressed_secondary;
+  // Optional tier on local storage, wired in as `persistent_cache`.
+  shared_ptr<PersistentCache> persistent_cache;
+};
+struct crocksdb_persistent_cache_t {
+  shared_ptr<PersistentCache> rep;
+};
+struct crocksdb_write_buffer_manager_t {
+  shared_ptr<WriteBufferManager> rep;
 };
 struct crocksdb_memory_allocator_t {
   shared_ptr<MemoryAllocator> rep;
@@ -319,6 +389,16 @@ struct crocksdb_memory_allocator_t {
 struct crocksdb_livefiles_t {
   std::vector<LiveFileMetaData> rep;
 };
+struct crocksdb_livefiles_diff_t {
+  DB* db;
+  // Whether file deletions are disabled on behalf of this diff.
+  bool holding_files;
+  // Live files at the time of the diff, sorted by name, which the next diff
+  // is taken against.
+  std::vector<LiveFileMetaData> files;
+  crocksdb_livefiles_t added;
+  crocksdb_livefiles_t removed;
+};
 struct crocksdb_column_family_handle_t {
   ColumnFamilyHandle* rep;
 };
@@ -334,14 +414,21 @@ struct crocksdb_ingestexternalfileoptions_t {
 struct crocksdb_sstfilereader_t {
   SstFileReader* rep;
 };
+class FileChecksumEnv;
 struct crocksdb_sstfilewriter_t {
   SstFileWriter* rep;
+  std::unique_ptr<FileChecksumEnv> checksum_env;
 };
 struct crocksdb_externalsstfileinfo_t {
   ExternalSstFileInfo rep;
+  std::string file_checksum;
+  std::string file_checksum_func_name;
 };
 struct crocksdb_ratelimiter_t {
   std::shared_ptr<RateLimiter> rep;
+  // Set if `rep` is a PriorityRateLimiter, which also serves the mid and user
+  // priorities. Kept after `rep` is moved into options, for the statistics.
+  std::shared_ptr<PriorityRateLimiter> priority;
 };
 struct crocksdb_histogramdata_t {
   HistogramData rep;
@@ -675,8 +762,11 @@ struct crocksdb_sst_partitioner_factory_t {
   std::shared_ptr<SstPartitionerFactory> rep;
 };
 
+class TokenBucketFileSystemInspector;
 struct crocksdb_file_system_inspector_t {
   std::shared_ptr<FileSystemInspector> rep;
+  // Set if `rep` is a TokenBucketFileSystemInspector, for its counters.
+  std::shared_ptr<TokenBucketFileSystemInspector> token_bucket;
 };
 
 static bool SaveError(char** errptr, const Status& s) {
@@ -737,6 +827,25 @@ crocksdb_t* crocksdb_open_for_read_only(const crocksdb_options_t* options,
   return result;
 }
 
+crocksdb_t* crocksdb_open_as_secondary(const crocksdb_options_t* options,
+                                       const char* name,
+                                       const char* secondary_path,
+                                       char** errptr) {
+  DB* db;
+  if (SaveError(errptr,
+                DB::OpenAsSecondary(options->rep, std::string(name),
+                                    std::string(secondary_path), &db))) {
+    return nullptr;
+  }
+  crocksdb_t* result = new crocksdb_t;
+  result->rep = db;
+  return result;
+}
+
+void crocksdb_try_catch_up_with_primary(crocksdb_t* db, char** errptr) {
+  SaveError(errptr, db->rep->TryCatchUpWithPrimary());
+}
+
 void crocksdb_status_ptr_get_error(crocksdb_status_ptr_t* status,
                                    char** errptr) {
   SaveError(errptr, *(status->rep));
@@ -754,11 +863,86 @@ crocksdb_backup_engine_t* crocksdb_backup_engine_open(
   return result;
 }
 
+crocksdb_backupable_db_options_t* crocksdb_backupable_db_options_create(
+    const char* backup_dir) {
+  return new crocksdb_backupable_db_options_t(std::string(backup_dir));
+}
+
+void crocksdb_backupable_db_options_destroy(
+    crocksdb_backupable_db_options_t* opt) {
+  delete opt;
+}
+
+void crocksdb_backupable_db_options_set_share_table_files(
+    crocksdb_backupable_db_options_t* opt, unsigned char v) {
+  opt->rep.share_table_files = v;
+}
+
+void crocksdb_backupable_db_options_set_share_files_with_checksum(
+    crocksdb_backupable_db_options_t* opt, unsigned char v) {
+  opt->rep.share_files_with_checksum = v;
+}
+
+void crocksdb_backupable_db_options_set_sync(
+    crocksdb_backupable_db_options_t* opt, unsigned char v) {
+  opt->rep.sync = v;
+}
+
+void crocksdb_backupable_db_options_set_backup_log_files(
+    crocksdb_backupable_db_options_t* opt, unsigned char v) {
+  opt->rep.backup_log_files = v;
+}
+
+void crocksdb_backupable_db_options_set_max_background_operations(
+    crocksdb_backupable_db_options_t* opt, int v) {
+  opt->rep.max_background_operations = v;
+}
+
+void crocksdb_backupable_db_options_set_callback_trigger_interval_size(
+    crocksdb_backupable_db_options_t* opt, uint64_t v) {
+  opt->rep.callback_trigger_interval_size = v;
+}
+
+void crocksdb_backupable_db_options_set_backup_rate_limiter(
+    crocksdb_backupable_db_options_t* opt, crocksdb_ratelimiter_t* limiter) {
+  opt->rep.backup_rate_limiter = limiter->rep;
+}
+
+void crocksdb_backupable_db_options_set_restore_rate_limiter(
+    crocksdb_backupable_db_options_t* opt, crocksdb_ratelimiter_t* limiter) {
+  opt->rep.restore_rate_limiter = limiter->rep;
+}
+
+crocksdb_backup_engine_t* crocksdb_backup_engine_open_opt(
+    const crocksdb_options_t* options,
+    const crocksdb_backupable_db_options_t* backup_options, char** errptr) {
+  BackupEngine* be;
+  if (SaveError(errptr, BackupEngine::Open(options->rep.env,
+                                           backup_options->rep, &be))) {
+    return nullptr;
+  }
+  crocksdb_backup_engine_t* result = new crocksdb_backup_engine_t;
+  result->rep = be;
+  return result;
+}
+
 void crocksdb_backup_engine_create_new_backup(crocksdb_backup_engine_t* be,
                                               crocksdb_t* db, char** errptr) {
   SaveError(errptr, be->rep->CreateNewBackup(db->rep));
 }
 
+void crocksdb_backup_engine_create_new_backup_with_progress(
+    crocksdb_backup_engine_t* be, crocksdb_t* db,
+    unsigned char flush_before_backup, void* ctx, void (*progress)(void*),
+    char** errptr) {
+  std::function<void()> callback = []() {};
+  if (progress != nullptr) {
+    callback = [ctx, progress]() { progress(ctx); };
+  }
+  SaveError(errptr, be->rep->CreateNewBackup(db->rep, flush_before_backup,
+                                             callback));
+}
+
 void crocksdb_backup_engine_purge_old_backups(crocksdb_backup_engine_t* be,
                                               uint32_t num_backups_to_keep,
                                               char** errptr) {
@@ -828,6 +1012,17 @@ void crocksdb_backup_engine_close(crocksdb_backup_engine_t* be) {
   delete be;
 }
 
+void crocksdb_create_checkpoint(crocksdb_t* db, const char* checkpoint_dir,
+                                uint64_t log_size_for_flush, char** errptr) {
+  Checkpoint* checkpoint;
+  if (SaveError(errptr, Checkpoint::Create(db->rep, &checkpoint))) {
+    return;
+  }
+  SaveError(errptr, checkpoint->CreateCheckpoint(std::string(checkpoint_dir),
+                                                 log_size_for_flush));
+  delete checkpoint;
+}
+
 void crocksdb_close(crocksdb_t* db) {
   delete db->rep;
   delete db;
@@ -869,6 +1064,363 @@ crocksdb_t* crocksdb_open_column_families(
   return result;
 }
 
+struct crocksdb_open_profile_t {
+  enum Phase {
+    kManifestReplay = 0,
+    kTableOpening,
+    kWalRecovery,
+    kOptionsPersistence,
+    kNumPhases,
+  };
+
+  struct WalFile {
+    std::string name;
+    uint64_t bytes = 0;
+    uint64_t start_micros = 0;
+    uint64_t last_read_micros = 0;
+  };
+
+  uint64_t duration_micros[kNumPhases] = {};
+  uint64_t file_count[kNumPhases] = {};
+  uint64_t total_micros = 0;
+  // WALs in the order they were replayed.
+  std::vector<WalFile> wal_files;
+  // Entries recovered from the WALs, whether flushed during recovery or
+  // left in the memtables.
+  uint64_t wal_recovered_entries = 0;
+};
+
+// Counts the bytes replayed from a WAL and when the last ones were read.
+class ProfiledWalFile : public SequentialFile {
+ public:
+  ProfiledWalFile(std::unique_ptr<SequentialFile>&& file, Env* env,
+                  crocksdb_open_profile_t::WalFile* stats)
+      : file_(std::move(file)), env_(env), stats_(stats) {}
+
+  Status Read(size_t n, Slice* result, char* scratch) override {
+    Status s = file_->Read(n, result, scratch);
+    stats_->bytes += result->size();
+    stats_->last_read_micros = env_->NowMicros();
+    return s;
+  }
+  Status Skip(uint64_t n) override { return file_->Skip(n); }
+  bool use_direct_io() const override { return file_->use_direct_io(); }
+  size_t GetRequiredBufferAlignment() const override {
+    return file_->GetRequiredBufferAlignment();
+  }
+  Status InvalidateCache(size_t offset, size_t length) override {
+    return file_->InvalidateCache(offset, length);
+  }
+  Status PositionedRead(uint64_t offset, size_t n, Slice* result,
+                        char* scratch) override {
+    return file_->PositionedRead(offset, n, result, scratch);
+  }
+
+ private:
+  std::unique_ptr<SequentialFile> file_;
+  Env* env_;
+  crocksdb_open_profile_t::WalFile* stats_;
+};
+
+// Tells the phases of DB::Open apart by the files it touches. The MANIFEST
+// is replayed first, then the table files are opened, the WALs are replayed
+// and finally the OPTIONS file is written. A phase lasts until the next one
+// starts, so the time between them, e.g. parsing, is charged to the earlier.
+class OpenProfilingEnv : public rocksdb::EnvWrapper {
+  using Phase = crocksdb_open_profile_t::Phase;
+
+ public:
+  OpenProfilingEnv(Env* base, rocksdb::WalFilter* wal_filter)
+      : rocksdb::EnvWrapper(base),
+        start_micros_(base->NowMicros()),
+        recovery_counter_(wal_filter) {
+    for (auto& micros : phase_start_micros_) {
+      micros.store(0);
+    }
+    for (auto& count : file_count_) {
+      count.store(0);
+    }
+  }
+
+  Status NewSequentialFile(const std::string& fname,
+                           std::unique_ptr<SequentialFile>* result,
+                           const EnvOptions& options) override {
+    if (fname.find("MANIFEST-") != std::string::npos) {
+      Record(Phase::kManifestReplay);
+    } else if (EndsWith(fname, ".log") && recording_) {
+      Record(Phase::kWalRecovery);
+      Status s = rocksdb::EnvWrapper::NewSequentialFile(fname, result, options);
+      if (s.ok()) {
+        // WALs are replayed one at a time.
+        std::lock_guard<std::mutex> guard(wal_mutex_);
+        wal_files_.emplace_back();
+        auto stats = &wal_files_.back();
+        stats->name = fname.substr(fname.rfind('/') + 1);
+        stats->start_micros = stats->last_read_micros = target()->NowMicros();
+        result->reset(
+            new ProfiledWalFile(std::move(*result), target(), stats));
+      }
+      return s;
+    }
+    return rocksdb::EnvWrapper::NewSequentialFile(fname, result, options);
+  }
+
+  Status NewRandomAccessFile(const std::string& fname,
+                             std::unique_ptr<RandomAccessFile>* result,
+                             const EnvOptions& options) override {
+    // Tables flushed during WAL recovery are not part of table loading.
+    if (EndsWith(fname, ".sst") &&
+        phase_start_micros_[Phase::kWalRecovery].load() == 0) {
+      Record(Phase::kTableOpening);
+    }
+    return rocksdb::EnvWrapper::NewRandomAccessFile(fname, result, options);
+  }
+
+  Status NewWritableFile(const std::string& fname,
+                         std::unique_ptr<WritableFile>* result,
+                         const EnvOptions& options) override {
+    if (fname.find("OPTIONS-") != std::string::npos) {
+      Record(Phase::kOptionsPersistence);
+    }
+    return rocksdb::EnvWrapper::NewWritableFile(fname, result, options);
+  }
+
+  // Stops recording and fills `profile`.
+  void Finish(crocksdb_open_profile_t* profile) {
+    recording_ = false;
+    uint64_t end_micros = target()->NowMicros();
+    profile->total_micros = end_micros - start_micros_;
+    for (int i = 0; i < Phase::kNumPhases; i++) {
+      uint64_t start = phase_start_micros_[i].load();
+      profile->file_count[i] = file_count_[i].load();
+      if (start == 0) {
+        profile->duration_micros[i] = 0;
+        continue;
+      }
+      uint64_t end = end_micros;
+      for (int j = 0; j < Phase::kNumPhases; j++) {
+        uint64_t next = phase_start_micros_[j].load();
+        if (next > start && next < end) {
+          end = next;
+        }
+      }
+      profile->duration_micros[i] = end - start;
+    }
+    std::lock_guard<std::mutex> guard(wal_mutex_);
+    profile->wal_files.assign(wal_files_.begin(), wal_files_.end());
+    profile->wal_recovered_entries = recovery_counter_.entries();
+  }
+
+  // To be set as the `wal_filter` of the DB being opened.
+  rocksdb::WalFilter* recovery_counter() { return &recovery_counter_; }
+
+ private:
+  // Counts the entries replayed from the WALs as recovery reads them, so
+  // those flushed during recovery or by a background flush right after it
+  // are counted as well. Records go to the filter the DB was configured
+  // with, if any, first.
+  class RecoveryCounter : public rocksdb::WalFilter {
+   public:
+    explicit RecoveryCounter(rocksdb::WalFilter* base) : base_(base) {}
+
+    void ColumnFamilyLogNumberMap(
+        const std::map<uint32_t, uint64_t>& cf_lognumber_map,
+        const std::map<std::string, uint32_t>& cf_name_id_map) override {
+      cf_log_numbers_ = cf_lognumber_map;
+      if (base_ != nullptr) {
+        base_->ColumnFamilyLogNumberMap(cf_lognumber_map, cf_name_id_map);
+      }
+    }
+
+    WalProcessingOption LogRecordFound(unsigned long long log_number,
+                                       const std::string& log_file_name,
+                                       const WriteBatch& batch,
+                                       WriteBatch* new_batch,
+                                       bool* batch_changed) override {
+      WalProcessingOption option = WalProcessingOption::kContinueProcessing;
+      if (base_ != nullptr) {
+        option = base_->LogRecordFound(log_number, log_file_name, batch,
+                                       new_batch, batch_changed);
+      }
+      if (option == WalProcessingOption::kContinueProcessing) {
+        EntryCounter counter(cf_log_numbers_, log_number);
+        // A batch that fails to decode fails the recovery anyway.
+        const WriteBatch* replayed = *batch_changed ? new_batch : &batch;
+        replayed->Iterate(&counter);
+        entries_ += counter.entries();
+      }
+      return option;
+    }
+
+    const char* Name() const override { return "OpenProfilingRecoveryCounter"; }
+
+    // Recovery replays the WALs from a single thread before DB::Open
+    // returns.
+    uint64_t entries() const { return entries_; }
+
+   private:
+    // Counts the entries of a batch that recovery inserts, skipping those
+    // for dropped column families or ones already flushed past the WAL.
+    class EntryCounter : public WriteBatch::Handler {
+     public:
+      EntryCounter(const std::map<uint32_t, uint64_t>& cf_log_numbers,
+                   uint64_t log_number)
+          : cf_log_numbers_(cf_log_numbers), log_number_(log_number) {}
+
+      Status PutCF(uint32_t cf, const Slice&, const Slice&) override {
+        return Count(cf);
+      }
+      Status DeleteCF(uint32_t cf, const Slice&) override { return Count(cf); }
+      Status SingleDeleteCF(uint32_t cf, const Slice&) override {
+        return Count(cf);
+      }
+      Status DeleteRangeCF(uint32_t cf, const Slice&, const Slice&) override {
+        return Count(cf);
+      }
+      Status MergeCF(uint32_t cf, const Slice&, const Slice&) override {
+        return Count(cf);
+      }
+      Status PutBlobIndexCF(uint32_t cf, const Slice&, const Slice&) override {
+        return Count(cf);
+      }
+      Status MarkBeginPrepare(bool) override { return Status::OK(); }
+      Status MarkEndPrepare(const Slice&) override { return Status::OK(); }
+      Status MarkRollback(const Slice&) override { return Status::OK(); }
+      Status MarkCommit(const Slice&) override { return Status::OK(); }
+
+      uint64_t entries() const { return entries_; }
+
+     private:
+      Status Count(uint32_t cf) {
+        auto it = cf_log_numbers_.find(cf);
+        if (it != cf_log_numbers_.end() && log_number_ >= it->second) {
+          entries_++;
+        }
+        return Status::OK();
+      }
+
+      const std::map<uint32_t, uint64_t>& cf_log_numbers_;
+      const uint64_t log_number_;
+      uint64_t entries_ = 0;
+    };
+
+    rocksdb::WalFilter* const base_;
+    std::map<uint32_t, uint64_t> cf_log_numbers_;
+    uint64_t entries_ = 0;
+  };
+
+  static bool EndsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+  void Record(Phase phase) {
+    if (!recording_) {
+      return;
+    }
+    file_count_[phase].fetch_add(1);
+    uint64_t expected = 0;
+    phase_start_micros_[phase].compare_exchange_strong(
+        expected, std::max<uint64_t>(target()->NowMicros(), 1));
+  }
+
+  const uint64_t start_micros_;
+  std::atomic<bool> recording_{true};
+  std::atomic<uint64_t> phase_start_micros_[Phase::kNumPhases];
+  std::atomic<uint64_t> file_count_[Phase::kNumPhases];
+  std::mutex wal_mutex_;
+  // A deque keeps the stats in place for the files pointing to them.
+  std::deque<crocksdb_open_profile_t::WalFile> wal_files_;
+  RecoveryCounter recovery_counter_;
+};
+
+crocksdb_t* crocksdb_open_column_families_with_profile(
+    const crocksdb_options_t* db_options, const char* name,
+    int num_column_families, const char** column_family_names,
+    const crocksdb_options_t** column_family_options,
+    crocksdb_column_family_handle_t** column_family_handles,
+    crocksdb_open_profile_t* profile, char** errptr) {
+  std::vector<ColumnFamilyDescriptor> column_families;
+  for (int i = 0; i < num_column_families; i++) {
+    column_families.push_back(ColumnFamilyDescriptor(
+        std::string(column_family_names[i]),
+        ColumnFamilyOptions(column_family_options[i]->rep)));
+  }
+
+  DBOptions options(db_options->rep);
+  std::unique_ptr<OpenProfilingEnv> env(
+      new OpenProfilingEnv(options.env, options.wal_filter));
+  options.env = env.get();
+  options.wal_filter = env->recovery_counter();
+  DB* db;
+  std::vector<ColumnFamilyHandle*> handles;
+  Status s = DB::Open(options, std::string(name), column_families, &handles,
+                      &db);
+  env->Finish(profile);
+  if (SaveError(errptr, s)) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < handles.size(); i++) {
+    crocksdb_column_family_handle_t* c_handle =
+        new crocksdb_column_family_handle_t;
+    c_handle->rep = handles[i];
+    column_family_handles[i] = c_handle;
+  }
+  crocksdb_t* result = new crocksdb_t;
+  result->rep = db;
+  result->profiling_env = std::move(env);
+  return result;
+}
+
+crocksdb_open_profile_t* crocksdb_open_profile_create() {
+  return new crocksdb_open_profile_t;
+}
+
+void crocksdb_open_profile_destroy(crocksdb_open_profile_t* profile) {
+  delete profile;
+}
+
+uint64_t crocksdb_open_profile_duration_micros(
+    const crocksdb_open_profile_t* profile, int phase) {
+  return profile->duration_micros[phase];
+}
+
+uint64_t crocksdb_open_profile_file_count(
+    const crocksdb_open_profile_t* profile, int phase) {
+  return profile->file_count[phase];
+}
+
+uint64_t crocksdb_open_profile_total_micros(
+    const crocksdb_open_profile_t* profile) {
+  return profile->total_micros;
+}
+
+uint64_t crocksdb_open_profile_wal_recovered_entries(
+    const crocksdb_open_profile_t* profile) {
+  return profile->wal_recovered_entries;
+}
+
+size_t crocksdb_open_profile_wal_file_count(
+    const crocksdb_open_profile_t* profile) {
+  return profile->wal_files.size();
+}
+
+const char* crocksdb_open_profile_wal_file_name(
+    const crocksdb_open_profile_t* profile, size_t index) {
+  return profile->wal_files[index].name.c_str();
+}
+
+uint64_t crocksdb_open_profile_wal_file_bytes(
+    const crocksdb_open_profile_t* profile, size_t index) {
+  return profile->wal_files[index].bytes;
+}
+
+uint64_t crocksdb_open_profile_wal_file_micros(
+    const crocksdb_open_profile_t* profile, size_t index) {
+  auto& file = profile->wal_files[index];
+  return file.last_read_micros - file.start_micros;
+}
+
 crocksdb_t* crocksdb_open_column_families_with_ttl(
     const crocksdb_options_t* db_options, const char* name,
     int num_column_families, const char** column_family_names,
@@ -936,6 +1488,39 @@ crocksdb_t* crocksdb_open_for_read_only_column_families(
   return result;
 }
 
+crocksdb_t* crocksdb_open_as_secondary_column_families(
+    const crocksdb_options_t* db_options, const char* name,
+    const char* secondary_path, int num_column_families,
+    const char** column_family_names,
+    const crocksdb_options_t** column_family_options,
+    crocksdb_column_family_handle_t** column_family_handles, char** errptr) {
+  std::vector<ColumnFamilyDescriptor> column_families;
+  for (int i = 0; i < num_column_families; i++) {
+    column_families.push_back(ColumnFamilyDescriptor(
+        std::string(column_family_names[i]),
+        ColumnFamilyOptions(column_family_options[i]->rep)));
+  }
+
+  DB* db;
+  std::vector<ColumnFamilyHandle*> handles;
+  if (SaveError(errptr, DB::OpenAsSecondary(DBOptions(db_options->rep),
+                                            std::string(name),
+                                            std::string(secondary_path),
+                                            column_families, &handles, &db))) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < handles.size(); i++) {
+    crocksdb_column_family_handle_t* c_handle =
+        new crocksdb_column_family_handle_t;
+    c_handle->rep = handles[i];
+    column_family_handles[i] = c_handle;
+  }
+  crocksdb_t* result = new crocksdb_t;
+  result->rep = db;
+  return result;
+}
+
 char** crocksdb_list_column_families(const crocksdb_options_t* options,
                                      const char* name, size_t* lencfs,
                                      char** errptr) {
@@ -1430,6 +2015,74 @@ void crocksdb_enable_file_deletions(crocksdb_t* db, unsigned char force,
   SaveError(errptr, db->rep->EnableFileDeletions(force));
 }
 
+// Lists the live files added and removed since `since`, or all of them if it
+// is null. File deletions stay disabled until the added files are released,
+// unless there are none. A file moved to another level is reported as both
+// removed and added.
+crocksdb_livefiles_diff_t* crocksdb_livefiles_diff(
+    crocksdb_t* db, const crocksdb_livefiles_diff_t* since, char** errptr) {
+  if (SaveError(errptr, db->rep->DisableFileDeletions())) {
+    return nullptr;
+  }
+  auto diff = new crocksdb_livefiles_diff_t;
+  diff->db = db->rep;
+  diff->holding_files = true;
+  db->rep->GetLiveFilesMetaData(&diff->files);
+  auto by_name = [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+    return a.name < b.name;
+  };
+  std::sort(diff->files.begin(), diff->files.end(), by_name);
+  if (since == nullptr) {
+    diff->added.rep = diff->files;
+  } else {
+    auto& prev = since->files;
+    auto it = diff->files.begin();
+    auto prev_it = prev.begin();
+    while (it != diff->files.end() || prev_it != prev.end()) {
+      if (prev_it == prev.end() ||
+          (it != diff->files.end() && it->name < prev_it->name)) {
+        diff->added.rep.push_back(*it++);
+      } else if (it == diff->files.end() || prev_it->name < it->name) {
+        diff->removed.rep.push_back(*prev_it++);
+      } else {
+        if (it->level != prev_it->level) {
+          diff->added.rep.push_back(*it);
+          diff->removed.rep.push_back(*prev_it);
+        }
+        ++it;
+        ++prev_it;
+      }
+    }
+  }
+  if (diff->added.rep.empty()) {
+    crocksdb_livefiles_diff_release_files(diff);
+  }
+  return diff;
+}
+
+const crocksdb_livefiles_t* crocksdb_livefiles_diff_added(
+    const crocksdb_livefiles_diff_t* diff) {
+  return &diff->added;
+}
+
+const crocksdb_livefiles_t* crocksdb_livefiles_diff_removed(
+    const crocksdb_livefiles_diff_t* diff) {
+  return &diff->removed;
+}
+
+// Lets the DB delete obsolete files again, once the added files are copied.
+void crocksdb_livefiles_diff_release_files(crocksdb_livefiles_diff_t* diff) {
+  if (diff->holding_files) {
+    diff->db->EnableFileDeletions(false /* force */);
+    diff->holding_files = false;
+  }
+}
+
+void crocksdb_livefiles_diff_destroy(crocksdb_livefiles_diff_t* diff) {
+  crocksdb_livefiles_diff_release_files(diff);
+  delete diff;
+}
+
 crocksdb_options_t* crocksdb_get_db_options(crocksdb_t* db) {
   auto opts = new crocksdb_options_t;
   opts->rep = Options(db->rep->GetDBOptions(), ColumnFamilyOptions());
@@ -1940,6 +2593,12 @@ void crocksdb_block_based_options_set_block_cache(
     crocksdb_cache_t* block_cache) {
   if (block_cache) {
     options->rep.block_cache = block_cache->rep;
+    if (block_cache->compressed_secondary) {
+      options->rep.block_cache_compressed = block_cache->compressed_secondary;
+    }
+    if (block_cache->persistent_cache) {
+      options->rep.persistent_cache = block_cache->persistent_cache;
+    }
   }
 }
 
@@ -1966,6 +2625,11 @@ void crocksdb_block_based_options_set_index_type(
   options->rep.index_type = static_cast<BlockBasedTableOptions::IndexType>(v);
 }
 
+void crocksdb_block_based_options_set_checksum(
+    crocksdb_block_based_table_options_t* options, int v) {
+  options->rep.checksum = static_cast<rocksdb::ChecksumType>(v);
+}
+
 void crocksdb_block_based_options_set_hash_index_allow_collision(
     crocksdb_block_based_table_options_t* options, unsigned char v) {
   options->rep.hash_index_allow_collision = v;
@@ -2432,7 +3096,8 @@ void crocksdb_options_set_cuckoo_table_factory(
 crocksdb_options_t* crocksdb_options_create() { return new crocksdb_options_t; }
 
 crocksdb_options_t* crocksdb_options_copy(const crocksdb_options_t* other) {
-  return new crocksdb_options_t{Options(other->rep)};
+  return new crocksdb_options_t{Options(other->rep),
+                                other->priority_rate_limiter};
 }
 
 void crocksdb_options_destroy(crocksdb_options_t* options) { delete options; }
@@ -2551,6 +3216,11 @@ void crocksdb_options_set_db_write_buffer_size(crocksdb_options_t* opt,
   opt->rep.db_write_buffer_size = s;
 }
 
+void crocksdb_options_set_write_buffer_manager(
+    crocksdb_options_t* opt, crocksdb_write_buffer_manager_t* manager) {
+  opt->rep.write_buffer_manager = manager->rep;
+}
+
 void crocksdb_options_set_write_buffer_size(crocksdb_options_t* opt, size_t s) {
   opt->rep.write_buffer_size = s;
 }
@@ -2563,6 +3233,35 @@ void crocksdb_options_set_max_open_files(crocksdb_options_t* opt, int n) {
   opt->rep.max_open_files = n;
 }
 
+void crocksdb_options_set_max_file_opening_threads(crocksdb_options_t* opt,
+                                                   int n) {
+  opt->rep.max_file_opening_threads = n;
+}
+
+int crocksdb_options_get_max_file_opening_threads(crocksdb_options_t* opt) {
+  return opt->rep.max_file_opening_threads;
+}
+
+void crocksdb_options_set_skip_stats_update_on_db_open(crocksdb_options_t* opt,
+                                                       unsigned char v) {
+  opt->rep.skip_stats_update_on_db_open = v;
+}
+
+unsigned char crocksdb_options_get_skip_stats_update_on_db_open(
+    crocksdb_options_t* opt) {
+  return opt->rep.skip_stats_update_on_db_open;
+}
+
+void crocksdb_options_set_skip_checking_sst_file_sizes_on_db_open(
+    crocksdb_options_t* opt, unsigned char v) {
+  opt->rep.skip_checking_sst_file_sizes_on_db_open = v;
+}
+
+unsigned char crocksdb_options_get_skip_checking_sst_file_sizes_on_db_open(
+    crocksdb_options_t* opt) {
+  return opt->rep.skip_checking_sst_file_sizes_on_db_open;
+}
+
 void crocksdb_options_set_max_total_wal_size(crocksdb_options_t* opt,
                                              uint64_t n) {
   opt->rep.max_total_wal_size = n;
@@ -2846,6 +3545,26 @@ void crocksdb_options_set_is_fd_close_on_exec(crocksdb_options_t* opt,
   opt->rep.is_fd_close_on_exec = v;
 }
 
+void crocksdb_options_set_avoid_flush_during_recovery(crocksdb_options_t* opt,
+                                                      unsigned char v) {
+  opt->rep.avoid_flush_during_recovery = v;
+}
+
+unsigned char crocksdb_options_get_avoid_flush_during_recovery(
+    crocksdb_options_t* opt) {
+  return opt->rep.avoid_flush_during_recovery;
+}
+
+void crocksdb_options_set_avoid_flush_during_shutdown(crocksdb_options_t* opt,
+                                                      unsigned char v) {
+  opt->rep.avoid_flush_during_shutdown = v;
+}
+
+unsigned char crocksdb_options_get_avoid_flush_during_shutdown(
+    crocksdb_options_t* opt) {
+  return opt->rep.avoid_flush_during_shutdown;
+}
+
 void crocksdb_options_set_skip_log_error_on_recovery(crocksdb_options_t* opt,
                                                      unsigned char v) {
   opt->rep.skip_log_error_on_recovery = v;
@@ -3242,14 +3961,30 @@ unsigned char crocksdb_options_statistics_get_histogram(
 void crocksdb_options_set_ratelimiter(crocksdb_options_t* opt,
                                       crocksdb_ratelimiter_t* limiter) {
   opt->rep.rate_limiter = limiter->rep;
+  opt->priority_rate_limiter = limiter->priority;
   limiter->rep = nullptr;
 }
 
+void crocksdb_options_set_shared_ratelimiter(crocksdb_options_t* opt,
+                                             crocksdb_ratelimiter_t* limiter) {
+  opt->rep.rate_limiter = limiter->rep;
+  opt->priority_rate_limiter = limiter->priority;
+}
+
+static bool IsPriorityRateLimiter(
+    const std::shared_ptr<RateLimiter>& limiter,
+    const std::shared_ptr<PriorityRateLimiter>& priority);
+
 crocksdb_ratelimiter_t* crocksdb_options_get_ratelimiter(
     crocksdb_options_t* opt) {
   if (opt->rep.rate_limiter != nullptr) {
     crocksdb_ratelimiter_t* limiter = new crocksdb_ratelimiter_t;
     limiter->rep = opt->rep.rate_limiter;
+    // `rep` may have been replaced as a whole since, e.g. by options taken
+    // from a DB, which don't tell which limiter it is.
+    if (IsPriorityRateLimiter(limiter->rep, opt->priority_rate_limiter)) {
+      limiter->priority = opt->priority_rate_limiter;
+    }
     return limiter;
   }
   return nullptr;
@@ -3265,11 +4000,21 @@ void crocksdb_options_set_atomic_flush(crocksdb_options_t* opt,
   opt->rep.atomic_flush = enable;
 }
 
-unsigned char crocksdb_load_latest_options(
-    const char* dbpath, crocksdb_env_t* env, crocksdb_options_t* db_options,
-    crocksdb_column_family_descriptor*** cf_descs, size_t* cf_descs_len,
-    unsigned char ignore_unknown_options, char** errptr) {
-  std::vector<ColumnFamilyDescriptor> tmp_cf_descs;
+void crocksdb_options_set_allow_ingest_behind(crocksdb_options_t* opt,
+                                              unsigned char v) {
+  opt->rep.allow_ingest_behind = v;
+}
+
+unsigned char crocksdb_options_get_allow_ingest_behind(
+    crocksdb_options_t* opt) {
+  return opt->rep.allow_ingest_behind;
+}
+
+unsigned char crocksdb_load_latest_options(
+    const char* dbpath, crocksdb_env_t* env, crocksdb_options_t* db_options,
+    crocksdb_column_family_descriptor*** cf_descs, size_t* cf_descs_len,
+    unsigned char ignore_unknown_options, char** errptr) {
+  std::vector<ColumnFamilyDescriptor> tmp_cf_descs;
   Status s = rocksdb::LoadLatestOptions(dbpath, env->rep, &db_options->rep,
                                         &tmp_cf_descs, ignore_unknown_options);
 
@@ -3288,6 +4033,236 @@ unsigned char crocksdb_load_latest_options(
   return true;
 }
 
+static RateLimiter::Mode ToRateLimiterMode(crocksdb_ratelimiter_mode_t mode) {
+  switch (mode) {
+    case kReadsOnly:
+      return RateLimiter::Mode::kReadsOnly;
+    case kAllIo:
+      return RateLimiter::Mode::kAllIo;
+    default:
+      return RateLimiter::Mode::kWritesOnly;
+  }
+}
+
+// A rate limiter with four priorities. High priority requests, i.e. flushes,
+// are always served first. The rest of the budget is shared between user,
+// mid and low priority requests by weighted fair queuing, so a busy class
+// can't starve the others. Bytes, requests and time spent waiting are
+// accounted per priority.
+class PriorityRateLimiter : public RateLimiter {
+ public:
+  enum Priority { kLow = 0, kHigh = 1, kMid = 2, kUser = 3, kNumPriorities };
+
+  PriorityRateLimiter(int64_t rate_bytes_per_sec, int64_t refill_period_us,
+                      const int32_t weights[kNumPriorities], Mode mode)
+      : RateLimiter(mode),
+        env_(Env::Default()),
+        refill_period_us_(refill_period_us),
+        rate_bytes_per_sec_(rate_bytes_per_sec),
+        refill_bytes_per_period_(
+            CalculateRefillBytesPerPeriod(rate_bytes_per_sec)),
+        available_bytes_(0),
+        next_refill_us_(env_->NowMicros()),
+        virtual_time_(0) {
+    for (int i = 0; i < kNumPriorities; i++) {
+      weights_[i] = std::max(weights[i], 1);
+      virtual_times_[i] = 0;
+      total_bytes_[i] = 0;
+      total_requests_[i] = 0;
+      total_wait_micros_[i] = 0;
+    }
+  }
+
+  void SetBytesPerSecond(int64_t bytes_per_second) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    rate_bytes_per_sec_ = bytes_per_second;
+    refill_bytes_per_period_ = CalculateRefillBytesPerPeriod(bytes_per_second);
+  }
+
+  int64_t GetSingleBurstBytes() const override {
+    return refill_bytes_per_period_.load(std::memory_order_relaxed);
+  }
+
+  int64_t GetBytesPerSecond() const override {
+    return rate_bytes_per_sec_.load(std::memory_order_relaxed);
+  }
+
+  void Request(const int64_t bytes, const Env::IOPriority pri,
+               rocksdb::Statistics* stats) override {
+    RequestWithPriority(bytes, pri == Env::IO_HIGH ? kHigh : kLow, stats);
+  }
+
+  void RequestWithPriority(int64_t bytes, Priority pri,
+                           rocksdb::Statistics* stats = nullptr) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bytes = std::min(bytes, refill_bytes_per_period_.load());
+    total_bytes_[pri] += bytes;
+    total_requests_[pri]++;
+    uint64_t now = env_->NowMicros();
+    if (now >= next_refill_us_) {
+      Refill(now);
+    }
+    if (queued_ == 0 && available_bytes_ >= bytes) {
+      available_bytes_ -= bytes;
+      return;
+    }
+
+    if (stats != nullptr) {
+      stats->recordTick(rocksdb::NUMBER_RATE_LIMITER_DRAINS, 1);
+    }
+    Req req(bytes, now);
+    if (queues_[pri].empty()) {
+      // A class that was idle doesn't get credit for the time it was idle.
+      virtual_times_[pri] = std::max(virtual_times_[pri], virtual_time_);
+    }
+    queues_[pri].push_back(&req);
+    queued_++;
+    Grant();
+    while (!req.granted) {
+      req.cv.wait_for(lock,
+                      std::chrono::microseconds(next_refill_us_ - now));
+      now = env_->NowMicros();
+      if (now >= next_refill_us_) {
+        Refill(now);
+        Grant();
+      }
+    }
+    total_wait_micros_[pri] += now - req.start_us;
+  }
+
+  int64_t GetTotalBytesThrough(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return Sum(total_bytes_, pri);
+  }
+
+  int64_t GetTotalRequests(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return Sum(total_requests_, pri);
+  }
+
+  int64_t GetBytesThrough(Priority pri) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return total_bytes_[pri];
+  }
+
+  int64_t GetRequests(Priority pri) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return total_requests_[pri];
+  }
+
+  uint64_t GetWaitMicros(Priority pri) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return total_wait_micros_[pri];
+  }
+
+ private:
+  struct Req {
+    Req(int64_t bytes, uint64_t now) : remaining(bytes), start_us(now) {}
+    int64_t remaining;
+    uint64_t start_us;
+    bool granted = false;
+    std::condition_variable cv;
+  };
+
+  int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec) const {
+    return std::max<int64_t>(rate_bytes_per_sec * refill_period_us_ / 1000000,
+                             1);
+  }
+
+  template <typename T>
+  static T Sum(const T (&totals)[kNumPriorities], Env::IOPriority pri) {
+    if (pri == Env::IO_HIGH) {
+      return totals[kHigh];
+    } else if (pri == Env::IO_LOW) {
+      return totals[kLow];
+    }
+    T sum = 0;
+    for (int i = 0; i < kNumPriorities; i++) {
+      sum += totals[i];
+    }
+    return sum;
+  }
+
+  void Refill(uint64_t now) {
+    available_bytes_ = refill_bytes_per_period_;
+    next_refill_us_ = now + refill_period_us_;
+  }
+
+  // Hands out the available bytes to queued requests. High priority goes
+  // first, then the class with the lowest virtual time, which advances by
+  // the bytes served divided by the weight of the class.
+  void Grant() {
+    while (available_bytes_ > 0 && queued_ > 0) {
+      int pri = kHigh;
+      if (queues_[kHigh].empty()) {
+        pri = -1;
+        for (int i : {kUser, kMid, kLow}) {
+          if (!queues_[i].empty() &&
+              (pri < 0 || virtual_times_[i] < virtual_times_[pri])) {
+            pri = i;
+          }
+        }
+      }
+      Req* req = queues_[pri].front();
+      int64_t granted = std::min(available_bytes_, req->remaining);
+      available_bytes_ -= granted;
+      req->remaining -= granted;
+      if (pri != kHigh) {
+        virtual_time_ = virtual_times_[pri];
+        virtual_times_[pri] += static_cast<double>(granted) / weights_[pri];
+      }
+      if (req->remaining == 0) {
+        queues_[pri].pop_front();
+        queued_--;
+        req->granted = true;
+        req->cv.notify_one();
+      }
+    }
+  }
+
+  Env* const env_;
+  const int64_t refill_period_us_;
+  std::atomic<int64_t> rate_bytes_per_sec_;
+  std::atomic<int64_t> refill_bytes_per_period_;
+
+  mutable std::mutex mutex_;
+  int64_t available_bytes_;
+  uint64_t next_refill_us_;
+  size_t queued_ = 0;
+  std::deque<Req*> queues_[kNumPriorities];
+  int32_t weights_[kNumPriorities];
+  double virtual_times_[kNumPriorities];
+  double virtual_time_;
+  int64_t total_bytes_[kNumPriorities];
+  int64_t total_requests_[kNumPriorities];
+  uint64_t total_wait_micros_[kNumPriorities];
+};
+
+// Whether `limiter` is `priority`. Without RTTI a PriorityRateLimiter can't
+// be recognized from a RateLimiter, so the wrappers keep track of it.
+static bool IsPriorityRateLimiter(
+    const std::shared_ptr<RateLimiter>& limiter,
+    const std::shared_ptr<PriorityRateLimiter>& priority) {
+  return priority != nullptr && limiter.get() == priority.get();
+}
+
+// Maps the priorities of crocksdb_ratelimiter_request to the classes of
+// PriorityRateLimiter.
+static PriorityRateLimiter::Priority ToPriority(unsigned char pri) {
+  switch (pri) {
+    case env_io_priority_high:
+      return PriorityRateLimiter::kHigh;
+    case env_io_priority_mid:
+      return PriorityRateLimiter::kMid;
+    case env_io_priority_user:
+      return PriorityRateLimiter::kUser;
+    default:
+      return PriorityRateLimiter::kLow;
+  }
+}
+
 crocksdb_ratelimiter_t* crocksdb_ratelimiter_create(int64_t rate_bytes_per_sec,
                                                     int64_t refill_period_us,
                                                     int32_t fairness) {
@@ -3340,6 +4315,21 @@ crocksdb_writeampbasedratelimiter_create_with_auto_tuned(
   return rate_limiter;
 }
 
+crocksdb_ratelimiter_t* crocksdb_priority_ratelimiter_create(
+    int64_t rate_bytes_per_sec, int64_t refill_period_us, int32_t user_weight,
+    int32_t mid_weight, int32_t low_weight, crocksdb_ratelimiter_mode_t mode) {
+  int32_t weights[PriorityRateLimiter::kNumPriorities];
+  weights[PriorityRateLimiter::kLow] = low_weight;
+  weights[PriorityRateLimiter::kHigh] = 1;
+  weights[PriorityRateLimiter::kMid] = mid_weight;
+  weights[PriorityRateLimiter::kUser] = user_weight;
+  crocksdb_ratelimiter_t* rate_limiter = new crocksdb_ratelimiter_t;
+  rate_limiter->priority = std::make_shared<PriorityRateLimiter>(
+      rate_bytes_per_sec, refill_period_us, weights, ToRateLimiterMode(mode));
+  rate_limiter->rep = rate_limiter->priority;
+  return rate_limiter;
+}
+
 void crocksdb_ratelimiter_destroy(crocksdb_ratelimiter_t* limiter) {
   if (limiter->rep) {
     limiter->rep.reset();
@@ -3364,11 +4354,30 @@ int64_t crocksdb_ratelimiter_get_singleburst_bytes(
 
 void crocksdb_ratelimiter_request(crocksdb_ratelimiter_t* limiter,
                                   int64_t bytes, unsigned char pri) {
-  limiter->rep->Request(bytes, static_cast<Env::IOPriority>(pri), nullptr);
+  if (limiter->priority) {
+    limiter->priority->RequestWithPriority(bytes, ToPriority(pri));
+    return;
+  }
+  Env::IOPriority io_pri = static_cast<Env::IOPriority>(pri);
+  if (pri == env_io_priority_mid) {
+    io_pri = Env::IO_LOW;
+  } else if (pri == env_io_priority_user) {
+    io_pri = Env::IO_HIGH;
+  }
+  limiter->rep->Request(bytes, io_pri, nullptr);
 }
 
 int64_t crocksdb_ratelimiter_get_total_bytes_through(
     crocksdb_ratelimiter_t* limiter, unsigned char pri) {
+  if (pri > env_io_priority_total) {
+    return limiter->priority
+               ? limiter->priority->GetBytesThrough(ToPriority(pri))
+               : 0;
+  }
+  if (limiter->priority) {
+    return limiter->priority->GetTotalBytesThrough(
+        static_cast<Env::IOPriority>(pri));
+  }
   return limiter->rep->GetTotalBytesThrough(static_cast<Env::IOPriority>(pri));
 }
 
@@ -3384,9 +4393,33 @@ unsigned char crocksdb_ratelimiter_get_auto_tuned(
 
 int64_t crocksdb_ratelimiter_get_total_requests(crocksdb_ratelimiter_t* limiter,
                                                 unsigned char pri) {
+  if (pri > env_io_priority_total) {
+    return limiter->priority ? limiter->priority->GetRequests(ToPriority(pri))
+                             : 0;
+  }
+  if (limiter->priority) {
+    return limiter->priority->GetTotalRequests(
+        static_cast<Env::IOPriority>(pri));
+  }
   return limiter->rep->GetTotalRequests(static_cast<Env::IOPriority>(pri));
 }
 
+uint64_t crocksdb_ratelimiter_get_total_wait_micros(
+    crocksdb_ratelimiter_t* limiter, unsigned char pri) {
+  if (!limiter->priority) {
+    return 0;
+  }
+  if (pri == env_io_priority_total) {
+    uint64_t sum = 0;
+    for (int i = 0; i < PriorityRateLimiter::kNumPriorities; i++) {
+      sum += limiter->priority->GetWaitMicros(
+          static_cast<PriorityRateLimiter::Priority>(i));
+    }
+    return sum;
+  }
+  return limiter->priority->GetWaitMicros(ToPriority(pri));
+}
+
 /*
 TODO:
 DB::OpenForReadOnly
@@ -3847,9 +4880,36 @@ void crocksdb_lru_cache_options_set_memory_allocator(
   opt->rep.memory_allocator = allocator->rep;
 }
 
+void crocksdb_lru_cache_options_set_compressed_secondary_capacity(
+    crocksdb_lru_cache_options_t* opt, size_t capacity) {
+  opt->compressed_secondary_capacity = capacity;
+}
+
+void crocksdb_lru_cache_options_set_compressed_secondary_num_shard_bits(
+    crocksdb_lru_cache_options_t* opt, int num_shard_bits) {
+  opt->compressed_secondary_num_shard_bits = num_shard_bits;
+}
+
+void crocksdb_lru_cache_options_set_persistent_cache(
+    crocksdb_lru_cache_options_t* opt, crocksdb_persistent_cache_t* cache) {
+  opt->persistent_cache = cache->rep;
+}
+
 crocksdb_cache_t* crocksdb_cache_create_lru(crocksdb_lru_cache_options_t* opt) {
   crocksdb_cache_t* c = new crocksdb_cache_t;
   c->rep = NewLRUCache(opt->rep);
+  c->persistent_cache = opt->persistent_cache;
+  if (opt->compressed_secondary_capacity > 0) {
+    // Compressed blocks are never pinned by readers, so the tier needs
+    // neither a strict limit nor a high-priority pool. It gets its own shards
+    // to keep its lock traffic off the primary cache.
+    LRUCacheOptions secondary_opts(
+        opt->compressed_secondary_capacity,
+        opt->compressed_secondary_num_shard_bits,
+        false /* strict_capacity_limit */, 0.0 /* high_pri_pool_ratio */,
+        opt->rep.memory_allocator);
+    c->compressed_secondary = NewLRUCache(secondary_opts);
+  }
   return c;
 }
 
@@ -3859,6 +4919,83 @@ void crocksdb_cache_set_capacity(crocksdb_cache_t* cache, size_t capacity) {
   cache->rep->SetCapacity(capacity);
 }
 
+size_t crocksdb_cache_get_usage(crocksdb_cache_t* cache) {
+  return cache->rep->GetUsage();
+}
+
+size_t crocksdb_cache_get_compressed_secondary_usage(crocksdb_cache_t* cache) {
+  if (cache->compressed_secondary) {
+    return cache->compressed_secondary->GetUsage();
+  }
+  return 0;
+}
+
+size_t crocksdb_cache_get_compressed_secondary_capacity(
+    crocksdb_cache_t* cache) {
+  if (cache->compressed_secondary) {
+    return cache->compressed_secondary->GetCapacity();
+  }
+  return 0;
+}
+
+crocksdb_write_buffer_manager_t* crocksdb_write_buffer_manager_create(
+    size_t buffer_size, crocksdb_cache_t* cache) {
+  crocksdb_write_buffer_manager_t* manager =
+      new crocksdb_write_buffer_manager_t;
+  manager->rep = std::make_shared<WriteBufferManager>(
+      buffer_size, cache != nullptr ? cache->rep : nullptr);
+  return manager;
+}
+
+void crocksdb_write_buffer_manager_destroy(
+    crocksdb_write_buffer_manager_t* manager) {
+  delete manager;
+}
+
+size_t crocksdb_write_buffer_manager_buffer_size(
+    crocksdb_write_buffer_manager_t* manager) {
+  return manager->rep->buffer_size();
+}
+
+size_t crocksdb_write_buffer_manager_memory_usage(
+    crocksdb_write_buffer_manager_t* manager) {
+  return manager->rep->memory_usage();
+}
+
+size_t crocksdb_write_buffer_manager_mutable_memtable_memory_usage(
+    crocksdb_write_buffer_manager_t* manager) {
+  return manager->rep->mutable_memtable_memory_usage();
+}
+
+unsigned char crocksdb_write_buffer_manager_cost_to_cache(
+    crocksdb_write_buffer_manager_t* manager) {
+  return manager->rep->cost_to_cache();
+}
+
+unsigned char crocksdb_write_buffer_manager_should_flush(
+    crocksdb_write_buffer_manager_t* manager) {
+  return manager->rep->ShouldFlush();
+}
+
+crocksdb_persistent_cache_t* crocksdb_persistent_cache_create(
+    const char* path, uint64_t size, unsigned char optimized_for_nvm,
+    char** errptr) {
+  shared_ptr<PersistentCache> cache;
+  Status s = rocksdb::NewPersistentCache(Env::Default(), std::string(path),
+                                         size, nullptr /* log */,
+                                         optimized_for_nvm, &cache);
+  if (SaveError(errptr, s)) {
+    return nullptr;
+  }
+  crocksdb_persistent_cache_t* result = new crocksdb_persistent_cache_t;
+  result->rep = cache;
+  return result;
+}
+
+void crocksdb_persistent_cache_destroy(crocksdb_persistent_cache_t* cache) {
+  delete cache;
+}
+
 crocksdb_env_t* crocksdb_default_env_create() {
   crocksdb_env_t* result = new crocksdb_env_t;
   result->rep = Env::Default();
@@ -3887,7 +5024,16 @@ struct CTRBlockCipher : public BlockCipher {
 
   virtual Status Encrypt(char* data) {
     const char* ciper_ptr = cipertext_.c_str();
-    for (size_t i = 0; i < block_size_; i++) {
+    size_t i = 0;
+    // XOR a word at a time, the block size is a power of 2.
+    for (; i + sizeof(uint64_t) <= block_size_; i += sizeof(uint64_t)) {
+      uint64_t d, c;
+      memcpy(&d, data + i, sizeof(d));
+      memcpy(&c, ciper_ptr + i, sizeof(c));
+      d ^= c;
+      memcpy(data + i, &d, sizeof(d));
+    }
+    for (; i < block_size_; i++) {
       data[i] = data[i] ^ ciper_ptr[i];
     }
 
@@ -4085,10 +5231,54 @@ struct crocksdb_encryption_key_manager_impl_t : public KeyManager {
   crocksdb_encryption_key_manager_delete_file_cb delete_file;
   crocksdb_encryption_key_manager_link_file_cb link_file;
 
+  // Optional cache of file info, sharded by file name. A shard's generation
+  // is bumped on every invalidation so that a GetFile miss racing with a
+  // NewFile/DeleteFile/LinkFile of the same shard never caches stale info.
+  struct FileInfoCacheShard {
+    rocksdb::port::RWMutex mutex;
+    std::unordered_map<std::string, FileEncryptionInfo> files;
+    uint64_t generation = 0;
+  };
+  std::unique_ptr<FileInfoCacheShard[]> cache_shards;
+  size_t cache_shard_mask = 0;
+
   virtual ~crocksdb_encryption_key_manager_impl_t() { destructor(state); }
 
+  void EnableCache(int num_shard_bits) {
+    size_t num_shards = size_t{1} << num_shard_bits;
+    cache_shards.reset(new FileInfoCacheShard[num_shards]);
+    cache_shard_mask = num_shards - 1;
+  }
+
+  FileInfoCacheShard* GetCacheShard(const std::string& fname) {
+    if (!cache_shards) {
+      return nullptr;
+    }
+    return &cache_shards[std::hash<std::string>()(fname) & cache_shard_mask];
+  }
+
+  void InvalidateCache(const std::string& fname) {
+    FileInfoCacheShard* shard = GetCacheShard(fname);
+    if (shard != nullptr) {
+      WriteLock l(&shard->mutex);
+      shard->files.erase(fname);
+      shard->generation++;
+    }
+  }
+
   Status GetFile(const std::string& fname,
                  FileEncryptionInfo* file_info) override {
+    FileInfoCacheShard* shard = GetCacheShard(fname);
+    uint64_t generation = 0;
+    if (shard != nullptr) {
+      ReadLock l(&shard->mutex);
+      auto it = shard->files.find(fname);
+      if (it != shard->files.end()) {
+        *file_info = it->second;
+        return Status::OK();
+      }
+      generation = shard->generation;
+    }
     crocksdb_file_encryption_info_t info;
     info.rep = file_info;
     const char* ret = get_file(state, fname.c_str(), &info);
@@ -4096,6 +5286,11 @@ struct crocksdb_encryption_key_manager_impl_t : public KeyManager {
     if (ret != nullptr) {
       s = Status::Corruption(std::string(ret));
       delete ret;
+    } else if (shard != nullptr) {
+      WriteLock l(&shard->mutex);
+      if (shard->generation == generation) {
+        shard->files[fname] = *file_info;
+      }
     }
     return s;
   }
@@ -4110,6 +5305,7 @@ struct crocksdb_encryption_key_manager_impl_t : public KeyManager {
       s = Status::Corruption(std::string(ret));
       delete ret;
     }
+    InvalidateCache(fname);
     return s;
   }
 
@@ -4120,6 +5316,8 @@ struct crocksdb_encryption_key_manager_impl_t : public KeyManager {
       s = Status::Corruption(std::string(ret));
       delete ret;
     }
+    // Invalidate even on failure, the callback may have partially applied.
+    InvalidateCache(fname);
     return s;
   }
 
@@ -4131,6 +5329,7 @@ struct crocksdb_encryption_key_manager_impl_t : public KeyManager {
       s = Status::Corruption(std::string(ret));
       delete ret;
     }
+    InvalidateCache(dst_fname);
     return s;
   }
 };
@@ -4155,6 +5354,23 @@ crocksdb_encryption_key_manager_t* crocksdb_encryption_key_manager_create(
   return key_manager;
 }
 
+crocksdb_encryption_key_manager_t*
+crocksdb_encryption_key_manager_create_with_cache(
+    void* state, void (*destructor)(void*),
+    crocksdb_encryption_key_manager_get_file_cb get_file,
+    crocksdb_encryption_key_manager_new_file_cb new_file,
+    crocksdb_encryption_key_manager_delete_file_cb delete_file,
+    crocksdb_encryption_key_manager_link_file_cb link_file,
+    int num_shard_bits) {
+  assert(num_shard_bits >= 0 && num_shard_bits < 20);
+  crocksdb_encryption_key_manager_t* key_manager =
+      crocksdb_encryption_key_manager_create(state, destructor, get_file,
+                                             new_file, delete_file, link_file);
+  static_cast<crocksdb_encryption_key_manager_impl_t*>(key_manager->rep.get())
+      ->EnableCache(num_shard_bits);
+  return key_manager;
+}
+
 void crocksdb_encryption_key_manager_destroy(
     crocksdb_encryption_key_manager_t* key_manager) {
   delete key_manager;
@@ -4221,6 +5437,172 @@ crocksdb_env_t* crocksdb_key_managed_encrypted_env_create(
   result->is_default = false;
   return result;
 }
+
+// AES-CTR over whole buffers. Unlike a BlockCipher, which CTR mode calls
+// once per block, one call ciphers a whole read or write, and OpenSSL
+// processes several counter blocks at a time with AES-NI/VAES when the CPU
+// supports them, falling back to portable code otherwise.
+class AESCTRCipherStream : public rocksdb::BlockAccessCipherStream {
+ public:
+  static const size_t kBlockSize = 16;
+
+  AESCTRCipherStream(const EVP_CIPHER* cipher, const std::string& key,
+                     const char* iv)
+      : cipher_(cipher), key_(key) {
+    memcpy(iv_, iv, kBlockSize);
+  }
+
+  size_t BlockSize() override { return kBlockSize; }
+
+  Status Encrypt(uint64_t file_offset, char* data, size_t data_size) override {
+    return Cipher(file_offset, data, data_size);
+  }
+
+  Status Decrypt(uint64_t file_offset, char* data, size_t data_size) override {
+    return Cipher(file_offset, data, data_size);
+  }
+
+ protected:
+  void AllocateScratch(std::string&) override {}
+
+  Status EncryptBlock(uint64_t block_index, char* data, char*) override {
+    return Cipher(block_index * kBlockSize, data, kBlockSize);
+  }
+
+  Status DecryptBlock(uint64_t block_index, char* data, char*) override {
+    return Cipher(block_index * kBlockSize, data, kBlockSize);
+  }
+
+ private:
+  Status Cipher(uint64_t file_offset, char* data, size_t data_size) {
+    // The counter of a block is the IV plus the block index, as a 128-bit
+    // big endian integer.
+    uint64_t block_index = file_offset / kBlockSize;
+    uint64_t iv_high = 0, iv_low = 0;
+    for (size_t i = 0; i < 8; i++) {
+      iv_high = (iv_high << 8) | static_cast<unsigned char>(iv_[i]);
+      iv_low = (iv_low << 8) | static_cast<unsigned char>(iv_[i + 8]);
+    }
+    uint64_t counter_low = iv_low + block_index;
+    uint64_t counter_high = iv_high + (counter_low < iv_low ? 1 : 0);
+    unsigned char counter[kBlockSize];
+    for (size_t i = 0; i < 8; i++) {
+      counter[7 - i] = static_cast<unsigned char>(counter_high >> (i * 8));
+      counter[15 - i] = static_cast<unsigned char>(counter_low >> (i * 8));
+    }
+
+    std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)> ctx(
+        EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
+    if (ctx == nullptr ||
+        EVP_EncryptInit_ex(ctx.get(), cipher_, nullptr,
+                           reinterpret_cast<const unsigned char*>(key_.data()),
+                           counter) != 1) {
+      return Status::IOError("failed to initialize AES-CTR cipher");
+    }
+    int out_len = 0;
+    // Skip the part of the first block before `file_offset`.
+    size_t block_offset = file_offset % kBlockSize;
+    if (block_offset > 0) {
+      unsigned char skip[kBlockSize] = {0};
+      if (EVP_EncryptUpdate(ctx.get(), skip, &out_len, skip,
+                            static_cast<int>(block_offset)) != 1) {
+        return Status::IOError("AES-CTR cipher failed");
+      }
+    }
+    unsigned char* buf = reinterpret_cast<unsigned char*>(data);
+    while (data_size > 0) {
+      int len = static_cast<int>(
+          std::min<size_t>(data_size, std::numeric_limits<int>::max()));
+      if (EVP_EncryptUpdate(ctx.get(), buf, &out_len, buf, len) != 1) {
+        return Status::IOError("AES-CTR cipher failed");
+      }
+      buf += len;
+      data_size -= len;
+    }
+    return Status::OK();
+  }
+
+  const EVP_CIPHER* cipher_;
+  const std::string key_;
+  char iv_[kBlockSize];
+};
+
+// Encrypts every file with one key, and a random IV per file stored in the
+// file prefix.
+class AESCTREncryptionProvider : public EncryptionProvider {
+ public:
+  AESCTREncryptionProvider(const EVP_CIPHER* cipher, const std::string& key)
+      : cipher_(cipher), key_(key) {}
+
+  size_t GetPrefixLength() override { return kPrefixLength; }
+
+  Status CreateNewPrefix(const std::string& /*fname*/, char* prefix,
+                         size_t prefix_length) override {
+    if (prefix_length < AESCTRCipherStream::kBlockSize) {
+      return Status::InvalidArgument("prefix too short for the IV");
+    }
+    memset(prefix, 0, prefix_length);
+    if (RAND_bytes(reinterpret_cast<unsigned char*>(prefix),
+                   AESCTRCipherStream::kBlockSize) != 1) {
+      return Status::IOError("failed to generate IV");
+    }
+    return Status::OK();
+  }
+
+  Status CreateCipherStream(
+      const std::string& /*fname*/, const EnvOptions& /*options*/,
+      Slice& prefix,
+      std::unique_ptr<rocksdb::BlockAccessCipherStream>* result) override {
+    if (prefix.size() < AESCTRCipherStream::kBlockSize) {
+      return Status::Corruption("prefix too short for the IV");
+    }
+    result->reset(new AESCTRCipherStream(cipher_, key_, prefix.data()));
+    return Status::OK();
+  }
+
+ private:
+  // Keeps file data page aligned.
+  static const size_t kPrefixLength = 4096;
+
+  const EVP_CIPHER* cipher_;
+  const std::string key_;
+};
+
+crocksdb_env_t* crocksdb_aes_ctr_encrypted_env_create(
+    crocksdb_env_t* base_env, crocksdb_encryption_method_t method,
+    const char* key, size_t keylen, char** errptr) {
+  assert(base_env != nullptr);
+  const EVP_CIPHER* cipher = nullptr;
+  size_t expected_keylen = 0;
+  switch (method) {
+    case crocksdb_encryption_method_t::kAES128_CTR:
+      cipher = EVP_aes_128_ctr();
+      expected_keylen = 16;
+      break;
+    case crocksdb_encryption_method_t::kAES192_CTR:
+      cipher = EVP_aes_192_ctr();
+      expected_keylen = 24;
+      break;
+    case crocksdb_encryption_method_t::kAES256_CTR:
+      cipher = EVP_aes_256_ctr();
+      expected_keylen = 32;
+      break;
+    default:
+      SaveError(errptr, Status::InvalidArgument("unsupported method"));
+      return nullptr;
+  }
+  if (keylen != expected_keylen) {
+    SaveError(errptr, Status::InvalidArgument("key length doesn't match"));
+    return nullptr;
+  }
+  crocksdb_env_t* result = new crocksdb_env_t;
+  result->block_cipher = nullptr;
+  result->encryption_provider =
+      new AESCTREncryptionProvider(cipher, std::string(key, keylen));
+  result->rep = NewEncryptedEnv(base_env->rep, result->encryption_provider);
+  result->is_default = false;
+  return result;
+}
 #endif
 
 struct crocksdb_file_system_inspector_impl_t : public FileSystemInspector {
@@ -4297,58 +5679,428 @@ size_t crocksdb_file_system_inspector_write(
   return allowed;
 }
 
-crocksdb_env_t* crocksdb_file_system_inspected_env_create(
-    crocksdb_env_t* base_env, crocksdb_file_system_inspector_t* inspector) {
-  assert(base_env != nullptr);
-  assert(inspector != nullptr);
-  crocksdb_env_t* result = new crocksdb_env_t;
-  result->rep = NewFileSystemInspectedEnv(base_env->rep, inspector->rep);
-  result->block_cipher = nullptr;
-  result->encryption_provider = nullptr;
-  result->is_default = false;
-  return result;
-}
+// An inspector that keeps a token bucket per direction in native code.
+// Requests take bytes from the bucket without calling back. The refill
+// callback sets a new budget once per refill period, or early, at most once
+// per period, when the bucket runs out. Requests that find the bucket empty
+// wait for the next period, and the wait is accounted as throttled time.
+class TokenBucketFileSystemInspector : public FileSystemInspector {
+ public:
+  enum Direction { kRead = 0, kWrite = 1, kNumDirections };
 
-crocksdb_sstfilereader_t* crocksdb_sstfilereader_create(
-    const crocksdb_options_t* io_options) {
-  auto reader = new crocksdb_sstfilereader_t;
-  reader->rep = new SstFileReader(io_options->rep);
-  return reader;
-}
+  TokenBucketFileSystemInspector(
+      void* state, void (*destructor)(void*),
+      crocksdb_file_system_inspector_refill_cb refill_read,
+      crocksdb_file_system_inspector_refill_cb refill_write,
+      uint64_t refill_period_us)
+      : state_(state),
+        destructor_(destructor),
+        env_(Env::Default()),
+        refill_period_us_(std::max<uint64_t>(refill_period_us, 1)) {
+    refill_[kRead] = refill_read;
+    refill_[kWrite] = refill_write;
+  }
 
-void crocksdb_sstfilereader_open(crocksdb_sstfilereader_t* reader,
-                                 const char* name, char** errptr) {
-  SaveError(errptr, reader->rep->Open(std::string(name)));
-}
+  ~TokenBucketFileSystemInspector() override { destructor_(state_); }
 
-crocksdb_iterator_t* crocksdb_sstfilereader_new_iterator(
-    crocksdb_sstfilereader_t* reader, const crocksdb_readoptions_t* options) {
-  auto it = new crocksdb_iterator_t;
-  it->rep = reader->rep->NewIterator(options->rep);
-  return it;
-}
+  Status Read(size_t len, size_t* allowed) override {
+    return Request(kRead, len, allowed);
+  }
 
-void crocksdb_sstfilereader_read_table_properties(
-    const crocksdb_sstfilereader_t* reader, void* ctx,
-    void (*cb)(void*, const crocksdb_table_properties_t*)) {
-  auto props = reader->rep->GetTableProperties();
-  cb(ctx, reinterpret_cast<const crocksdb_table_properties_t*>(props.get()));
-}
+  Status Write(size_t len, size_t* allowed) override {
+    return Request(kWrite, len, allowed);
+  }
 
-void crocksdb_sstfilereader_verify_checksum(crocksdb_sstfilereader_t* reader,
-                                            char** errptr) {
-  SaveError(errptr, reader->rep->VerifyChecksum());
-}
+  uint64_t GetThrottledMicros(Direction dir) const {
+    return buckets_[dir].throttled_micros.load(std::memory_order_relaxed);
+  }
 
-void crocksdb_sstfilereader_destroy(crocksdb_sstfilereader_t* reader) {
-  delete reader->rep;
-  delete reader;
-}
+  uint64_t GetRefillCount(Direction dir) const {
+    return buckets_[dir].refills.load(std::memory_order_relaxed);
+  }
 
-crocksdb_sstfilewriter_t* crocksdb_sstfilewriter_create(
-    const crocksdb_envoptions_t* env, const crocksdb_options_t* io_options) {
-  crocksdb_sstfilewriter_t* writer = new crocksdb_sstfilewriter_t;
-  writer->rep = new SstFileWriter(env->rep, io_options->rep);
+ private:
+  struct Bucket {
+    std::atomic<int64_t> available{0};
+    // Zero until the first refill, so the first request refills.
+    std::atomic<uint64_t> next_refill_us{0};
+    std::atomic<bool> refilled_early{false};
+    std::atomic<uint64_t> throttled_micros{0};
+    std::atomic<uint64_t> refills{0};
+    std::mutex mutex;
+    int64_t budget = 0;
+  };
+
+  Status Request(Direction dir, size_t len, size_t* allowed) {
+    assert(allowed);
+    Bucket& bucket = buckets_[dir];
+    uint64_t throttled_since = 0;
+    while (true) {
+      uint64_t now = env_->NowMicros();
+      uint64_t next_refill_us =
+          bucket.next_refill_us.load(std::memory_order_acquire);
+      if (now < next_refill_us) {
+        int64_t available = bucket.available.load(std::memory_order_relaxed);
+        while (available > 0) {
+          int64_t take = std::min<int64_t>(available, len);
+          if (bucket.available.compare_exchange_weak(
+                  available, available - take, std::memory_order_relaxed)) {
+            *allowed = static_cast<size_t>(take);
+            if (throttled_since != 0) {
+              bucket.throttled_micros.fetch_add(now - throttled_since,
+                                                std::memory_order_relaxed);
+            }
+            return Status::OK();
+          }
+        }
+        if (bucket.refilled_early.load(std::memory_order_relaxed)) {
+          if (throttled_since == 0) {
+            throttled_since = now;
+          }
+          // A long wait is slept in bounded chunks by the loop.
+          env_->SleepForMicroseconds(static_cast<int>(std::min<uint64_t>(
+              next_refill_us - now, std::numeric_limits<int>::max())));
+          continue;
+        }
+      }
+      Status s = Refill(dir, now >= next_refill_us);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+
+  Status Refill(Direction dir, bool period_elapsed) {
+    Bucket& bucket = buckets_[dir];
+    std::lock_guard<std::mutex> guard(bucket.mutex);
+    uint64_t now = env_->NowMicros();
+    uint64_t next_refill_us = bucket.next_refill_us.load();
+    if (period_elapsed ? now < next_refill_us
+                       : bucket.refilled_early.load() ||
+                             bucket.available.load() > 0) {
+      // Refilled by another request meanwhile.
+      return Status::OK();
+    }
+    int64_t left = std::max<int64_t>(bucket.available.exchange(0), 0);
+    size_t used = static_cast<size_t>(bucket.budget - left);
+    char* err = nullptr;
+    size_t budget = refill_[dir](state_, used, &err);
+    if (err) {
+      Status s = Status::IOError(err);
+      // malloc-ed by strdup
+      free(err);
+      return s;
+    }
+    bucket.budget = static_cast<int64_t>(std::min<size_t>(
+        budget, static_cast<size_t>(std::numeric_limits<int64_t>::max())));
+    bucket.refills.fetch_add(1, std::memory_order_relaxed);
+    if (period_elapsed) {
+      bucket.refilled_early.store(false, std::memory_order_relaxed);
+      bucket.available.store(bucket.budget, std::memory_order_relaxed);
+      bucket.next_refill_us.store(now + refill_period_us_,
+                                  std::memory_order_release);
+    } else {
+      bucket.refilled_early.store(true, std::memory_order_relaxed);
+      bucket.available.store(bucket.budget, std::memory_order_relaxed);
+    }
+    return Status::OK();
+  }
+
+  void* state_;
+  void (*destructor_)(void*);
+  crocksdb_file_system_inspector_refill_cb refill_[kNumDirections];
+  Env* const env_;
+  const uint64_t refill_period_us_;
+  Bucket buckets_[kNumDirections];
+};
+
+crocksdb_file_system_inspector_t*
+crocksdb_token_bucket_file_system_inspector_create(
+    void* state, void (*destructor)(void*),
+    crocksdb_file_system_inspector_refill_cb refill_read,
+    crocksdb_file_system_inspector_refill_cb refill_write,
+    uint64_t refill_period_us) {
+  crocksdb_file_system_inspector_t* inspector =
+      new crocksdb_file_system_inspector_t;
+  inspector->token_bucket = std::make_shared<TokenBucketFileSystemInspector>(
+      state, destructor, refill_read, refill_write, refill_period_us);
+  inspector->rep = inspector->token_bucket;
+  return inspector;
+}
+
+uint64_t crocksdb_file_system_inspector_get_read_throttled_micros(
+    crocksdb_file_system_inspector_t* inspector) {
+  if (!inspector->token_bucket) {
+    return 0;
+  }
+  return inspector->token_bucket->GetThrottledMicros(
+      TokenBucketFileSystemInspector::kRead);
+}
+
+uint64_t crocksdb_file_system_inspector_get_write_throttled_micros(
+    crocksdb_file_system_inspector_t* inspector) {
+  if (!inspector->token_bucket) {
+    return 0;
+  }
+  return inspector->token_bucket->GetThrottledMicros(
+      TokenBucketFileSystemInspector::kWrite);
+}
+
+uint64_t crocksdb_file_system_inspector_get_refill_count(
+    crocksdb_file_system_inspector_t* inspector) {
+  if (!inspector->token_bucket) {
+    return 0;
+  }
+  return inspector->token_bucket->GetRefillCount(
+             TokenBucketFileSystemInspector::kRead) +
+         inspector->token_bucket->GetRefillCount(
+             TokenBucketFileSystemInspector::kWrite);
+}
+
+crocksdb_env_t* crocksdb_file_system_inspected_env_create(
+    crocksdb_env_t* base_env, crocksdb_file_system_inspector_t* inspector) {
+  assert(base_env != nullptr);
+  assert(inspector != nullptr);
+  crocksdb_env_t* result = new crocksdb_env_t;
+  result->rep = NewFileSystemInspectedEnv(base_env->rep, inspector->rep);
+  result->block_cipher = nullptr;
+  result->encryption_provider = nullptr;
+  result->is_default = false;
+  return result;
+}
+
+crocksdb_sstfilereader_t* crocksdb_sstfilereader_create(
+    const crocksdb_options_t* io_options) {
+  auto reader = new crocksdb_sstfilereader_t;
+  reader->rep = new SstFileReader(io_options->rep);
+  return reader;
+}
+
+void crocksdb_sstfilereader_open(crocksdb_sstfilereader_t* reader,
+                                 const char* name, char** errptr) {
+  SaveError(errptr, reader->rep->Open(std::string(name)));
+}
+
+crocksdb_iterator_t* crocksdb_sstfilereader_new_iterator(
+    crocksdb_sstfilereader_t* reader, const crocksdb_readoptions_t* options) {
+  auto it = new crocksdb_iterator_t;
+  it->rep = reader->rep->NewIterator(options->rep);
+  return it;
+}
+
+void crocksdb_sstfilereader_read_table_properties(
+    const crocksdb_sstfilereader_t* reader, void* ctx,
+    void (*cb)(void*, const crocksdb_table_properties_t*)) {
+  auto props = reader->rep->GetTableProperties();
+  cb(ctx, reinterpret_cast<const crocksdb_table_properties_t*>(props.get()));
+}
+
+void crocksdb_sstfilereader_verify_checksum(crocksdb_sstfilereader_t* reader,
+                                            char** errptr) {
+  SaveError(errptr, reader->rep->VerifyChecksum());
+}
+
+void crocksdb_sstfilereader_destroy(crocksdb_sstfilereader_t* reader) {
+  delete reader->rep;
+  delete reader;
+}
+
+// Checksum of a whole file, fed with the file content in order. The value is
+// encoded in big endian, so it reads the same as the hex digest.
+class FileChecksum {
+ public:
+  explicit FileChecksum(int type) : type_(type), crc_(0), xxh_(nullptr) {
+    if (type_ == crocksdb_file_checksum_xxh64) {
+      xxh_ = rocksdb::XXH64_createState();
+      rocksdb::XXH64_reset(xxh_, 0);
+    }
+  }
+  ~FileChecksum() {
+    if (xxh_ != nullptr) {
+      rocksdb::XXH64_freeState(xxh_);
+    }
+  }
+
+  static bool IsValidType(int type) {
+    return type == crocksdb_file_checksum_crc32c ||
+           type == crocksdb_file_checksum_xxh64;
+  }
+
+  static const char* FuncName(int type) {
+    switch (type) {
+      case crocksdb_file_checksum_crc32c:
+        return "FileChecksumCrc32c";
+      case crocksdb_file_checksum_xxh64:
+        return "FileChecksumXXH64";
+      default:
+        return "";
+    }
+  }
+
+  void Update(const char* data, size_t n) {
+    if (type_ == crocksdb_file_checksum_crc32c) {
+      crc_ = rocksdb::crc32c::Extend(crc_, data, n);
+    } else if (xxh_ != nullptr) {
+      rocksdb::XXH64_update(xxh_, data, n);
+    }
+  }
+
+  std::string Value() const {
+    uint64_t v = 0;
+    size_t width = 0;
+    if (type_ == crocksdb_file_checksum_crc32c) {
+      v = crc_;
+      width = sizeof(uint32_t);
+    } else if (xxh_ != nullptr) {
+      v = rocksdb::XXH64_digest(xxh_);
+      width = sizeof(uint64_t);
+    }
+    std::string result(width, '\0');
+    for (size_t i = width; i > 0; i--) {
+      result[i - 1] = static_cast<char>(v & 0xff);
+      v >>= 8;
+    }
+    return result;
+  }
+
+ private:
+  int type_;
+  uint32_t crc_;
+  rocksdb::XXH64_state_t* xxh_;
+};
+
+// Checksums everything appended to the file, so the writer gets the checksum
+// of the file it has just written without reading it back.
+class FileChecksumWritableFile : public WritableFile {
+ public:
+  FileChecksumWritableFile(std::unique_ptr<WritableFile>&& file, int type,
+                           std::function<void(const std::string&)> done)
+      : file_(std::move(file)),
+        checksum_(type),
+        size_(0),
+        valid_(true),
+        done_(std::move(done)) {}
+
+  Status Append(const Slice& data) override {
+    checksum_.Update(data.data(), data.size());
+    size_ += data.size();
+    return file_->Append(data);
+  }
+  Status PositionedAppend(const Slice& data, uint64_t offset) override {
+    if (offset == size_) {
+      checksum_.Update(data.data(), data.size());
+      size_ += data.size();
+    } else {
+      // Rewriting what is already checksummed, e.g. the tail of a direct
+      // write, leaves no valid checksum.
+      valid_ = false;
+    }
+    return file_->PositionedAppend(data, offset);
+  }
+  Status Truncate(uint64_t size) override { return file_->Truncate(size); }
+  Status Close() override {
+    Status s = file_->Close();
+    if (s.ok() && valid_) {
+      done_(checksum_.Value());
+    }
+    return s;
+  }
+  Status Flush() override { return file_->Flush(); }
+  Status Sync() override { return file_->Sync(); }
+  Status Fsync() override { return file_->Fsync(); }
+  bool IsSyncThreadSafe() const override { return file_->IsSyncThreadSafe(); }
+  bool use_direct_io() const override { return file_->use_direct_io(); }
+  size_t GetRequiredBufferAlignment() const override {
+    return file_->GetRequiredBufferAlignment();
+  }
+  void SetIOPriority(Env::IOPriority pri) override {
+    file_->SetIOPriority(pri);
+  }
+  Env::IOPriority GetIOPriority() override { return file_->GetIOPriority(); }
+  void SetWriteLifeTimeHint(Env::WriteLifeTimeHint hint) override {
+    file_->SetWriteLifeTimeHint(hint);
+  }
+  Env::WriteLifeTimeHint GetWriteLifeTimeHint() override {
+    return file_->GetWriteLifeTimeHint();
+  }
+  uint64_t GetFileSize() override { return file_->GetFileSize(); }
+  void SetPreallocationBlockSize(size_t size) override {
+    file_->SetPreallocationBlockSize(size);
+  }
+  void GetPreallocationStatus(size_t* block_size,
+                              size_t* last_allocated_block) override {
+    file_->GetPreallocationStatus(block_size, last_allocated_block);
+  }
+  size_t GetUniqueId(char* id, size_t max_size) const override {
+    return file_->GetUniqueId(id, max_size);
+  }
+  Status InvalidateCache(size_t offset, size_t length) override {
+    return file_->InvalidateCache(offset, length);
+  }
+  Status RangeSync(uint64_t offset, uint64_t nbytes) override {
+    return file_->RangeSync(offset, nbytes);
+  }
+  void PrepareWrite(size_t offset, size_t len) override {
+    file_->PrepareWrite(offset, len);
+  }
+  Status Allocate(uint64_t offset, uint64_t len) override {
+    return file_->Allocate(offset, len);
+  }
+
+ private:
+  std::unique_ptr<WritableFile> file_;
+  FileChecksum checksum_;
+  uint64_t size_;
+  bool valid_;
+  std::function<void(const std::string&)> done_;
+};
+
+// Hands out files that checksum themselves as they are written, and keeps
+// the checksums of the closed ones until they are taken.
+class FileChecksumEnv : public rocksdb::EnvWrapper {
+ public:
+  FileChecksumEnv(Env* base, int type)
+      : rocksdb::EnvWrapper(base), type_(type) {}
+
+  Status NewWritableFile(const std::string& fname,
+                         std::unique_ptr<WritableFile>* result,
+                         const EnvOptions& options) override {
+    std::unique_ptr<WritableFile> file;
+    Status s = rocksdb::EnvWrapper::NewWritableFile(fname, &file, options);
+    if (s.ok()) {
+      result->reset(new FileChecksumWritableFile(
+          std::move(file), type_, [this, fname](const std::string& checksum) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            checksums_[fname] = checksum;
+          }));
+    }
+    return s;
+  }
+
+  const char* FuncName() const { return FileChecksum::FuncName(type_); }
+
+  // Returns false if no checksum is known for `fname`.
+  bool TakeChecksum(const std::string& fname, std::string* checksum) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = checksums_.find(fname);
+    if (it == checksums_.end()) {
+      return false;
+    }
+    checksum->swap(it->second);
+    checksums_.erase(it);
+    return true;
+  }
+
+ private:
+  int type_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::string> checksums_;
+};
+
+crocksdb_sstfilewriter_t* crocksdb_sstfilewriter_create(
+    const crocksdb_envoptions_t* env, const crocksdb_options_t* io_options) {
+  crocksdb_sstfilewriter_t* writer = new crocksdb_sstfilewriter_t;
+  writer->rep = new SstFileWriter(env->rep, io_options->rep);
   return writer;
 }
 
@@ -4361,6 +6113,28 @@ crocksdb_sstfilewriter_t* crocksdb_sstfilewriter_create_cf(
   return writer;
 }
 
+crocksdb_sstfilewriter_t* crocksdb_sstfilewriter_create_with_file_checksum(
+    const crocksdb_envoptions_t* env, const crocksdb_options_t* io_options,
+    crocksdb_column_family_handle_t* column_family, int checksum_type,
+    char** errptr) {
+  if (!FileChecksum::IsValidType(checksum_type)) {
+    SaveError(errptr, Status::InvalidArgument("unknown file checksum type"));
+    return nullptr;
+  }
+  Options options = io_options->rep;
+  crocksdb_sstfilewriter_t* writer = new crocksdb_sstfilewriter_t;
+  writer->checksum_env.reset(new FileChecksumEnv(options.env, checksum_type));
+  options.env = writer->checksum_env.get();
+  // Direct writes rewrite the tail of the file, which can't be checksummed
+  // on the way, so the file is always written through the buffered path.
+  EnvOptions env_options = env->rep;
+  env_options.use_direct_writes = false;
+  writer->rep = new SstFileWriter(
+      env_options, options,
+      column_family != nullptr ? column_family->rep : nullptr);
+  return writer;
+}
+
 void crocksdb_sstfilewriter_open(crocksdb_sstfilewriter_t* writer,
                                  const char* name, char** errptr) {
   SaveError(errptr, writer->rep->Open(std::string(name)));
@@ -4397,7 +6171,16 @@ void crocksdb_sstfilewriter_delete_range(crocksdb_sstfilewriter_t* writer,
 void crocksdb_sstfilewriter_finish(crocksdb_sstfilewriter_t* writer,
                                    crocksdb_externalsstfileinfo_t* info,
                                    char** errptr) {
-  SaveError(errptr, writer->rep->Finish(&info->rep));
+  info->file_checksum.clear();
+  info->file_checksum_func_name.clear();
+  if (SaveError(errptr, writer->rep->Finish(&info->rep))) {
+    return;
+  }
+  if (writer->checksum_env != nullptr &&
+      writer->checksum_env->TakeChecksum(info->rep.file_path,
+                                         &info->file_checksum)) {
+    info->file_checksum_func_name = writer->checksum_env->FuncName();
+  }
 }
 
 uint64_t crocksdb_sstfilewriter_file_size(crocksdb_sstfilewriter_t* writer) {
@@ -4409,6 +6192,463 @@ void crocksdb_sstfilewriter_destroy(crocksdb_sstfilewriter_t* writer) {
   delete writer;
 }
 
+// Builds a sequence of SST files from sorted input on a thread pool. Input is
+// buffered into one chunk per output file. A chunk is cut when its input
+// reaches the target size or when the caller asks for it, and is then built
+// and compressed by a worker while the caller keeps adding keys. A cut is
+// put off while a range deletion is open, so that the files never overlap
+// and can be ingested together.
+struct crocksdb_parallel_sstfilewriter_t {
+  enum EntryType : char { kPut = 0, kMerge = 1, kDelete = 2, kDeleteRange = 3 };
+
+  struct Chunk {
+    std::string file_path;
+    std::string entries;
+    Status status;
+    ExternalSstFileInfo info;
+  };
+
+  EnvOptions env_options;
+  Options options;
+  ColumnFamilyHandle* column_family = nullptr;
+  std::string path_prefix;
+  uint64_t target_file_size = 0;
+  int num_threads = 1;
+  std::unique_ptr<rocksdb::ThreadPool> pool;
+
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  std::string current;
+  std::string last_key;
+  bool has_last_key = false;
+  // The largest end of the range deletions in `current`, while a key up to
+  // it may still be added. Ingestion counts it in the range of the file.
+  std::string range_end;
+  bool has_range_end = false;
+  bool cut_pending = false;
+  bool finished = false;
+
+  // Limits the chunks waiting for a worker, so memory stays around
+  // 2 * num_threads * target_file_size however fast the input comes.
+  std::mutex mutex;
+  std::condition_variable cv;
+  int pending = 0;
+  Status bg_status;
+
+  ~crocksdb_parallel_sstfilewriter_t() { WaitForPending(); }
+
+  void WaitForPending() {
+    if (pool == nullptr) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return pending == 0; });
+    lock.unlock();
+    pool->JoinAllThreads();
+    pool.reset();
+  }
+
+  void WriteChunk(Chunk* chunk) {
+    SstFileWriter writer(env_options, options, column_family);
+    Status s = writer.Open(chunk->file_path);
+    Slice input(chunk->entries);
+    while (s.ok() && !input.empty()) {
+      char type = input[0];
+      input.remove_prefix(1);
+      Slice key, value;
+      if (!rocksdb::GetLengthPrefixedSlice(&input, &key) ||
+          !rocksdb::GetLengthPrefixedSlice(&input, &value)) {
+        s = Status::Corruption("malformed parallel sst writer chunk");
+        break;
+      }
+      switch (type) {
+        case kPut:
+          s = writer.Put(key, value);
+          break;
+        case kMerge:
+          s = writer.Merge(key, value);
+          break;
+        case kDelete:
+          s = writer.Delete(key);
+          break;
+        default:
+          s = writer.DeleteRange(key, value);
+          break;
+      }
+    }
+    if (s.ok()) {
+      s = writer.Finish(&chunk->info);
+    }
+    std::string().swap(chunk->entries);
+    std::lock_guard<std::mutex> guard(mutex);
+    chunk->status = s;
+    if (!s.ok() && bg_status.ok()) {
+      bg_status = s;
+    }
+    pending--;
+    cv.notify_all();
+  }
+
+  Status Cut() {
+    if (has_range_end) {
+      cut_pending = true;
+      return Status::OK();
+    }
+    return CutChunk();
+  }
+
+  Status CutChunk() {
+    cut_pending = false;
+    has_range_end = false;
+    if (current.empty()) {
+      return Status::OK();
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "%06zu.sst", chunks.size() + 1);
+    chunks.emplace_back(new Chunk);
+    Chunk* chunk = chunks.back().get();
+    chunk->file_path = path_prefix + name;
+    chunk->entries.swap(current);
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [this] { return pending < num_threads * 2; });
+      if (!bg_status.ok()) {
+        return bg_status;
+      }
+      pending++;
+    }
+    pool->SubmitJob([this, chunk] { WriteChunk(chunk); });
+    return Status::OK();
+  }
+
+  Status Add(EntryType type, const Slice& key, const Slice& value) {
+    if (finished) {
+      return Status::InvalidArgument("parallel sst writer is finished");
+    }
+    const Comparator* cmp = options.comparator;
+    // A range deletion is ordered by its begin key.
+    if (has_last_key && cmp->Compare(key, Slice(last_key)) <= 0) {
+      return Status::InvalidArgument(
+          "Keys must be added in strict ascending order.");
+    }
+    if (type == kDeleteRange && cmp->Compare(key, value) >= 0) {
+      return Status::InvalidArgument(
+          "Range deletion begin key must be before its end key.");
+    }
+    if (has_range_end && cmp->Compare(key, Slice(range_end)) > 0) {
+      has_range_end = false;
+    }
+    if (cut_pending && !has_range_end) {
+      Status s = CutChunk();
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    last_key.assign(key.data(), key.size());
+    has_last_key = true;
+    if (type == kDeleteRange &&
+        (!has_range_end || cmp->Compare(value, Slice(range_end)) > 0)) {
+      range_end.assign(value.data(), value.size());
+      has_range_end = true;
+    }
+    current.push_back(type);
+    rocksdb::PutLengthPrefixedSlice(&current, key);
+    rocksdb::PutLengthPrefixedSlice(&current, value);
+    if (current.size() >= target_file_size) {
+      return Cut();
+    }
+    return Status::OK();
+  }
+
+  Status Finish() {
+    if (finished) {
+      return Status::InvalidArgument("parallel sst writer is finished");
+    }
+    finished = true;
+    Status s = CutChunk();
+    WaitForPending();
+    if (s.ok()) {
+      s = bg_status;
+    }
+    if (!s.ok()) {
+      // Don't leave a partial set of files behind for the caller to ingest.
+      for (auto& chunk : chunks) {
+        options.env->DeleteFile(chunk->file_path);
+      }
+      chunks.clear();
+    }
+    return s;
+  }
+};
+
+crocksdb_parallel_sstfilewriter_t* crocksdb_parallel_sstfilewriter_create(
+    const crocksdb_envoptions_t* env, const crocksdb_options_t* io_options,
+    crocksdb_column_family_handle_t* column_family, const char* path_prefix,
+    uint64_t target_file_size, int num_threads) {
+  crocksdb_parallel_sstfilewriter_t* writer =
+      new crocksdb_parallel_sstfilewriter_t;
+  writer->env_options = env->rep;
+  writer->options = io_options->rep;
+  if (column_family != nullptr) {
+    writer->column_family = column_family->rep;
+  }
+  writer->path_prefix = path_prefix;
+  writer->target_file_size = std::max<uint64_t>(target_file_size, 1);
+  writer->num_threads = std::max(num_threads, 1);
+  writer->pool.reset(rocksdb::NewThreadPool(writer->num_threads));
+  return writer;
+}
+
+void crocksdb_parallel_sstfilewriter_put(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* key, size_t keylen,
+    const char* val, size_t vallen, char** errptr) {
+  SaveError(errptr, writer->Add(crocksdb_parallel_sstfilewriter_t::kPut,
+                                Slice(key, keylen), Slice(val, vallen)));
+}
+
+void crocksdb_parallel_sstfilewriter_merge(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* key, size_t keylen,
+    const char* val, size_t vallen, char** errptr) {
+  SaveError(errptr, writer->Add(crocksdb_parallel_sstfilewriter_t::kMerge,
+                                Slice(key, keylen), Slice(val, vallen)));
+}
+
+void crocksdb_parallel_sstfilewriter_delete(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* key, size_t keylen,
+    char** errptr) {
+  SaveError(errptr, writer->Add(crocksdb_parallel_sstfilewriter_t::kDelete,
+                                Slice(key, keylen), Slice()));
+}
+
+void crocksdb_parallel_sstfilewriter_delete_range(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* begin_key,
+    size_t begin_keylen, const char* end_key, size_t end_keylen,
+    char** errptr) {
+  SaveError(errptr,
+            writer->Add(crocksdb_parallel_sstfilewriter_t::kDeleteRange,
+                        Slice(begin_key, begin_keylen),
+                        Slice(end_key, end_keylen)));
+}
+
+void crocksdb_parallel_sstfilewriter_cut(
+    crocksdb_parallel_sstfilewriter_t* writer, char** errptr) {
+  SaveError(errptr, writer->Cut());
+}
+
+size_t crocksdb_parallel_sstfilewriter_finish(
+    crocksdb_parallel_sstfilewriter_t* writer, char** errptr) {
+  if (SaveError(errptr, writer->Finish())) {
+    return 0;
+  }
+  return writer->chunks.size();
+}
+
+void crocksdb_parallel_sstfilewriter_get_file_info(
+    crocksdb_parallel_sstfilewriter_t* writer, size_t index,
+    crocksdb_externalsstfileinfo_t* info) {
+  assert(writer->finished && index < writer->chunks.size());
+  info->rep = writer->chunks[index]->info;
+}
+
+void crocksdb_parallel_sstfilewriter_destroy(
+    crocksdb_parallel_sstfilewriter_t* writer) {
+  delete writer;
+}
+
+// Writes the data of a snapshot in a set of key ranges into sst files under
+// a directory, scanning up to `num_threads` ranges at a time. Each range gets
+// its own sequence of files, cut at `target_file_size`, so the memory used
+// per range stays bounded to what one SstFileWriter buffers.
+struct crocksdb_snapshot_exporter_t {
+  struct Range {
+    ColumnFamilyHandle* column_family;
+    std::string start;
+    std::string end;
+    // Every file opened for the range, including an unfinished one.
+    std::vector<std::string> paths;
+    std::vector<ExternalSstFileInfo> files;
+    uint64_t num_keys = 0;
+    uint64_t num_bytes = 0;
+  };
+
+  DB* db;
+  const Snapshot* snapshot;
+  std::string dir;
+  int num_threads;
+  uint64_t target_file_size = 0;
+  std::shared_ptr<RateLimiter> rate_limiter;
+  std::vector<Range> ranges;
+  bool has_run = false;
+
+  Status ExportRange(size_t index, const std::atomic<bool>& stop) {
+    Range& range = ranges[index];
+    Options options = db->GetOptions(range.column_family);
+    EnvOptions env_options(options);
+    env_options.rate_limiter = rate_limiter.get();
+    ReadOptions read_options;
+    read_options.snapshot = snapshot;
+    read_options.fill_cache = false;
+    // A range spans many prefixes, which the prefix bloom filters of the
+    // start key must not hide.
+    read_options.total_order_seek = true;
+    Slice upper_bound(range.end);
+    if (!range.end.empty()) {
+      read_options.iterate_upper_bound = &upper_bound;
+    }
+    std::unique_ptr<Iterator> iter(
+        db->NewIterator(read_options, range.column_family));
+    std::unique_ptr<SstFileWriter> writer;
+    Status s;
+    for (iter->Seek(range.start); iter->Valid() && !stop; iter->Next()) {
+      if (writer == nullptr) {
+        char name[64];
+        snprintf(name, sizeof(name), "/%06zu_%06zu.sst", index,
+                 range.paths.size() + 1);
+        range.paths.push_back(dir + name);
+        // Without an I/O priority the writer bypasses the rate limiter.
+        writer.reset(new SstFileWriter(env_options, options,
+                                       range.column_family,
+                                       true /* invalidate_page_cache */,
+                                       Env::IO_LOW));
+        s = writer->Open(range.paths.back());
+        if (!s.ok()) {
+          break;
+        }
+      }
+      s = writer->Put(iter->key(), iter->value());
+      if (!s.ok()) {
+        break;
+      }
+      range.num_keys++;
+      range.num_bytes += iter->key().size() + iter->value().size();
+      if (target_file_size > 0 && writer->FileSize() >= target_file_size) {
+        range.files.emplace_back();
+        s = writer->Finish(&range.files.back());
+        writer.reset();
+        if (!s.ok()) {
+          break;
+        }
+      }
+    }
+    if (s.ok()) {
+      s = iter->status();
+    }
+    if (s.ok() && writer != nullptr) {
+      range.files.emplace_back();
+      s = writer->Finish(&range.files.back());
+    }
+    return s;
+  }
+
+  Status Run() {
+    if (has_run) {
+      // The files of the previous run would be overwritten.
+      return Status::InvalidArgument("snapshot exporter can only run once");
+    }
+    has_run = true;
+    std::atomic<size_t> next_range(0);
+    std::atomic<bool> stop(false);
+    std::mutex mutex;
+    Status status;
+    auto work = [&]() {
+      size_t i;
+      while (!stop && (i = next_range.fetch_add(1)) < ranges.size()) {
+        auto s = ExportRange(i, stop);
+        if (!s.ok()) {
+          std::lock_guard<std::mutex> guard(mutex);
+          if (status.ok()) {
+            status = s;
+          }
+          stop = true;
+        }
+      }
+    };
+    size_t num_workers = std::min(
+        static_cast<size_t>(std::max(num_threads, 1)), ranges.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_workers; i++) {
+      workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    if (!status.ok()) {
+      // Don't leave a partial export behind.
+      for (auto& range : ranges) {
+        for (auto& path : range.paths) {
+          db->GetEnv()->DeleteFile(path);
+        }
+        range.files.clear();
+      }
+    }
+    return status;
+  }
+};
+
+crocksdb_snapshot_exporter_t* crocksdb_snapshot_exporter_create(
+    crocksdb_t* db, const crocksdb_snapshot_t* snapshot, const char* dir,
+    int num_threads) {
+  auto exporter = new crocksdb_snapshot_exporter_t;
+  exporter->db = db->rep;
+  exporter->snapshot = snapshot->rep;
+  exporter->dir = dir;
+  exporter->num_threads = num_threads;
+  return exporter;
+}
+
+void crocksdb_snapshot_exporter_set_target_file_size(
+    crocksdb_snapshot_exporter_t* exporter, uint64_t target_file_size) {
+  exporter->target_file_size = target_file_size;
+}
+
+void crocksdb_snapshot_exporter_set_rate_limiter(
+    crocksdb_snapshot_exporter_t* exporter, crocksdb_ratelimiter_t* limiter) {
+  exporter->rate_limiter = limiter->rep;
+}
+
+size_t crocksdb_snapshot_exporter_add_range(
+    crocksdb_snapshot_exporter_t* exporter,
+    crocksdb_column_family_handle_t* column_family, const char* start_key,
+    size_t start_key_len, const char* end_key, size_t end_key_len) {
+  crocksdb_snapshot_exporter_t::Range range;
+  range.column_family = column_family->rep;
+  range.start.assign(start_key, start_key_len);
+  range.end.assign(end_key, end_key_len);
+  exporter->ranges.push_back(std::move(range));
+  return exporter->ranges.size() - 1;
+}
+
+void crocksdb_snapshot_exporter_run(crocksdb_snapshot_exporter_t* exporter,
+                                    char** errptr) {
+  SaveError(errptr, exporter->Run());
+}
+
+size_t crocksdb_snapshot_exporter_range_file_count(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range) {
+  return exporter->ranges[range].files.size();
+}
+
+void crocksdb_snapshot_exporter_range_file_info(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range, size_t index,
+    crocksdb_externalsstfileinfo_t* info) {
+  info->rep = exporter->ranges[range].files[index];
+}
+
+uint64_t crocksdb_snapshot_exporter_range_num_keys(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range) {
+  return exporter->ranges[range].num_keys;
+}
+
+uint64_t crocksdb_snapshot_exporter_range_num_bytes(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range) {
+  return exporter->ranges[range].num_bytes;
+}
+
+void crocksdb_snapshot_exporter_destroy(
+    crocksdb_snapshot_exporter_t* exporter) {
+  delete exporter;
+}
+
 crocksdb_externalsstfileinfo_t* crocksdb_externalsstfileinfo_create() {
   return new crocksdb_externalsstfileinfo_t;
 };
@@ -4451,6 +6691,46 @@ uint64_t crocksdb_externalsstfileinfo_num_entries(
   return info->rep.num_entries;
 }
 
+const char* crocksdb_externalsstfileinfo_file_checksum(
+    crocksdb_externalsstfileinfo_t* info, size_t* size) {
+  *size = info->file_checksum.size();
+  return info->file_checksum.data();
+}
+
+const char* crocksdb_externalsstfileinfo_file_checksum_func_name(
+    crocksdb_externalsstfileinfo_t* info) {
+  return info->file_checksum_func_name.c_str();
+}
+
+void crocksdb_verify_file_checksum(crocksdb_env_t* env, const char* path,
+                                   int checksum_type, const char* expected,
+                                   size_t expected_len, char** errptr) {
+  if (!FileChecksum::IsValidType(checksum_type)) {
+    SaveError(errptr, Status::InvalidArgument("unknown file checksum type"));
+    return;
+  }
+  std::unique_ptr<SequentialFile> file;
+  Status s = env->rep->NewSequentialFile(path, &file, EnvOptions());
+  if (SaveError(errptr, s)) {
+    return;
+  }
+  FileChecksum checksum(checksum_type);
+  const size_t kBufferSize = 1 << 20;
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  while (true) {
+    Slice data;
+    s = file->Read(kBufferSize, &data, buffer.get());
+    if (!s.ok() || data.empty()) {
+      break;
+    }
+    checksum.Update(data.data(), data.size());
+  }
+  if (s.ok() && checksum.Value() != std::string(expected, expected_len)) {
+    s = Status::Corruption("file checksum mismatch", path);
+  }
+  SaveError(errptr, s);
+}
+
 crocksdb_ingestexternalfileoptions_t*
 crocksdb_ingestexternalfileoptions_create() {
   crocksdb_ingestexternalfileoptions_t* opt =
@@ -4492,6 +6772,16 @@ void crocksdb_ingestexternalfileoptions_set_write_global_seqno(
   opt->rep.write_global_seqno = write_global_seqno;
 }
 
+unsigned char crocksdb_ingestexternalfileoptions_get_ingest_behind(
+    const crocksdb_ingestexternalfileoptions_t* opt) {
+  return opt->rep.ingest_behind;
+}
+
+void crocksdb_ingestexternalfileoptions_set_ingest_behind(
+    crocksdb_ingestexternalfileoptions_t* opt, unsigned char ingest_behind) {
+  opt->rep.ingest_behind = ingest_behind;
+}
+
 void crocksdb_ingestexternalfileoptions_destroy(
     crocksdb_ingestexternalfileoptions_t* opt) {
   delete opt;
@@ -4556,6 +6846,108 @@ unsigned char crocksdb_ingest_external_file_optimized(
   return has_flush;
 }
 
+static std::vector<IngestExternalFileArg> BuildIngestExternalFileArgs(
+    crocksdb_column_family_handle_t** handles,
+    const char* const* const* file_lists, const size_t* list_lens,
+    const crocksdb_ingestexternalfileoptions_t* const* opts, size_t num_cfs) {
+  std::vector<IngestExternalFileArg> args(num_cfs);
+  for (size_t i = 0; i < num_cfs; i++) {
+    args[i].column_family = handles[i]->rep;
+    args[i].external_files.assign(file_lists[i], file_lists[i] + list_lens[i]);
+    args[i].options = opts[i]->rep;
+  }
+  return args;
+}
+
+void crocksdb_ingest_external_files(
+    crocksdb_t* db, crocksdb_column_family_handle_t** handles,
+    const char* const* const* file_lists, const size_t* list_lens,
+    const crocksdb_ingestexternalfileoptions_t* const* opts, size_t num_cfs,
+    char** errptr) {
+  auto args = BuildIngestExternalFileArgs(handles, file_lists, list_lens,
+                                          opts, num_cfs);
+  SaveError(errptr, db->rep->IngestExternalFiles(args));
+}
+
+// Whether the memtables of `arg.column_family` may hold a key in the range
+// of its files. Only live keys are seen in the memtables, so an overlap made
+// of deletions alone is missed; the blocking ingestion still catches it.
+static bool MemtablesOverlap(DB* db, const IngestExternalFileArg& arg) {
+  ColumnFamilyHandle* cf = arg.column_family;
+  const Comparator* cmp = cf->GetComparator();
+  Options options = db->GetOptions(cf);
+  std::string smallest, largest;
+  bool has_range = false;
+  for (auto& file : arg.external_files) {
+    SstFileReader reader(options);
+    std::unique_ptr<Iterator> iter;
+    if (reader.Open(file).ok()) {
+      iter.reset(reader.NewIterator(ReadOptions()));
+      iter->SeekToFirst();
+    }
+    if (iter == nullptr || !iter->Valid()) {
+      // Unreadable, or only range deletions: assume it overlaps.
+      return true;
+    }
+    if (!has_range || cmp->Compare(iter->key(), smallest) < 0) {
+      smallest = iter->key().ToString();
+    }
+    iter->SeekToLast();
+    if (!has_range || cmp->Compare(iter->key(), largest) > 0) {
+      largest = iter->key().ToString();
+    }
+    has_range = true;
+  }
+  if (!has_range) {
+    return false;
+  }
+  ReadOptions read_opts;
+  read_opts.read_tier = rocksdb::kMemtableTier;
+  std::unique_ptr<Iterator> iter(db->NewIterator(read_opts, cf));
+  iter->Seek(smallest);
+  return iter->Valid() && cmp->Compare(iter->key(), largest) <= 0;
+}
+
+unsigned char crocksdb_ingest_external_files_optimized(
+    crocksdb_t* db, crocksdb_column_family_handle_t** handles,
+    const char* const* const* file_lists, const size_t* list_lens,
+    const crocksdb_ingestexternalfileoptions_t* const* opts, size_t num_cfs,
+    char** errptr) {
+  auto args = BuildIngestExternalFileArgs(handles, file_lists, list_lens,
+                                          opts, num_cfs);
+  // Same as crocksdb_ingest_external_file_optimized, but only the column
+  // families whose memtables overlap their files are flushed outside the
+  // ingestion, before falling back to a blocking one.
+  bool has_flush = false;
+  for (auto& arg : args) {
+    arg.options.allow_blocking_flush = false;
+  }
+  auto s = db->rep->IngestExternalFiles(args);
+  if (s.IsInvalidArgument() &&
+      s.ToString().find("External file requires flush") != std::string::npos) {
+    has_flush = true;
+    std::vector<ColumnFamilyHandle*> cfs;
+    for (size_t i = 0; i < num_cfs; i++) {
+      args[i].options = opts[i]->rep;
+      if (MemtablesOverlap(db->rep, args[i])) {
+        cfs.push_back(args[i].column_family);
+      }
+    }
+    if (!cfs.empty()) {
+      FlushOptions flush_opts;
+      flush_opts.wait = true;
+      flush_opts.allow_write_stall = false;
+      s = db->rep->Flush(flush_opts, cfs);
+      if (SaveError(errptr, s)) {
+        return has_flush;
+      }
+    }
+    s = db->rep->IngestExternalFiles(args);
+  }
+  SaveError(errptr, s);
+  return has_flush;
+}
+
 crocksdb_slicetransform_t* crocksdb_slicetransform_create(
     void* state, void (*destructor)(void*),
     char* (*transform)(void*, const char* key, size_t length,
@@ -4729,6 +7121,21 @@ const char* crocksdb_livefiles_largestkey(const crocksdb_livefiles_t* lf,
   return lf->rep[index].largestkey.data();
 }
 
+uint64_t crocksdb_livefiles_smallest_seqno(const crocksdb_livefiles_t* lf,
+                                           int index) {
+  return lf->rep[index].smallest_seqno;
+}
+
+uint64_t crocksdb_livefiles_largest_seqno(const crocksdb_livefiles_t* lf,
+                                          int index) {
+  return lf->rep[index].largest_seqno;
+}
+
+const char* crocksdb_livefiles_column_family_name(
+    const crocksdb_livefiles_t* lf, int index) {
+  return lf->rep[index].column_family_name.c_str();
+}
+
 extern void crocksdb_livefiles_destroy(const crocksdb_livefiles_t* lf) {
   delete lf;
 }
@@ -5281,6 +7688,42 @@ int crocksdb_keyversions_type(const crocksdb_keyversions_t* kvs, int index) {
   return kvs->rep[index].type;
 }
 
+// Opens an sst file with the table options of `handle`, whether it was
+// written by SstFileWriter or by a DB.
+static Status NewTableReaderForFile(Env* env, const EnvOptions& env_options,
+                                    ColumnFamilyHandle* handle,
+                                    const std::string& file,
+                                    std::unique_ptr<TableReader>* reader) {
+  // Get External Sst File Size
+  uint64_t file_size;
+  auto status = env->GetFileSize(file, &file_size);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Open External Sst File
+  std::unique_ptr<RandomAccessFile> sst_file;
+  std::unique_ptr<RandomAccessFileReader> sst_file_reader;
+  status = env->NewRandomAccessFile(file, &sst_file, env_options);
+  if (!status.ok()) {
+    return status;
+  }
+  sst_file_reader.reset(new RandomAccessFileReader(std::move(sst_file), file));
+
+  // Get Table Reader
+  ColumnFamilyDescriptor desc;
+  handle->GetDescriptor(&desc);
+  auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(handle)->cfd();
+  auto ioptions = *cfd->ioptions();
+  auto table_opt =
+      TableReaderOptions(ioptions, desc.options.prefix_extractor.get(),
+                         env_options, cfd->internal_comparator());
+  // Get around global seqno check.
+  table_opt.largest_seqno = kMaxSequenceNumber;
+  return ioptions.table_factory->NewTableReader(
+      table_opt, std::move(sst_file_reader), file_size, reader);
+}
+
 struct ExternalSstFileModifier {
   ExternalSstFileModifier(Env* env, const EnvOptions& env_options,
                           ColumnFamilyHandle* handle)
@@ -5288,36 +7731,8 @@ struct ExternalSstFileModifier {
 
   Status Open(std::string file) {
     file_ = file;
-    // Get External Sst File Size
-    uint64_t file_size;
-    auto status = env_->GetFileSize(file_, &file_size);
-    if (!status.ok()) {
-      return status;
-    }
-
-    // Open External Sst File
-    std::unique_ptr<RandomAccessFile> sst_file;
-    std::unique_ptr<RandomAccessFileReader> sst_file_reader;
-    status = env_->NewRandomAccessFile(file_, &sst_file, env_options_);
-    if (!status.ok()) {
-      return status;
-    }
-    sst_file_reader.reset(
-        new RandomAccessFileReader(std::move(sst_file), file_));
-
-    // Get Table Reader
-    ColumnFamilyDescriptor desc;
-    handle_->GetDescriptor(&desc);
-    auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(handle_)->cfd();
-    auto ioptions = *cfd->ioptions();
-    auto table_opt =
-        TableReaderOptions(ioptions, desc.options.prefix_extractor.get(),
-                           env_options_, cfd->internal_comparator());
-    // Get around global seqno check.
-    table_opt.largest_seqno = kMaxSequenceNumber;
-    status = ioptions.table_factory->NewTableReader(
-        table_opt, std::move(sst_file_reader), file_size, &table_reader_);
-    return status;
+    return NewTableReaderForFile(env_, env_options_, handle_, file_,
+                                 &table_reader_);
   }
 
   Status SetGlobalSeqNo(uint64_t seq_no, uint64_t* pre_seq_no) {
@@ -5343,58 +7758,433 @@ struct ExternalSstFileModifier {
       return Status::Corruption(
           "External file global sequence number not found");
     }
-    *pre_seq_no = DecodeFixed64(seqno_iter->second.c_str());
-    uint64_t offset = props->properties_offsets.at(
-        ExternalSstFilePropertyNames::kGlobalSeqno);
-    if (offset == 0) {
-      return Status::Corruption("Was not able to find file global seqno field");
+    *pre_seq_no = DecodeFixed64(seqno_iter->second.c_str());
+    uint64_t offset = props->properties_offsets.at(
+        ExternalSstFilePropertyNames::kGlobalSeqno);
+    if (offset == 0) {
+      return Status::Corruption("Was not able to find file global seqno field");
+    }
+
+    if (*pre_seq_no == seq_no) {
+      // This file already have the correct global seqno
+      return Status::OK();
+    }
+
+    std::unique_ptr<RandomRWFile> rwfile;
+    auto status = env_->NewRandomRWFile(file_, &rwfile, env_options_);
+    if (!status.ok()) {
+      return status;
+    }
+
+    // Write the new seqno in the global sequence number field in the file
+    std::string seqno_val;
+    PutFixed64(&seqno_val, seq_no);
+    status = rwfile->Write(offset, seqno_val);
+    return status;
+  }
+
+ private:
+  Env* env_;
+  EnvOptions env_options_;
+  ColumnFamilyHandle* handle_;
+  std::string file_;
+  std::unique_ptr<TableReader> table_reader_;
+};
+
+// !!! this function is dangerous because it uses rocksdb's non-public API !!!
+// find the offset of external sst file's `global seq no` and modify it.
+uint64_t crocksdb_set_external_sst_file_global_seq_no(
+    crocksdb_t* db, crocksdb_column_family_handle_t* column_family,
+    const char* file, uint64_t seq_no, char** errptr) {
+  auto env = db->rep->GetEnv();
+  EnvOptions env_options(db->rep->GetDBOptions());
+  ExternalSstFileModifier modifier(env, env_options, column_family->rep);
+  auto s = modifier.Open(std::string(file));
+  uint64_t pre_seq_no = 0;
+  if (!s.ok()) {
+    SaveError(errptr, s);
+    return pre_seq_no;
+  }
+  s = modifier.SetGlobalSeqNo(seq_no, &pre_seq_no);
+  if (!s.ok()) {
+    SaveError(errptr, s);
+  }
+  return pre_seq_no;
+}
+
+// Same as crocksdb_set_external_sst_file_global_seq_no for many files, with
+// up to `num_threads` files opened and rewritten at a time.
+void crocksdb_set_external_sst_files_global_seq_no(
+    crocksdb_t* db, crocksdb_column_family_handle_t* column_family,
+    const char* const* files, const uint64_t* seq_nos, size_t num_files,
+    int num_threads, uint64_t* pre_seq_nos, char** errptr) {
+  auto env = db->rep->GetEnv();
+  EnvOptions env_options(db->rep->GetDBOptions());
+  std::atomic<size_t> next_file(0);
+  std::mutex mutex;
+  Status status;
+  auto work = [&]() {
+    size_t i;
+    while ((i = next_file.fetch_add(1)) < num_files) {
+      ExternalSstFileModifier modifier(env, env_options, column_family->rep);
+      pre_seq_nos[i] = 0;
+      auto s = modifier.Open(std::string(files[i]));
+      if (s.ok()) {
+        s = modifier.SetGlobalSeqNo(seq_nos[i], &pre_seq_nos[i]);
+      }
+      if (!s.ok()) {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (status.ok()) {
+          status = s;
+        }
+      }
+    }
+  };
+  size_t num_workers =
+      std::min(static_cast<size_t>(std::max(num_threads, 1)), num_files);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < num_workers; i++) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  SaveError(errptr, status);
+}
+
+struct crocksdb_export_import_files_metadata_t {
+  std::string dir;
+  std::vector<LiveFileMetaData> files;
+};
+
+static std::string ExportedFilePath(const std::string& dir,
+                                    const std::string& name) {
+  if (!name.empty() && name[0] == '/') {
+    return dir + name;
+  }
+  return dir + "/" + name;
+}
+
+// Hard-links (or copies, if linking is not supported) the live sst files of
+// `column_family` into `export_dir`, which must not exist yet. The memtable
+// is flushed first so that the exported files hold all of the column
+// family's data.
+crocksdb_export_import_files_metadata_t* crocksdb_export_column_family(
+    crocksdb_t* db, crocksdb_column_family_handle_t* column_family,
+    const char* export_dir, char** errptr) {
+  auto env = db->rep->GetEnv();
+  std::string dir(export_dir);
+  Status s = env->FileExists(dir);
+  if (s.ok()) {
+    SaveError(errptr, Status::InvalidArgument("Export dir exists", dir));
+    return nullptr;
+  } else if (!s.IsNotFound()) {
+    SaveError(errptr, s);
+    return nullptr;
+  }
+  s = db->rep->Flush(FlushOptions(), column_family->rep);
+  if (SaveError(errptr, s)) {
+    return nullptr;
+  }
+  s = env->CreateDir(dir);
+  if (SaveError(errptr, s)) {
+    return nullptr;
+  }
+  s = db->rep->DisableFileDeletions();
+  if (SaveError(errptr, s)) {
+    env->DeleteDir(dir);
+    return nullptr;
+  }
+  auto metadata = new crocksdb_export_import_files_metadata_t;
+  metadata->dir = dir;
+  std::vector<LiveFileMetaData> live_files;
+  db->rep->GetLiveFilesMetaData(&live_files);
+  for (auto& file : live_files) {
+    if (file.column_family_name != column_family->rep->GetName()) {
+      continue;
+    }
+    std::string src = ExportedFilePath(file.db_path, file.name);
+    std::string dst = ExportedFilePath(dir, file.name);
+    s = env->LinkFile(src, dst);
+    if (s.IsNotSupported()) {
+      s = rocksdb::CopyFile(env, src, dst, 0 /* size */, true /* use_fsync */);
+    }
+    if (!s.ok()) {
+      break;
+    }
+    file.db_path = dir;
+    metadata->files.push_back(file);
+  }
+  db->rep->EnableFileDeletions(false /* force */);
+  if (!s.ok()) {
+    for (auto& file : metadata->files) {
+      env->DeleteFile(ExportedFilePath(dir, file.name));
+    }
+    env->DeleteDir(dir);
+    delete metadata;
+    SaveError(errptr, s);
+    return nullptr;
+  }
+  return metadata;
+}
+
+crocksdb_export_import_files_metadata_t*
+crocksdb_export_import_files_metadata_create(const char* dir) {
+  auto metadata = new crocksdb_export_import_files_metadata_t;
+  metadata->dir = dir;
+  return metadata;
+}
+
+void crocksdb_export_import_files_metadata_destroy(
+    crocksdb_export_import_files_metadata_t* metadata) {
+  delete metadata;
+}
+
+void crocksdb_export_import_files_metadata_add_file(
+    crocksdb_export_import_files_metadata_t* metadata, const char* name,
+    int level, uint64_t smallest_seqno, uint64_t largest_seqno) {
+  LiveFileMetaData file;
+  file.name = name;
+  file.db_path = metadata->dir;
+  file.level = level;
+  file.smallest_seqno = smallest_seqno;
+  file.largest_seqno = largest_seqno;
+  metadata->files.push_back(file);
+}
+
+const char* crocksdb_export_import_files_metadata_dir(
+    const crocksdb_export_import_files_metadata_t* metadata) {
+  return metadata->dir.c_str();
+}
+
+size_t crocksdb_export_import_files_metadata_count(
+    const crocksdb_export_import_files_metadata_t* metadata) {
+  return metadata->files.size();
+}
+
+const char* crocksdb_export_import_files_metadata_name(
+    const crocksdb_export_import_files_metadata_t* metadata, size_t index) {
+  return metadata->files[index].name.c_str();
+}
+
+int crocksdb_export_import_files_metadata_level(
+    const crocksdb_export_import_files_metadata_t* metadata, size_t index) {
+  return metadata->files[index].level;
+}
+
+size_t crocksdb_export_import_files_metadata_size(
+    const crocksdb_export_import_files_metadata_t* metadata, size_t index) {
+  return metadata->files[index].size;
+}
+
+const char* crocksdb_export_import_files_metadata_smallestkey(
+    const crocksdb_export_import_files_metadata_t* metadata, size_t index,
+    size_t* len) {
+  *len = metadata->files[index].smallestkey.size();
+  return metadata->files[index].smallestkey.data();
+}
+
+const char* crocksdb_export_import_files_metadata_largestkey(
+    const crocksdb_export_import_files_metadata_t* metadata, size_t index,
+    size_t* len) {
+  *len = metadata->files[index].largestkey.size();
+  return metadata->files[index].largestkey.data();
+}
+
+uint64_t crocksdb_export_import_files_metadata_smallest_seqno(
+    const crocksdb_export_import_files_metadata_t* metadata, size_t index) {
+  return metadata->files[index].smallest_seqno;
+}
+
+uint64_t crocksdb_export_import_files_metadata_largest_seqno(
+    const crocksdb_export_import_files_metadata_t* metadata, size_t index) {
+  return metadata->files[index].largest_seqno;
+}
+
+// Rewrites the newest visible version of every key in the sst file `src`,
+// which was written by a DB, into the external sst file `dst`. Range
+// tombstones are kept as is. `*num_entries` is set to 0 if nothing is left.
+static Status RewriteExportedFile(Env* env, const EnvOptions& env_options,
+                                  const Options& options,
+                                  ColumnFamilyHandle* handle,
+                                  const std::string& src,
+                                  const std::string& dst,
+                                  uint64_t* num_entries) {
+  std::unique_ptr<TableReader> reader;
+  Status s = NewTableReaderForFile(env, env_options, handle, src, &reader);
+  if (!s.ok()) {
+    return s;
+  }
+  auto ucmp = options.comparator;
+
+  struct Tombstone {
+    std::string start;
+    std::string end;
+    SequenceNumber seq;
+  };
+  std::vector<Tombstone> tombstones;
+  std::unique_ptr<rocksdb::FragmentedRangeTombstoneIterator> range_del_iter(
+      reader->NewRangeTombstoneIterator(ReadOptions()));
+  if (range_del_iter != nullptr) {
+    // Fragments come sorted and non-overlapping, newest sequence first.
+    for (range_del_iter->SeekToFirst(); range_del_iter->Valid();
+         range_del_iter->Next()) {
+      if (!tombstones.empty() &&
+          ucmp->Compare(tombstones.back().start,
+                        range_del_iter->start_key()) == 0 &&
+          ucmp->Compare(tombstones.back().end, range_del_iter->end_key()) ==
+              0) {
+        continue;
+      }
+      tombstones.push_back({range_del_iter->start_key().ToString(),
+                            range_del_iter->end_key().ToString(),
+                            range_del_iter->seq()});
+    }
+  }
+
+  SstFileWriter writer(env_options, options, handle);
+  s = writer.Open(dst);
+  if (!s.ok()) {
+    return s;
+  }
+  std::unique_ptr<rocksdb::InternalIterator> iter(
+      reader->NewIterator(ReadOptions(), options.prefix_extractor.get(),
+                          nullptr /* arena */, false /* skip_filters */,
+                          rocksdb::TableReaderCaller::kExternalSSTIngestion));
+  std::string last_user_key;
+  bool has_last = false;
+  bool last_is_merge = false;
+  size_t tombstone_idx = 0;
+  *num_entries = 0;
+  for (iter->SeekToFirst(); s.ok() && iter->Valid(); iter->Next()) {
+    rocksdb::ParsedInternalKey ikey;
+    if (!rocksdb::ParseInternalKey(iter->key(), &ikey)) {
+      s = Status::Corruption("Corrupted internal key in", src);
+      break;
+    }
+    if (has_last && ucmp->Compare(ikey.user_key, last_user_key) == 0) {
+      // Only the newest version is kept, which a merge operand can't be
+      // reduced to without the operands below it.
+      if (last_is_merge) {
+        s = Status::NotSupported("Importing merge operands over", src);
+      }
+      continue;
+    }
+    last_user_key.assign(ikey.user_key.data(), ikey.user_key.size());
+    has_last = true;
+    last_is_merge = false;
+    while (tombstone_idx < tombstones.size() &&
+           ucmp->Compare(tombstones[tombstone_idx].end, ikey.user_key) <= 0) {
+      tombstone_idx++;
     }
-
-    if (*pre_seq_no == seq_no) {
-      // This file already have the correct global seqno
-      return Status::OK();
+    if (tombstone_idx < tombstones.size() &&
+        ucmp->Compare(tombstones[tombstone_idx].start, ikey.user_key) <= 0 &&
+        tombstones[tombstone_idx].seq > ikey.sequence) {
+      // Covered by a newer range tombstone written below.
+      continue;
     }
-
-    std::unique_ptr<RandomRWFile> rwfile;
-    auto status = env_->NewRandomRWFile(file_, &rwfile, env_options_);
-    if (!status.ok()) {
-      return status;
+    switch (ikey.type) {
+      case rocksdb::kTypeValue:
+        s = writer.Put(ikey.user_key, iter->value());
+        break;
+      case rocksdb::kTypeMerge:
+        last_is_merge = true;
+        s = writer.Merge(ikey.user_key, iter->value());
+        break;
+      case rocksdb::kTypeDeletion:
+      case rocksdb::kTypeSingleDeletion:
+        s = writer.Delete(ikey.user_key);
+        break;
+      default:
+        s = Status::NotSupported("Importing unsupported value type in", src);
+        break;
     }
-
-    // Write the new seqno in the global sequence number field in the file
-    std::string seqno_val;
-    PutFixed64(&seqno_val, seq_no);
-    status = rwfile->Write(offset, seqno_val);
-    return status;
+    (*num_entries)++;
   }
+  if (s.ok()) {
+    s = iter->status();
+  }
+  for (size_t i = 0; s.ok() && i < tombstones.size(); i++) {
+    s = writer.DeleteRange(tombstones[i].start, tombstones[i].end);
+    (*num_entries)++;
+  }
+  if (s.ok() && *num_entries > 0) {
+    s = writer.Finish();
+  }
+  if (!s.ok() || *num_entries == 0) {
+    env->DeleteFile(dst);
+  }
+  return s;
+}
 
- private:
-  Env* env_;
-  EnvOptions env_options_;
-  ColumnFamilyHandle* handle_;
-  std::string file_;
-  std::unique_ptr<TableReader> table_reader_;
-};
-
-// !!! this function is dangerous because it uses rocksdb's non-public API !!!
-// find the offset of external sst file's `global seq no` and modify it.
-uint64_t crocksdb_set_external_sst_file_global_seq_no(
-    crocksdb_t* db, crocksdb_column_family_handle_t* column_family,
-    const char* file, uint64_t seq_no, char** errptr) {
+// Creates the column family `column_family_name` and fills it with the files
+// described by `metadata`. As 6.4 has no way to install foreign sst files
+// directly, every file is rewritten into an external sst file and ingested
+// with `move_files`, bottommost level first, so that the rewritten files end
+// up roughly in the levels they were exported from.
+crocksdb_column_family_handle_t* crocksdb_create_column_family_with_import(
+    crocksdb_t* db, const crocksdb_options_t* column_family_options,
+    const char* column_family_name,
+    const crocksdb_export_import_files_metadata_t* metadata, char** errptr) {
+  ColumnFamilyHandle* handle = nullptr;
+  Status s = db->rep->CreateColumnFamily(
+      ColumnFamilyOptions(column_family_options->rep),
+      std::string(column_family_name), &handle);
+  if (SaveError(errptr, s)) {
+    return nullptr;
+  }
   auto env = db->rep->GetEnv();
   EnvOptions env_options(db->rep->GetDBOptions());
-  ExternalSstFileModifier modifier(env, env_options, column_family->rep);
-  auto s = modifier.Open(std::string(file));
-  uint64_t pre_seq_no = 0;
-  if (!s.ok()) {
-    SaveError(errptr, s);
-    return pre_seq_no;
+  Options options = db->rep->GetOptions(handle);
+
+  std::vector<const LiveFileMetaData*> files;
+  for (auto& file : metadata->files) {
+    files.push_back(&file);
+  }
+  std::sort(files.begin(), files.end(),
+            [](const LiveFileMetaData* a, const LiveFileMetaData* b) {
+              if (a->level != b->level) {
+                return a->level > b->level;
+              }
+              return a->largest_seqno < b->largest_seqno;
+            });
+
+  IngestExternalFileOptions ingest_options;
+  ingest_options.move_files = true;
+  std::vector<std::string> batch;
+  for (size_t i = 0; s.ok() && i < files.size(); i++) {
+    std::string src = ExportedFilePath(metadata->dir, files[i]->name);
+    std::string dst = src + ".import";
+    uint64_t num_entries = 0;
+    s = RewriteExportedFile(env, env_options, options, handle, src, dst,
+                            &num_entries);
+    if (s.ok() && num_entries > 0) {
+      batch.push_back(dst);
+    }
+    // Files of a non-zero level don't overlap and go in together, while
+    // level 0 files are ingested one by one, oldest first.
+    bool last_of_batch = files[i]->level == 0 || i + 1 == files.size() ||
+                         files[i + 1]->level != files[i]->level;
+    if (s.ok() && last_of_batch && !batch.empty()) {
+      s = db->rep->IngestExternalFile(handle, batch, ingest_options);
+      if (s.ok()) {
+        batch.clear();
+      }
+    }
   }
-  s = modifier.SetGlobalSeqNo(seq_no, &pre_seq_no);
   if (!s.ok()) {
+    for (auto& file : batch) {
+      env->DeleteFile(file);
+    }
+    db->rep->DropColumnFamily(handle);
+    delete handle;
     SaveError(errptr, s);
+    return nullptr;
   }
-  return pre_seq_no;
+  crocksdb_column_family_handle_t* result = new crocksdb_column_family_handle_t;
+  result->rep = handle;
+  return result;
 }
 
 void crocksdb_get_column_family_meta_data(
@@ -6202,6 +8992,654 @@ crocksdb_sst_partitioner_t* crocksdb_sst_partitioner_factory_create_partitioner(
   return partitioner;
 }
 
+/* Block cache warm-up */
+
+// Hot keys sampled from the query trace of a DB. Keys are kept in LRU order
+// so a long recording follows the working set, and the hottest keys are
+// loaded first on warm-up.
+class BlockCacheHotKeys {
+ public:
+  enum OpType : unsigned char { kGet = 0, kSeek = 1 };
+
+  explicit BlockCacheHotKeys(size_t max_keys) : max_keys_(max_keys) {}
+
+  void Record(OpType op, uint32_t cf_id, const Slice& key) {
+    std::string id;
+    id.push_back(op);
+    rocksdb::PutVarint32(&id, cf_id);
+    rocksdb::PutLengthPrefixedSlice(&id, key);
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = index_.find(id);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return;
+    }
+    lru_.push_front(id);
+    index_.emplace(std::move(id), lru_.begin());
+    if (lru_.size() > max_keys_) {
+      index_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+  size_t Count() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return lru_.size();
+  }
+
+  // File layout: magic, key count, then one `op, varint32 cf id,
+  // length-prefixed key` entry per key, hottest first.
+  Status Save(const std::string& path) {
+    std::string data;
+    PutFixed64(&data, kMagic);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      rocksdb::PutVarint64(&data, lru_.size());
+      for (auto& id : lru_) {
+        data.append(id);
+      }
+    }
+    Env* env = Env::Default();
+    std::string tmp_path = path + ".tmp";
+    Status s = rocksdb::WriteStringToFile(env, data, tmp_path,
+                                          true /* should_sync */);
+    if (s.ok()) {
+      s = env->RenameFile(tmp_path, path);
+    }
+    return s;
+  }
+
+  struct Entry {
+    OpType op;
+    uint32_t cf_id;
+    std::string key;
+  };
+
+  static Status Load(const std::string& path, std::vector<Entry>* entries) {
+    std::string data;
+    Status s = rocksdb::ReadFileToString(Env::Default(), path, &data);
+    if (!s.ok()) {
+      return s;
+    }
+    Slice input(data);
+    uint64_t magic = 0;
+    uint64_t count = 0;
+    if (!rocksdb::GetFixed64(&input, &magic) || magic != kMagic ||
+        !rocksdb::GetVarint64(&input, &count)) {
+      return Status::Corruption("bad block cache hot key file", path);
+    }
+    entries->reserve(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; i++) {
+      Entry entry;
+      Slice key;
+      if (input.empty() || static_cast<unsigned char>(input[0]) > kSeek) {
+        return Status::Corruption("bad block cache hot key entry", path);
+      }
+      entry.op = static_cast<OpType>(input[0]);
+      input.remove_prefix(1);
+      if (!rocksdb::GetVarint32(&input, &entry.cf_id) ||
+          !rocksdb::GetLengthPrefixedSlice(&input, &key)) {
+        return Status::Corruption("bad block cache hot key entry", path);
+      }
+      entry.key = key.ToString();
+      entries->push_back(std::move(entry));
+    }
+    return Status::OK();
+  }
+
+ private:
+  static const uint64_t kMagic = 0x6b636f6c62746f68ull;  // "hotblock"
+
+  const size_t max_keys_;
+  std::mutex mutex_;
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, std::list<std::string>::iterator> index_;
+};
+
+// Feeds point lookups and seeks of the DB's query trace into the hot key set.
+// Nothing is written to disk while tracing.
+class BlockCacheHotKeysTraceWriter : public TraceWriter {
+ public:
+  explicit BlockCacheHotKeysTraceWriter(shared_ptr<BlockCacheHotKeys> keys)
+      : keys_(keys) {}
+
+  Status Write(const Slice& data) override {
+    // The record layout is defined by TracerHelper::EncodeTrace.
+    if (data.size() < rocksdb::kTraceMetadataSize) {
+      return Status::OK();
+    }
+    BlockCacheHotKeys::OpType op;
+    switch (static_cast<unsigned char>(data[rocksdb::kTraceTimestampSize])) {
+      case rocksdb::kTraceGet:
+        op = BlockCacheHotKeys::kGet;
+        break;
+      case rocksdb::kTraceIteratorSeek:
+      case rocksdb::kTraceIteratorSeekForPrev:
+        op = BlockCacheHotKeys::kSeek;
+        break;
+      default:
+        return Status::OK();
+    }
+    Slice payload(data.data() + rocksdb::kTraceMetadataSize,
+                  data.size() - rocksdb::kTraceMetadataSize);
+    uint32_t cf_id = 0;
+    Slice key;
+    if (rocksdb::GetFixed32(&payload, &cf_id) &&
+        rocksdb::GetLengthPrefixedSlice(&payload, &key)) {
+      keys_->Record(op, cf_id, key);
+    }
+    return Status::OK();
+  }
+
+  Status Close() override { return Status::OK(); }
+
+  uint64_t GetFileSize() override { return 0; }
+
+ private:
+  shared_ptr<BlockCacheHotKeys> keys_;
+};
+
+struct crocksdb_block_cache_recorder_t {
+  shared_ptr<BlockCacheHotKeys> rep;
+};
+
+crocksdb_block_cache_recorder_t* crocksdb_block_cache_recorder_create(
+    size_t max_keys) {
+  crocksdb_block_cache_recorder_t* recorder =
+      new crocksdb_block_cache_recorder_t;
+  recorder->rep = std::make_shared<BlockCacheHotKeys>(max_keys);
+  return recorder;
+}
+
+void crocksdb_block_cache_recorder_destroy(
+    crocksdb_block_cache_recorder_t* recorder) {
+  delete recorder;
+}
+
+size_t crocksdb_block_cache_recorder_count(
+    crocksdb_block_cache_recorder_t* recorder) {
+  return recorder->rep->Count();
+}
+
+void crocksdb_block_cache_recorder_save(
+    crocksdb_block_cache_recorder_t* recorder, const char* path,
+    char** errptr) {
+  SaveError(errptr, recorder->rep->Save(std::string(path)));
+}
+
+static Status StartDBTrace(crocksdb_t* db, TraceState::Kind kind,
+                           const rocksdb::TraceOptions& trace_options,
+                           std::unique_ptr<TraceWriter>&& writer) {
+  TraceState& state = db->trace_state;
+  std::lock_guard<std::mutex> guard(state.mutex);
+  if (state.running != TraceState::kNone) {
+    return Status::Busy("another trace is running on the DB");
+  }
+  Status s = db->rep->StartTrace(trace_options, std::move(writer));
+  if (s.ok()) {
+    state.running = kind;
+  }
+  return s;
+}
+
+static Status EndDBTrace(crocksdb_t* db, TraceState::Kind kind) {
+  TraceState& state = db->trace_state;
+  std::lock_guard<std::mutex> guard(state.mutex);
+  if (state.running != kind) {
+    return Status::InvalidArgument("the trace to end is not running");
+  }
+  state.running = TraceState::kNone;
+  return db->rep->EndTrace();
+}
+
+void crocksdb_start_block_cache_recording(
+    crocksdb_t* db, crocksdb_block_cache_recorder_t* recorder,
+    uint64_t sampling_frequency, char** errptr) {
+  rocksdb::TraceOptions trace_options;
+  trace_options.sampling_frequency = sampling_frequency;
+  std::unique_ptr<TraceWriter> writer(
+      new BlockCacheHotKeysTraceWriter(recorder->rep));
+  SaveError(errptr, StartDBTrace(db, TraceState::kBlockCacheRecording,
+                                 trace_options, std::move(writer)));
+}
+
+void crocksdb_end_block_cache_recording(crocksdb_t* db, char** errptr) {
+  SaveError(errptr, EndDBTrace(db, TraceState::kBlockCacheRecording));
+}
+
+struct crocksdb_block_cache_warmer_t {
+  std::thread thread;
+  std::atomic<bool> stop{false};
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> keys_total{0};
+  std::atomic<uint64_t> keys_loaded{0};
+  std::atomic<uint64_t> bytes_loaded{0};
+
+  void Run(DB* db, std::vector<BlockCacheHotKeys::Entry> entries,
+           std::unordered_map<uint32_t, ColumnFamilyHandle*> cfs,
+           shared_ptr<RateLimiter> limiter) {
+    ReadOptions read_options;
+    read_options.fill_cache = true;
+    IOStatsContext* iostats = rocksdb::get_iostats_context();
+    PinnableSlice value;
+    for (auto& entry : entries) {
+      if (stop.load(std::memory_order_relaxed)) {
+        break;
+      }
+      auto cf = cfs.find(entry.cf_id);
+      if (cf == cfs.end()) {
+        keys_loaded.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      uint64_t bytes_before = iostats->bytes_read;
+      if (entry.op == BlockCacheHotKeys::kGet) {
+        value.Reset();
+        db->Get(read_options, cf->second, entry.key, &value);
+      } else {
+        std::unique_ptr<Iterator> iter(
+            db->NewIterator(read_options, cf->second));
+        iter->Seek(entry.key);
+      }
+      int64_t bytes = static_cast<int64_t>(iostats->bytes_read - bytes_before);
+      // The size of a load is only known once it is done, so it is charged
+      // afterwards. That still bounds the average rate.
+      if (limiter) {
+        int64_t burst = limiter->GetSingleBurstBytes();
+        for (int64_t left = bytes; left > 0; left -= burst) {
+          limiter->Request(std::min(left, burst), Env::IO_LOW, nullptr);
+        }
+      }
+      bytes_loaded.fetch_add(bytes, std::memory_order_relaxed);
+      keys_loaded.fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+  }
+};
+
+crocksdb_block_cache_warmer_t* crocksdb_block_cache_warmup_start(
+    crocksdb_t* db, crocksdb_column_family_handle_t** column_families,
+    size_t num_column_families, const char* path,
+    crocksdb_ratelimiter_t* limiter, char** errptr) {
+  std::vector<BlockCacheHotKeys::Entry> entries;
+  Status s = BlockCacheHotKeys::Load(std::string(path), &entries);
+  if (SaveError(errptr, s)) {
+    return nullptr;
+  }
+  std::unordered_map<uint32_t, ColumnFamilyHandle*> cfs;
+  for (size_t i = 0; i < num_column_families; i++) {
+    cfs[column_families[i]->rep->GetID()] = column_families[i]->rep;
+  }
+  shared_ptr<RateLimiter> rate_limiter;
+  if (limiter != nullptr) {
+    rate_limiter = limiter->rep;
+  }
+  crocksdb_block_cache_warmer_t* warmer = new crocksdb_block_cache_warmer_t;
+  warmer->keys_total = entries.size();
+  warmer->thread = std::thread(&crocksdb_block_cache_warmer_t::Run, warmer,
+                               db->rep, std::move(entries), std::move(cfs),
+                               rate_limiter);
+  return warmer;
+}
+
+void crocksdb_block_cache_warmer_destroy(
+    crocksdb_block_cache_warmer_t* warmer) {
+  warmer->stop = true;
+  warmer->thread.join();
+  delete warmer;
+}
+
+unsigned char crocksdb_block_cache_warmer_is_done(
+    crocksdb_block_cache_warmer_t* warmer) {
+  return warmer->done.load(std::memory_order_acquire);
+}
+
+uint64_t crocksdb_block_cache_warmer_keys_total(
+    crocksdb_block_cache_warmer_t* warmer) {
+  return warmer->keys_total.load(std::memory_order_relaxed);
+}
+
+uint64_t crocksdb_block_cache_warmer_keys_loaded(
+    crocksdb_block_cache_warmer_t* warmer) {
+  return warmer->keys_loaded.load(std::memory_order_relaxed);
+}
+
+uint64_t crocksdb_block_cache_warmer_bytes_loaded(
+    crocksdb_block_cache_warmer_t* warmer) {
+  return warmer->bytes_loaded.load(std::memory_order_relaxed);
+}
+
+/* Block cache trace */
+
+void crocksdb_start_block_cache_trace(crocksdb_t* db, const char* trace_path,
+                                      uint64_t sampling_frequency,
+                                      uint64_t max_trace_file_size,
+                                      char** errptr) {
+  rocksdb::TraceOptions trace_options;
+  trace_options.sampling_frequency = sampling_frequency;
+  trace_options.max_trace_file_size = max_trace_file_size;
+  std::unique_ptr<TraceWriter> writer;
+  Status s = rocksdb::NewFileTraceWriter(db->rep->GetEnv(), EnvOptions(),
+                                         std::string(trace_path), &writer);
+  if (SaveError(errptr, s)) {
+    return;
+  }
+  SaveError(errptr,
+            db->rep->StartBlockCacheTrace(trace_options, std::move(writer)));
+}
+
+void crocksdb_end_block_cache_trace(crocksdb_t* db, char** errptr) {
+  SaveError(errptr, db->rep->EndBlockCacheTrace());
+}
+
+// Replays the accesses of a block cache trace against caches of different
+// types and sizes. A block is inserted on miss unless the traced access
+// skipped the insertion, the same as the real block cache.
+struct crocksdb_block_cache_simulator_t {
+  std::vector<shared_ptr<Cache>> caches;
+  std::vector<uint64_t> misses;
+  uint64_t accesses = 0;
+};
+
+crocksdb_block_cache_simulator_t* crocksdb_block_cache_simulator_create() {
+  return new crocksdb_block_cache_simulator_t;
+}
+
+void crocksdb_block_cache_simulator_destroy(
+    crocksdb_block_cache_simulator_t* simulator) {
+  delete simulator;
+}
+
+void crocksdb_block_cache_simulator_add_lru_cache(
+    crocksdb_block_cache_simulator_t* simulator, size_t capacity,
+    int num_shard_bits) {
+  simulator->caches.push_back(NewLRUCache(capacity, num_shard_bits));
+  simulator->misses.push_back(0);
+}
+
+void crocksdb_block_cache_simulator_add_clock_cache(
+    crocksdb_block_cache_simulator_t* simulator, size_t capacity,
+    int num_shard_bits, char** errptr) {
+  shared_ptr<Cache> cache = rocksdb::NewClockCache(capacity, num_shard_bits);
+  if (cache == nullptr) {
+    SaveError(errptr, Status::NotSupported("clock cache is not supported"));
+    return;
+  }
+  simulator->caches.push_back(cache);
+  simulator->misses.push_back(0);
+}
+
+void crocksdb_block_cache_simulator_run(
+    crocksdb_block_cache_simulator_t* simulator, const char* trace_path,
+    char** errptr) {
+  std::unique_ptr<TraceReader> trace_reader;
+  Status s = rocksdb::NewFileTraceReader(Env::Default(), EnvOptions(),
+                                         std::string(trace_path),
+                                         &trace_reader);
+  if (SaveError(errptr, s)) {
+    return;
+  }
+  rocksdb::BlockCacheTraceReader reader(std::move(trace_reader));
+  rocksdb::BlockCacheTraceHeader header;
+  s = reader.ReadHeader(&header);
+  if (SaveError(errptr, s)) {
+    return;
+  }
+  rocksdb::BlockCacheTraceRecord access;
+  while (true) {
+    s = reader.ReadAccess(&access);
+    if (s.IsIncomplete()) {
+      // End of the trace.
+      break;
+    }
+    if (SaveError(errptr, s)) {
+      return;
+    }
+    simulator->accesses++;
+    for (size_t i = 0; i < simulator->caches.size(); i++) {
+      Cache* cache = simulator->caches[i].get();
+      Cache::Handle* handle = cache->Lookup(access.block_key);
+      if (handle != nullptr) {
+        cache->Release(handle);
+        continue;
+      }
+      simulator->misses[i]++;
+      if (access.no_insert == rocksdb::Boolean::kFalse) {
+        cache->Insert(access.block_key, nullptr, access.block_size, nullptr);
+      }
+    }
+  }
+}
+
+uint64_t crocksdb_block_cache_simulator_num_accesses(
+    crocksdb_block_cache_simulator_t* simulator) {
+  return simulator->accesses;
+}
+
+uint64_t crocksdb_block_cache_simulator_num_misses(
+    crocksdb_block_cache_simulator_t* simulator, size_t index) {
+  return simulator->misses[index];
+}
+
+/* Query trace */
+
+void crocksdb_start_trace(crocksdb_t* db, const char* trace_path,
+                          uint64_t sampling_frequency,
+                          uint64_t max_trace_file_size, char** errptr) {
+  rocksdb::TraceOptions trace_options;
+  trace_options.sampling_frequency = sampling_frequency;
+  trace_options.max_trace_file_size = max_trace_file_size;
+  std::unique_ptr<TraceWriter> writer;
+  Status s = rocksdb::NewFileTraceWriter(db->rep->GetEnv(), EnvOptions(),
+                                         std::string(trace_path), &writer);
+  if (SaveError(errptr, s)) {
+    return;
+  }
+  SaveError(errptr, StartDBTrace(db, TraceState::kQueryTrace, trace_options,
+                                 std::move(writer)));
+}
+
+void crocksdb_end_trace(crocksdb_t* db, char** errptr) {
+  SaveError(errptr, EndDBTrace(db, TraceState::kQueryTrace));
+}
+
+// Replays a query trace against a DB, optionally from several threads and
+// at a speed relative to the original timing, and records the latency of
+// every operation by type.
+struct crocksdb_trace_replayer_t {
+  enum OpType { kGet = 0, kSeek = 1, kWrite = 2, kNumOpTypes = 3 };
+
+  DB* db;
+  std::unordered_map<uint32_t, ColumnFamilyHandle*> cfs;
+  std::unique_ptr<TraceReader> reader;
+  double speed = 1.0;
+  int num_threads = 1;
+  std::mutex histogram_mutex;
+  rocksdb::HistogramImpl histograms[kNumOpTypes];
+
+  // Blocks the dispatcher while too many operations are queued, so a fast
+  // replay doesn't buffer the whole trace in memory.
+  std::mutex mutex;
+  std::condition_variable cv;
+  int pending = 0;
+
+  void Execute(const rocksdb::Trace& trace) {
+    Env* env = db->GetEnv();
+    uint64_t start = env->NowMicros();
+    OpType op;
+    if (trace.type == rocksdb::kTraceWrite) {
+      WriteBatch batch(trace.payload);
+      db->Write(WriteOptions(), &batch);
+      op = kWrite;
+    } else {
+      Slice payload(trace.payload);
+      uint32_t cf_id = 0;
+      Slice key;
+      if (!rocksdb::GetFixed32(&payload, &cf_id) ||
+          !rocksdb::GetLengthPrefixedSlice(&payload, &key)) {
+        return;
+      }
+      auto cf = cfs.find(cf_id);
+      if (cf == cfs.end()) {
+        return;
+      }
+      if (trace.type == rocksdb::kTraceGet) {
+        PinnableSlice value;
+        db->Get(ReadOptions(), cf->second, key, &value);
+        op = kGet;
+      } else {
+        std::unique_ptr<Iterator> iter(
+            db->NewIterator(ReadOptions(), cf->second));
+        if (trace.type == rocksdb::kTraceIteratorSeek) {
+          iter->Seek(key);
+        } else {
+          iter->SeekForPrev(key);
+        }
+        op = kSeek;
+      }
+    }
+    uint64_t latency = env->NowMicros() - start;
+    std::lock_guard<std::mutex> guard(histogram_mutex);
+    histograms[op].Add(latency);
+  }
+
+  Status Replay() {
+    std::string encoded;
+    rocksdb::Trace header;
+    Status s = reader->Read(&encoded);
+    if (s.ok()) {
+      s = rocksdb::TracerHelper::DecodeTrace(encoded, &header);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+    if (header.type != rocksdb::kTraceBegin) {
+      return Status::Corruption("trace doesn't start with a header");
+    }
+
+    std::unique_ptr<rocksdb::ThreadPool> pool;
+    if (num_threads > 1) {
+      pool.reset(rocksdb::NewThreadPool(num_threads));
+    }
+    Env* env = db->GetEnv();
+    uint64_t replay_start = env->NowMicros();
+    while (true) {
+      rocksdb::Trace trace;
+      s = reader->Read(&encoded);
+      if (s.ok()) {
+        s = rocksdb::TracerHelper::DecodeTrace(encoded, &trace);
+      }
+      if (!s.ok() || trace.type == rocksdb::kTraceEnd) {
+        break;
+      }
+      if (trace.type != rocksdb::kTraceWrite &&
+          trace.type != rocksdb::kTraceGet &&
+          trace.type != rocksdb::kTraceIteratorSeek &&
+          trace.type != rocksdb::kTraceIteratorSeekForPrev) {
+        continue;
+      }
+      if (speed > 0 && trace.ts > header.ts) {
+        uint64_t due = replay_start + static_cast<uint64_t>(
+                                          (trace.ts - header.ts) / speed);
+        uint64_t now = env->NowMicros();
+        if (due > now) {
+          env->SleepForMicroseconds(static_cast<int>(std::min<uint64_t>(
+              due - now, std::numeric_limits<int>::max())));
+        }
+      }
+      if (pool == nullptr) {
+        Execute(trace);
+        continue;
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return pending < num_threads * 16; });
+        pending++;
+      }
+      pool->SubmitJob([this, trace] {
+        Execute(trace);
+        std::lock_guard<std::mutex> guard(mutex);
+        pending--;
+        cv.notify_one();
+      });
+    }
+    if (pool != nullptr) {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [this] { return pending == 0; });
+      lock.unlock();
+      pool->JoinAllThreads();
+    }
+    // A trace cut short by its size limit has no end record.
+    return s.IsIncomplete() ? Status::OK() : s;
+  }
+};
+
+crocksdb_trace_replayer_t* crocksdb_trace_replayer_create(
+    crocksdb_t* db, crocksdb_column_family_handle_t** column_families,
+    size_t num_column_families, const char* trace_path, char** errptr) {
+  std::unique_ptr<TraceReader> reader;
+  Status s = rocksdb::NewFileTraceReader(db->rep->GetEnv(), EnvOptions(),
+                                         std::string(trace_path), &reader);
+  if (SaveError(errptr, s)) {
+    return nullptr;
+  }
+  crocksdb_trace_replayer_t* replayer = new crocksdb_trace_replayer_t;
+  replayer->db = db->rep;
+  replayer->reader = std::move(reader);
+  for (size_t i = 0; i < num_column_families; i++) {
+    replayer->cfs[column_families[i]->rep->GetID()] = column_families[i]->rep;
+  }
+  return replayer;
+}
+
+void crocksdb_trace_replayer_destroy(crocksdb_trace_replayer_t* replayer) {
+  delete replayer;
+}
+
+void crocksdb_trace_replayer_set_speed(crocksdb_trace_replayer_t* replayer,
+                                       double speed) {
+  replayer->speed = speed;
+}
+
+void crocksdb_trace_replayer_set_threads(crocksdb_trace_replayer_t* replayer,
+                                         int num_threads) {
+  replayer->num_threads = std::max(num_threads, 1);
+}
+
+void crocksdb_trace_replayer_replay(crocksdb_trace_replayer_t* replayer,
+                                    char** errptr) {
+  SaveError(errptr, replayer->Replay());
+}
+
+uint64_t crocksdb_trace_replayer_get_num_ops(
+    crocksdb_trace_replayer_t* replayer, int op_type) {
+  if (op_type < 0 || op_type >= crocksdb_trace_replayer_t::kNumOpTypes) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> guard(replayer->histogram_mutex);
+  return replayer->histograms[op_type].num();
+}
+
+unsigned char crocksdb_trace_replayer_get_histogram(
+    crocksdb_trace_replayer_t* replayer, int op_type, double* median,
+    double* percentile95, double* percentile99, double* average,
+    double* standard_deviation, double* max) {
+  if (op_type < 0 || op_type >= crocksdb_trace_replayer_t::kNumOpTypes) {
+    return 0;
+  }
+  crocksdb_histogramdata_t data;
+  {
+    std::lock_guard<std::mutex> guard(replayer->histogram_mutex);
+    replayer->histograms[op_type].Data(&data.rep);
+  }
+  *median = data.rep.median;
+  *percentile95 = data.rep.percentile95;
+  *percentile99 = data.rep.percentile99;
+  *average = data.rep.average;
+  *standard_deviation = data.rep.standard_deviation;
+  *max = data.rep.max;
+  return 1;
+}
+
 /* Tools */
 
 void crocksdb_run_ldb_tool(int argc, char** argv,
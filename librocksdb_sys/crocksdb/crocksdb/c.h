@@ -76,8 +76,12 @@ typedef struct crocksdb_status_ptr_t crocksdb_status_ptr_t;
 typedef struct crocksdb_backup_engine_t crocksdb_backup_engine_t;
 typedef struct crocksdb_backup_engine_info_t crocksdb_backup_engine_info_t;
 typedef struct crocksdb_restore_options_t crocksdb_restore_options_t;
+typedef struct crocksdb_backupable_db_options_t
+    crocksdb_backupable_db_options_t;
 typedef struct crocksdb_lru_cache_options_t crocksdb_lru_cache_options_t;
 typedef struct crocksdb_cache_t crocksdb_cache_t;
+typedef struct crocksdb_persistent_cache_t crocksdb_persistent_cache_t;
+typedef struct crocksdb_write_buffer_manager_t crocksdb_write_buffer_manager_t;
 typedef struct crocksdb_memory_allocator_t crocksdb_memory_allocator_t;
 typedef struct crocksdb_compactionfilter_t crocksdb_compactionfilter_t;
 enum {
@@ -119,6 +123,14 @@ typedef struct crocksdb_writeoptions_t crocksdb_writeoptions_t;
 typedef struct crocksdb_universal_compaction_options_t
     crocksdb_universal_compaction_options_t;
 typedef struct crocksdb_livefiles_t crocksdb_livefiles_t;
+typedef struct crocksdb_livefiles_diff_t crocksdb_livefiles_diff_t;
+typedef struct crocksdb_open_profile_t crocksdb_open_profile_t;
+enum {
+  crocksdb_open_phase_manifest_replay = 0,
+  crocksdb_open_phase_table_opening = 1,
+  crocksdb_open_phase_wal_recovery = 2,
+  crocksdb_open_phase_options_persistence = 3,
+};
 typedef struct crocksdb_column_family_handle_t crocksdb_column_family_handle_t;
 typedef struct crocksdb_envoptions_t crocksdb_envoptions_t;
 typedef struct crocksdb_sequential_file_t crocksdb_sequential_file_t;
@@ -127,6 +139,13 @@ typedef struct crocksdb_ingestexternalfileoptions_t
 typedef struct crocksdb_sstfilereader_t crocksdb_sstfilereader_t;
 typedef struct crocksdb_sstfilewriter_t crocksdb_sstfilewriter_t;
 typedef struct crocksdb_externalsstfileinfo_t crocksdb_externalsstfileinfo_t;
+enum {
+  crocksdb_file_checksum_crc32c = 1,
+  crocksdb_file_checksum_xxh64 = 2,
+};
+typedef struct crocksdb_parallel_sstfilewriter_t
+    crocksdb_parallel_sstfilewriter_t;
+typedef struct crocksdb_snapshot_exporter_t crocksdb_snapshot_exporter_t;
 typedef struct crocksdb_ratelimiter_t crocksdb_ratelimiter_t;
 typedef struct crocksdb_pinnableslice_t crocksdb_pinnableslice_t;
 typedef struct crocksdb_user_collected_properties_t
@@ -153,6 +172,8 @@ typedef struct crocksdb_column_family_meta_data_t
     crocksdb_column_family_meta_data_t;
 typedef struct crocksdb_level_meta_data_t crocksdb_level_meta_data_t;
 typedef struct crocksdb_sst_file_meta_data_t crocksdb_sst_file_meta_data_t;
+typedef struct crocksdb_export_import_files_metadata_t
+    crocksdb_export_import_files_metadata_t;
 typedef struct crocksdb_compaction_options_t crocksdb_compaction_options_t;
 typedef struct crocksdb_perf_context_t crocksdb_perf_context_t;
 typedef struct crocksdb_iostats_context_t crocksdb_iostats_context_t;
@@ -160,6 +181,11 @@ typedef struct crocksdb_writestallinfo_t crocksdb_writestallinfo_t;
 typedef struct crocksdb_writestallcondition_t crocksdb_writestallcondition_t;
 typedef struct crocksdb_map_property_t crocksdb_map_property_t;
 typedef struct crocksdb_writebatch_iterator_t crocksdb_writebatch_iterator_t;
+typedef struct crocksdb_block_cache_recorder_t crocksdb_block_cache_recorder_t;
+typedef struct crocksdb_block_cache_warmer_t crocksdb_block_cache_warmer_t;
+typedef struct crocksdb_block_cache_simulator_t
+    crocksdb_block_cache_simulator_t;
+typedef struct crocksdb_trace_replayer_t crocksdb_trace_replayer_t;
 
 typedef enum crocksdb_sst_partitioner_result_t {
   kNotRequired = 0,
@@ -237,6 +263,16 @@ extern C_ROCKSDB_LIBRARY_API crocksdb_t* crocksdb_open_for_read_only(
     const crocksdb_options_t* options, const char* name,
     unsigned char error_if_log_file_exist, char** errptr);
 
+/* Opens a secondary instance of the db at `name`, which follows the primary
+   by replaying its MANIFEST and WAL on crocksdb_try_catch_up_with_primary.
+   Info logs go to `secondary_path`. Requires max_open_files to be -1. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_t* crocksdb_open_as_secondary(
+    const crocksdb_options_t* options, const char* name,
+    const char* secondary_path, char** errptr);
+
+extern C_ROCKSDB_LIBRARY_API void crocksdb_try_catch_up_with_primary(
+    crocksdb_t* db, char** errptr);
+
 extern C_ROCKSDB_LIBRARY_API void crocksdb_status_ptr_get_error(
     crocksdb_status_ptr_t*, char** errptr);
 
@@ -244,9 +280,54 @@ extern C_ROCKSDB_LIBRARY_API crocksdb_backup_engine_t*
 crocksdb_backup_engine_open(const crocksdb_options_t* options, const char* path,
                             char** errptr);
 
+extern C_ROCKSDB_LIBRARY_API crocksdb_backupable_db_options_t*
+crocksdb_backupable_db_options_create(const char* backup_dir);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_backupable_db_options_destroy(
+    crocksdb_backupable_db_options_t* opt);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backupable_db_options_set_share_table_files(
+    crocksdb_backupable_db_options_t* opt, unsigned char v);
+/* Names shared table files by checksum and size, so identical files from
+   different DBs or backups are stored once. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backupable_db_options_set_share_files_with_checksum(
+    crocksdb_backupable_db_options_t* opt, unsigned char v);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_backupable_db_options_set_sync(
+    crocksdb_backupable_db_options_t* opt, unsigned char v);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backupable_db_options_set_backup_log_files(
+    crocksdb_backupable_db_options_t* opt, unsigned char v);
+/* Number of threads copying files, both for backups and restores. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backupable_db_options_set_max_background_operations(
+    crocksdb_backupable_db_options_t* opt, int v);
+/* How many bytes are copied between two calls of the progress callback. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backupable_db_options_set_callback_trigger_interval_size(
+    crocksdb_backupable_db_options_t* opt, uint64_t v);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backupable_db_options_set_backup_rate_limiter(
+    crocksdb_backupable_db_options_t* opt, crocksdb_ratelimiter_t* limiter);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backupable_db_options_set_restore_rate_limiter(
+    crocksdb_backupable_db_options_t* opt, crocksdb_ratelimiter_t* limiter);
+
+extern C_ROCKSDB_LIBRARY_API crocksdb_backup_engine_t*
+crocksdb_backup_engine_open_opt(
+    const crocksdb_options_t* options,
+    const crocksdb_backupable_db_options_t* backup_options, char** errptr);
+
 extern C_ROCKSDB_LIBRARY_API void crocksdb_backup_engine_create_new_backup(
     crocksdb_backup_engine_t* be, crocksdb_t* db, char** errptr);
 
+/* `progress` is called from the copying threads every
+   callback_trigger_interval_size bytes, and may be null. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_backup_engine_create_new_backup_with_progress(
+    crocksdb_backup_engine_t* be, crocksdb_t* db,
+    unsigned char flush_before_backup, void* ctx, void (*progress)(void*),
+    char** errptr);
+
 extern C_ROCKSDB_LIBRARY_API void crocksdb_backup_engine_purge_old_backups(
     crocksdb_backup_engine_t* be, uint32_t num_backups_to_keep, char** errptr);
 
@@ -286,12 +367,60 @@ extern C_ROCKSDB_LIBRARY_API void crocksdb_backup_engine_info_destroy(
 extern C_ROCKSDB_LIBRARY_API void crocksdb_backup_engine_close(
     crocksdb_backup_engine_t* be);
 
+/* Creates an openable snapshot of the DB in `checkpoint_dir`, which must not
+   exist. Table files are hard-linked when on the same filesystem and copied
+   otherwise. The memtables are flushed first only if the live WALs total at
+   least `log_size_for_flush` bytes; otherwise the WALs are copied instead.
+   0 always flushes. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_create_checkpoint(
+    crocksdb_t* db, const char* checkpoint_dir, uint64_t log_size_for_flush,
+    char** errptr);
+
 extern C_ROCKSDB_LIBRARY_API crocksdb_t* crocksdb_open_column_families(
     const crocksdb_options_t* options, const char* name,
     int num_column_families, const char** column_family_names,
     const crocksdb_options_t** column_family_options,
     crocksdb_column_family_handle_t** column_family_handles, char** errptr);
 
+/* Same as crocksdb_open_column_families, also recording into `profile` how
+   long each crocksdb_open_phase_* took and how many files it touched. The
+   phases are told apart by the files the open accesses, through an Env
+   wrapping the one in `options`, and recovered entries are counted by a WAL
+   filter wrapping the one in `options`. The profile is filled even on
+   error. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_t*
+crocksdb_open_column_families_with_profile(
+    const crocksdb_options_t* options, const char* name,
+    int num_column_families, const char** column_family_names,
+    const crocksdb_options_t** column_family_options,
+    crocksdb_column_family_handle_t** column_family_handles,
+    crocksdb_open_profile_t* profile, char** errptr);
+
+extern C_ROCKSDB_LIBRARY_API crocksdb_open_profile_t*
+crocksdb_open_profile_create();
+extern C_ROCKSDB_LIBRARY_API void crocksdb_open_profile_destroy(
+    crocksdb_open_profile_t*);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_open_profile_duration_micros(
+    const crocksdb_open_profile_t*, int phase);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_open_profile_file_count(const crocksdb_open_profile_t*, int phase);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_open_profile_total_micros(const crocksdb_open_profile_t*);
+/* Entries replayed from the WALs, whether flushed during recovery or left in
+   the memtables. */
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_open_profile_wal_recovered_entries(const crocksdb_open_profile_t*);
+/* The WALs replayed, in order, with the bytes read from each and the time
+   from opening it to its last read. */
+extern C_ROCKSDB_LIBRARY_API size_t
+crocksdb_open_profile_wal_file_count(const crocksdb_open_profile_t*);
+extern C_ROCKSDB_LIBRARY_API const char* crocksdb_open_profile_wal_file_name(
+    const crocksdb_open_profile_t*, size_t index);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_open_profile_wal_file_bytes(
+    const crocksdb_open_profile_t*, size_t index);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_open_profile_wal_file_micros(
+    const crocksdb_open_profile_t*, size_t index);
+
 extern C_ROCKSDB_LIBRARY_API crocksdb_t* crocksdb_open_column_families_with_ttl(
     const crocksdb_options_t* options, const char* name,
     int num_column_families, const char** column_family_names,
@@ -307,6 +436,14 @@ crocksdb_open_for_read_only_column_families(
     crocksdb_column_family_handle_t** column_family_handles,
     unsigned char error_if_log_file_exist, char** errptr);
 
+extern C_ROCKSDB_LIBRARY_API crocksdb_t*
+crocksdb_open_as_secondary_column_families(
+    const crocksdb_options_t* options, const char* name,
+    const char* secondary_path, int num_column_families,
+    const char** column_family_names,
+    const crocksdb_options_t** column_family_options,
+    crocksdb_column_family_handle_t** column_family_handles, char** errptr);
+
 extern C_ROCKSDB_LIBRARY_API char** crocksdb_list_column_families(
     const crocksdb_options_t* options, const char* name, size_t* lencf,
     char** errptr);
@@ -539,6 +676,22 @@ extern C_ROCKSDB_LIBRARY_API void crocksdb_disable_file_deletions(
 extern C_ROCKSDB_LIBRARY_API void crocksdb_enable_file_deletions(
     crocksdb_t* db, unsigned char force, char** errptr);
 
+/* Returns the live files added and removed since the diff `since`, which
+   serves as the version token, or all live files if it is NULL. File
+   deletions are disabled until the diff's files are released or the diff is
+   destroyed, unless no file was added. The diff must not outlive the db. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_livefiles_diff_t*
+crocksdb_livefiles_diff(crocksdb_t* db, const crocksdb_livefiles_diff_t* since,
+                        char** errptr);
+extern C_ROCKSDB_LIBRARY_API const crocksdb_livefiles_t*
+crocksdb_livefiles_diff_added(const crocksdb_livefiles_diff_t*);
+extern C_ROCKSDB_LIBRARY_API const crocksdb_livefiles_t*
+crocksdb_livefiles_diff_removed(const crocksdb_livefiles_diff_t*);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_livefiles_diff_release_files(
+    crocksdb_livefiles_diff_t*);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_livefiles_diff_destroy(
+    crocksdb_livefiles_diff_t*);
+
 extern C_ROCKSDB_LIBRARY_API crocksdb_options_t* crocksdb_get_db_options(
     crocksdb_t* db);
 
@@ -758,6 +911,14 @@ enum {
 };
 extern C_ROCKSDB_LIBRARY_API void crocksdb_block_based_options_set_index_type(
     crocksdb_block_based_table_options_t*, int);  // uses one of the above enums
+enum {
+  crocksdb_block_based_table_checksum_no_checksum = 0,
+  crocksdb_block_based_table_checksum_crc32c = 1,
+  crocksdb_block_based_table_checksum_xxhash = 2,
+  crocksdb_block_based_table_checksum_xxhash64 = 3,
+};
+extern C_ROCKSDB_LIBRARY_API void crocksdb_block_based_options_set_checksum(
+    crocksdb_block_based_table_options_t*, int);  // uses one of the above enums
 extern C_ROCKSDB_LIBRARY_API void
 crocksdb_block_based_options_set_hash_index_allow_collision(
     crocksdb_block_based_table_options_t*, unsigned char);
@@ -1005,8 +1166,28 @@ extern C_ROCKSDB_LIBRARY_API size_t
 crocksdb_options_get_write_buffer_size(crocksdb_options_t*);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_db_write_buffer_size(
     crocksdb_options_t*, size_t);
+/* Shares `manager` with the DB. Memtables of every DB sharing it count against
+   its buffer size, overriding db_write_buffer_size. `manager` stays usable
+   and may be destroyed once it is set. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_write_buffer_manager(
+    crocksdb_options_t*, crocksdb_write_buffer_manager_t* manager);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_max_open_files(
     crocksdb_options_t*, int);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_options_set_max_file_opening_threads(crocksdb_options_t*, int);
+extern C_ROCKSDB_LIBRARY_API int crocksdb_options_get_max_file_opening_threads(
+    crocksdb_options_t*);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_options_set_skip_stats_update_on_db_open(crocksdb_options_t*,
+                                                  unsigned char);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_options_get_skip_stats_update_on_db_open(crocksdb_options_t*);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_options_set_skip_checking_sst_file_sizes_on_db_open(
+    crocksdb_options_t*, unsigned char);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_options_get_skip_checking_sst_file_sizes_on_db_open(
+    crocksdb_options_t*);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_max_total_wal_size(
     crocksdb_options_t* opt, uint64_t n);
 extern C_ROCKSDB_LIBRARY_API void
@@ -1190,6 +1371,16 @@ extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_is_fd_close_on_exec(
 extern C_ROCKSDB_LIBRARY_API void
 crocksdb_options_set_skip_log_error_on_recovery(crocksdb_options_t*,
                                                 unsigned char);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_options_set_avoid_flush_during_recovery(crocksdb_options_t*,
+                                                 unsigned char);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_options_get_avoid_flush_during_recovery(crocksdb_options_t*);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_options_set_avoid_flush_during_shutdown(crocksdb_options_t*,
+                                                 unsigned char);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_options_get_avoid_flush_during_shutdown(crocksdb_options_t*);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_stats_dump_period_sec(
     crocksdb_options_t*, unsigned int);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_advise_random_on_open(
@@ -1307,12 +1498,22 @@ extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_fifo_compaction_options(
     crocksdb_options_t* opt, crocksdb_fifo_compaction_options_t* fifo);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_ratelimiter(
     crocksdb_options_t* opt, crocksdb_ratelimiter_t* limiter);
+/* Unlike crocksdb_options_set_ratelimiter, `limiter` stays usable, e.g. for
+   requests of the application or its statistics. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_shared_ratelimiter(
+    crocksdb_options_t* opt, crocksdb_ratelimiter_t* limiter);
+/* A priority rate limiter set on `opt` comes back as one. Options taken
+   from a DB don't know it, so its limiter comes back as a plain one. */
 extern C_ROCKSDB_LIBRARY_API crocksdb_ratelimiter_t*
 crocksdb_options_get_ratelimiter(crocksdb_options_t* opt);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_vector_memtable_factory(
     crocksdb_options_t* opt, uint64_t reserved_bytes);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_atomic_flush(
     crocksdb_options_t* opt, unsigned char enable);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_options_set_allow_ingest_behind(
+    crocksdb_options_t* opt, unsigned char v);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_options_get_allow_ingest_behind(crocksdb_options_t* opt);
 
 enum {
   compaction_by_compensated_size = 0,
@@ -1352,10 +1553,26 @@ extern C_ROCKSDB_LIBRARY_API void crocksdb_ratelimiter_set_auto_tuned(
     crocksdb_ratelimiter_t* limiter, unsigned char auto_tuned);
 extern C_ROCKSDB_LIBRARY_API int64_t
 crocksdb_ratelimiter_get_singleburst_bytes(crocksdb_ratelimiter_t* limiter);
+/* A rate limiter with high, mid, low and user priorities. High priority
+   requests (flushes) are served first, the rest of the budget is shared by
+   weighted fair queuing between user, mid and low priority requests
+   (compactions). Bytes, requests and wait time are accounted per priority. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_ratelimiter_t*
+crocksdb_priority_ratelimiter_create(int64_t rate_bytes_per_sec,
+                                     int64_t refill_period_us,
+                                     int32_t user_weight, int32_t mid_weight,
+                                     int32_t low_weight,
+                                     crocksdb_ratelimiter_mode_t mode);
+/* Mid and user priorities are only served separately by a priority rate
+   limiter. Other rate limiters request them as low and high, so their
+   statistics getters report 0 for mid and user, and the bytes and requests
+   show up under low and high instead. */
 enum {
   env_io_priority_low = 0,
   env_io_priority_high = 1,
   env_io_priority_total = 2,
+  env_io_priority_mid = 3,
+  env_io_priority_user = 4,
 };
 extern C_ROCKSDB_LIBRARY_API void crocksdb_ratelimiter_request(
     crocksdb_ratelimiter_t* limiter, int64_t bytes, unsigned char pri);
@@ -1368,6 +1585,10 @@ extern C_ROCKSDB_LIBRARY_API unsigned char crocksdb_ratelimiter_get_auto_tuned(
     crocksdb_ratelimiter_t* limiter);
 extern C_ROCKSDB_LIBRARY_API int64_t crocksdb_ratelimiter_get_total_requests(
     crocksdb_ratelimiter_t* limiter, unsigned char pri);
+/* Only accounted by a priority rate limiter, 0 otherwise. */
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_ratelimiter_get_total_wait_micros(crocksdb_ratelimiter_t* limiter,
+                                           unsigned char pri);
 
 /* Compaction Filter Context */
 
@@ -1573,12 +1794,71 @@ crocksdb_lru_cache_options_set_high_pri_pool_ratio(
 extern C_ROCKSDB_LIBRARY_API void
 crocksdb_lru_cache_options_set_memory_allocator(crocksdb_lru_cache_options_t*,
                                                 crocksdb_memory_allocator_t*);
+/* A non-zero capacity attaches a compressed secondary tier to the cache.
+   Blocks are kept there in their on-disk compressed form and promoted back
+   into the primary cache on hit. Lookups are accounted by the
+   BLOCK_CACHE_COMPRESSED_* tickers. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_lru_cache_options_set_compressed_secondary_capacity(
+    crocksdb_lru_cache_options_t*, size_t);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_lru_cache_options_set_compressed_secondary_num_shard_bits(
+    crocksdb_lru_cache_options_t*, int);
+/* Attaches a persistent tier on local storage behind the cache. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_lru_cache_options_set_persistent_cache(crocksdb_lru_cache_options_t*,
+                                                crocksdb_persistent_cache_t*);
 extern C_ROCKSDB_LIBRARY_API crocksdb_cache_t* crocksdb_cache_create_lru(
     crocksdb_lru_cache_options_t*);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_cache_destroy(
     crocksdb_cache_t* cache);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_cache_set_capacity(
     crocksdb_cache_t* cache, size_t capacity);
+extern C_ROCKSDB_LIBRARY_API size_t
+crocksdb_cache_get_usage(crocksdb_cache_t* cache);
+extern C_ROCKSDB_LIBRARY_API size_t
+crocksdb_cache_get_compressed_secondary_usage(crocksdb_cache_t* cache);
+extern C_ROCKSDB_LIBRARY_API size_t
+crocksdb_cache_get_compressed_secondary_capacity(crocksdb_cache_t* cache);
+
+/* WriteBufferManager */
+
+/* Bounds the memtable memory of all the DBs it is set on. A flush is
+   triggered once the usage exceeds `buffer_size`, 0 only tracks the usage.
+   If `cache` is given, the memtable memory is also charged to it as dummy
+   entries, so memtables and blocks share the capacity of the cache. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_write_buffer_manager_t*
+crocksdb_write_buffer_manager_create(size_t buffer_size,
+                                     crocksdb_cache_t* cache);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_write_buffer_manager_destroy(
+    crocksdb_write_buffer_manager_t* manager);
+extern C_ROCKSDB_LIBRARY_API size_t crocksdb_write_buffer_manager_buffer_size(
+    crocksdb_write_buffer_manager_t* manager);
+extern C_ROCKSDB_LIBRARY_API size_t
+crocksdb_write_buffer_manager_memory_usage(
+    crocksdb_write_buffer_manager_t* manager);
+extern C_ROCKSDB_LIBRARY_API size_t
+crocksdb_write_buffer_manager_mutable_memtable_memory_usage(
+    crocksdb_write_buffer_manager_t* manager);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_write_buffer_manager_cost_to_cache(
+    crocksdb_write_buffer_manager_t* manager);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_write_buffer_manager_should_flush(
+    crocksdb_write_buffer_manager_t* manager);
+
+/* Persistent cache */
+
+/* Creates a block cache tier in `path` on the local file system. Blocks are
+   appended to log-structured cache files and located through an in-memory
+   index, so `path` should live on a fast local disk. Lookups are accounted
+   by the PERSISTENT_CACHE_* tickers. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_persistent_cache_t*
+crocksdb_persistent_cache_create(const char* path, uint64_t size,
+                                 unsigned char optimized_for_nvm,
+                                 char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_persistent_cache_destroy(
+    crocksdb_persistent_cache_t* cache);
 
 /* Env */
 
@@ -1654,6 +1934,19 @@ crocksdb_encryption_key_manager_create(
     crocksdb_encryption_key_manager_new_file_cb new_file,
     crocksdb_encryption_key_manager_delete_file_cb delete_file,
     crocksdb_encryption_key_manager_link_file_cb link_file);
+/* Same as crocksdb_encryption_key_manager_create, but keeps the file info
+   returned by `get_file` in a cache of 2^num_shard_bits shards, so reopening
+   a file doesn't call back. The cache is invalidated by new_file,
+   delete_file and link_file of the same key manager, so file info must not
+   be changed behind its back. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_encryption_key_manager_t*
+crocksdb_encryption_key_manager_create_with_cache(
+    void* state, void (*destructor)(void*),
+    crocksdb_encryption_key_manager_get_file_cb get_file,
+    crocksdb_encryption_key_manager_new_file_cb new_file,
+    crocksdb_encryption_key_manager_delete_file_cb delete_file,
+    crocksdb_encryption_key_manager_link_file_cb link_file,
+    int num_shard_bits);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_encryption_key_manager_destroy(
     crocksdb_encryption_key_manager_t*);
 extern C_ROCKSDB_LIBRARY_API const char*
@@ -1675,6 +1968,15 @@ crocksdb_encryption_key_manager_link_file(
 extern C_ROCKSDB_LIBRARY_API crocksdb_env_t*
 crocksdb_key_managed_encrypted_env_create(crocksdb_env_t*,
                                           crocksdb_encryption_key_manager_t*);
+
+/* An env encrypting every file with AES-CTR under `key` and a random IV per
+   file. Whole reads and writes are ciphered at once, using AES-NI/VAES when
+   the CPU supports them. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_env_t*
+crocksdb_aes_ctr_encrypted_env_create(crocksdb_env_t* base_env,
+                                      crocksdb_encryption_method_t method,
+                                      const char* key, size_t keylen,
+                                      char** errptr);
 #endif
 
 /* FileSystemInspectedEnv */
@@ -1698,6 +2000,33 @@ extern C_ROCKSDB_LIBRARY_API size_t crocksdb_file_system_inspector_read(
 extern C_ROCKSDB_LIBRARY_API size_t crocksdb_file_system_inspector_write(
     crocksdb_file_system_inspector_t* inspector, size_t len, char** errptr);
 
+/* Returns the bytes allowed until the next refill. `used` is the bytes
+   taken since the last refill. */
+typedef size_t (*crocksdb_file_system_inspector_refill_cb)(void* state,
+                                                           size_t used,
+                                                           char** errptr);
+
+/* An inspector with a native token bucket for reads and one for writes.
+   The refill callbacks are only called once every `refill_period_us`, or
+   early, at most once per period, when a bucket runs out. A request finding
+   an empty bucket waits for the next period. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_file_system_inspector_t*
+crocksdb_token_bucket_file_system_inspector_create(
+    void* state, void (*destructor)(void*),
+    crocksdb_file_system_inspector_refill_cb refill_read,
+    crocksdb_file_system_inspector_refill_cb refill_write,
+    uint64_t refill_period_us);
+/* Counters of token bucket inspectors, 0 for other inspectors. */
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_file_system_inspector_get_read_throttled_micros(
+    crocksdb_file_system_inspector_t* inspector);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_file_system_inspector_get_write_throttled_micros(
+    crocksdb_file_system_inspector_t* inspector);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_file_system_inspector_get_refill_count(
+    crocksdb_file_system_inspector_t* inspector);
+
 extern C_ROCKSDB_LIBRARY_API crocksdb_env_t*
 crocksdb_file_system_inspected_env_create(crocksdb_env_t*,
                                           crocksdb_file_system_inspector_t*);
@@ -1731,6 +2060,16 @@ extern C_ROCKSDB_LIBRARY_API crocksdb_sstfilewriter_t*
 crocksdb_sstfilewriter_create_cf(
     const crocksdb_envoptions_t* env, const crocksdb_options_t* io_options,
     crocksdb_column_family_handle_t* column_family);
+/* Same as crocksdb_sstfilewriter_create_cf, `column_family` may be null, but
+   the writer also computes a checksum of each whole file it writes, one of
+   crocksdb_file_checksum_*, and returns it through the info given to
+   crocksdb_sstfilewriter_finish. The checksum is taken from the data as it
+   is written, so direct writes are turned off for the writer. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_sstfilewriter_t*
+crocksdb_sstfilewriter_create_with_file_checksum(
+    const crocksdb_envoptions_t* env, const crocksdb_options_t* io_options,
+    crocksdb_column_family_handle_t* column_family, int checksum_type,
+    char** errptr);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_sstfilewriter_open(
     crocksdb_sstfilewriter_t* writer, const char* name, char** errptr);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_sstfilewriter_put(
@@ -1753,6 +2092,86 @@ crocksdb_sstfilewriter_file_size(crocksdb_sstfilewriter_t* writer);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_sstfilewriter_destroy(
     crocksdb_sstfilewriter_t* writer);
 
+/* ParallelSstFileWriter */
+
+/* Writes sorted input into files named `<path_prefix>000001.sst`,
+   `<path_prefix>000002.sst`, ..., building up to `num_threads` files
+   concurrently. A file is cut once its uncompressed input reaches
+   `target_file_size`, or when crocksdb_parallel_sstfilewriter_cut is called.
+   While a range deletion is open, i.e. until a key after its end is added,
+   the cut waits for it, so the files never overlap. Range deletions are
+   ordered with the other keys by their begin key. `column_family` may be
+   null. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_parallel_sstfilewriter_t*
+crocksdb_parallel_sstfilewriter_create(
+    const crocksdb_envoptions_t* env, const crocksdb_options_t* io_options,
+    crocksdb_column_family_handle_t* column_family, const char* path_prefix,
+    uint64_t target_file_size, int num_threads);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_parallel_sstfilewriter_put(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* key, size_t keylen,
+    const char* val, size_t vallen, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_parallel_sstfilewriter_merge(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* key, size_t keylen,
+    const char* val, size_t vallen, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_parallel_sstfilewriter_delete(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* key, size_t keylen,
+    char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_parallel_sstfilewriter_delete_range(
+    crocksdb_parallel_sstfilewriter_t* writer, const char* begin_key,
+    size_t begin_keylen, const char* end_key, size_t end_keylen, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_parallel_sstfilewriter_cut(
+    crocksdb_parallel_sstfilewriter_t* writer, char** errptr);
+/* Waits for all files and returns how many were written. On error every
+   file written so far is removed. */
+extern C_ROCKSDB_LIBRARY_API size_t crocksdb_parallel_sstfilewriter_finish(
+    crocksdb_parallel_sstfilewriter_t* writer, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_parallel_sstfilewriter_get_file_info(
+    crocksdb_parallel_sstfilewriter_t* writer, size_t index,
+    crocksdb_externalsstfileinfo_t* info);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_parallel_sstfilewriter_destroy(
+    crocksdb_parallel_sstfilewriter_t* writer);
+
+/* Snapshot exporter. Writes the visible data of a snapshot in a set of key
+   ranges into sst files named `<dir>/<range>_<n>.sst`, exporting up to
+   `num_threads` ranges concurrently. An empty end key means no upper bound.
+   The db and the snapshot must outlive the exporter. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_snapshot_exporter_t*
+crocksdb_snapshot_exporter_create(crocksdb_t* db,
+                                  const crocksdb_snapshot_t* snapshot,
+                                  const char* dir, int num_threads);
+/* Cuts a range into several files of about this size. 0 means one file per
+   range. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_snapshot_exporter_set_target_file_size(
+    crocksdb_snapshot_exporter_t* exporter, uint64_t target_file_size);
+/* The files are written as low priority requests to `limiter`. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_snapshot_exporter_set_rate_limiter(
+    crocksdb_snapshot_exporter_t* exporter, crocksdb_ratelimiter_t* limiter);
+/* Returns the index of the range. */
+extern C_ROCKSDB_LIBRARY_API size_t crocksdb_snapshot_exporter_add_range(
+    crocksdb_snapshot_exporter_t* exporter,
+    crocksdb_column_family_handle_t* column_family, const char* start_key,
+    size_t start_key_len, const char* end_key, size_t end_key_len);
+/* On error, all files written so far are removed. An exporter runs only
+   once; running it again fails. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_snapshot_exporter_run(
+    crocksdb_snapshot_exporter_t* exporter, char** errptr);
+extern C_ROCKSDB_LIBRARY_API size_t
+crocksdb_snapshot_exporter_range_file_count(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_snapshot_exporter_range_file_info(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range, size_t index,
+    crocksdb_externalsstfileinfo_t* info);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_snapshot_exporter_range_num_keys(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_snapshot_exporter_range_num_bytes(
+    const crocksdb_snapshot_exporter_t* exporter, size_t range);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_snapshot_exporter_destroy(
+    crocksdb_snapshot_exporter_t* exporter);
+
 /* ExternalSstFileInfo */
 
 extern C_ROCKSDB_LIBRARY_API crocksdb_externalsstfileinfo_t*
@@ -1773,6 +2192,22 @@ extern C_ROCKSDB_LIBRARY_API uint64_t
 crocksdb_externalsstfileinfo_file_size(crocksdb_externalsstfileinfo_t*);
 extern C_ROCKSDB_LIBRARY_API uint64_t
 crocksdb_externalsstfileinfo_num_entries(crocksdb_externalsstfileinfo_t*);
+/* The whole-file checksum, in big endian, and the name of its function. Both
+   are empty unless the file is written by a writer created with
+   crocksdb_sstfilewriter_create_with_file_checksum. */
+extern C_ROCKSDB_LIBRARY_API const char*
+crocksdb_externalsstfileinfo_file_checksum(crocksdb_externalsstfileinfo_t*,
+                                           size_t*);
+extern C_ROCKSDB_LIBRARY_API const char*
+crocksdb_externalsstfileinfo_file_checksum_func_name(
+    crocksdb_externalsstfileinfo_t*);
+
+/* Reads the file at `path` from `env` and fails with Corruption unless its
+   checksum of `checksum_type` is `expected`, e.g. before ingesting a file
+   or after copying it to a backup. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_verify_file_checksum(
+    crocksdb_env_t* env, const char* path, int checksum_type,
+    const char* expected, size_t expected_len, char** errptr);
 
 extern C_ROCKSDB_LIBRARY_API crocksdb_ingestexternalfileoptions_t*
 crocksdb_ingestexternalfileoptions_create();
@@ -1798,6 +2233,12 @@ extern C_ROCKSDB_LIBRARY_API void
 crocksdb_ingestexternalfileoptions_set_write_global_seqno(
     crocksdb_ingestexternalfileoptions_t* opt,
     unsigned char write_global_seqno);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_ingestexternalfileoptions_get_ingest_behind(
+    const crocksdb_ingestexternalfileoptions_t* opt);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_ingestexternalfileoptions_set_ingest_behind(
+    crocksdb_ingestexternalfileoptions_t* opt, unsigned char ingest_behind);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_ingestexternalfileoptions_destroy(
     crocksdb_ingestexternalfileoptions_t* opt);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_ingest_external_file(
@@ -1812,6 +2253,22 @@ crocksdb_ingest_external_file_optimized(
     crocksdb_t* db, crocksdb_column_family_handle_t* handle,
     const char* const* file_list, const size_t list_len,
     const crocksdb_ingestexternalfileoptions_t* opt, char** errptr);
+/* Ingests `file_lists[i]` into `handles[i]` with `opts[i]` for every i, all
+   column families atomically with a single manifest write. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_ingest_external_files(
+    crocksdb_t* db, crocksdb_column_family_handle_t** handles,
+    const char* const* const* file_lists, const size_t* list_lens,
+    const crocksdb_ingestexternalfileoptions_t* const* opts, size_t num_cfs,
+    char** errptr);
+/* Like crocksdb_ingest_external_file_optimized, for several column
+   families. Only the ones whose memtables overlap their files are flushed,
+   and nothing is ingested if that flush fails. */
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_ingest_external_files_optimized(
+    crocksdb_t* db, crocksdb_column_family_handle_t** handles,
+    const char* const* const* file_lists, const size_t* list_lens,
+    const crocksdb_ingestexternalfileoptions_t* const* opts, size_t num_cfs,
+    char** errptr);
 
 /* SliceTransform */
 
@@ -1884,6 +2341,12 @@ extern C_ROCKSDB_LIBRARY_API const char* crocksdb_livefiles_smallestkey(
     const crocksdb_livefiles_t*, int index, size_t* size);
 extern C_ROCKSDB_LIBRARY_API const char* crocksdb_livefiles_largestkey(
     const crocksdb_livefiles_t*, int index, size_t* size);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_livefiles_smallest_seqno(const crocksdb_livefiles_t*, int index);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_livefiles_largest_seqno(const crocksdb_livefiles_t*, int index);
+extern C_ROCKSDB_LIBRARY_API const char* crocksdb_livefiles_column_family_name(
+    const crocksdb_livefiles_t*, int index);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_livefiles_destroy(
     const crocksdb_livefiles_t*);
 
@@ -2094,6 +2557,63 @@ extern C_ROCKSDB_LIBRARY_API uint64_t
 crocksdb_set_external_sst_file_global_seq_no(
     crocksdb_t* db, crocksdb_column_family_handle_t* column_family,
     const char* file, uint64_t seq_no, char** errptr);
+/* Sets the global seq no of `files[i]` to `seq_nos[i]` and stores the
+   previous one in `pre_seq_nos[i]`, processing up to `num_threads` files
+   concurrently. Reports the first error, but tries every file. */
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_set_external_sst_files_global_seq_no(
+    crocksdb_t* db, crocksdb_column_family_handle_t* column_family,
+    const char* const* files, const uint64_t* seq_nos, size_t num_files,
+    int num_threads, uint64_t* pre_seq_nos, char** errptr);
+
+/* Export/import column family */
+
+/* Links the sst files of the column family into `export_dir`, which must not
+   exist. Returns NULL on error. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_export_import_files_metadata_t*
+crocksdb_export_column_family(crocksdb_t* db,
+                              crocksdb_column_family_handle_t* column_family,
+                              const char* export_dir, char** errptr);
+extern C_ROCKSDB_LIBRARY_API crocksdb_export_import_files_metadata_t*
+crocksdb_export_import_files_metadata_create(const char* dir);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_export_import_files_metadata_destroy(
+    crocksdb_export_import_files_metadata_t*);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_export_import_files_metadata_add_file(
+    crocksdb_export_import_files_metadata_t*, const char* name, int level,
+    uint64_t smallest_seqno, uint64_t largest_seqno);
+extern C_ROCKSDB_LIBRARY_API const char*
+crocksdb_export_import_files_metadata_dir(
+    const crocksdb_export_import_files_metadata_t*);
+extern C_ROCKSDB_LIBRARY_API size_t crocksdb_export_import_files_metadata_count(
+    const crocksdb_export_import_files_metadata_t*);
+extern C_ROCKSDB_LIBRARY_API const char*
+crocksdb_export_import_files_metadata_name(
+    const crocksdb_export_import_files_metadata_t*, size_t index);
+extern C_ROCKSDB_LIBRARY_API int crocksdb_export_import_files_metadata_level(
+    const crocksdb_export_import_files_metadata_t*, size_t index);
+extern C_ROCKSDB_LIBRARY_API size_t crocksdb_export_import_files_metadata_size(
+    const crocksdb_export_import_files_metadata_t*, size_t index);
+extern C_ROCKSDB_LIBRARY_API const char*
+crocksdb_export_import_files_metadata_smallestkey(
+    const crocksdb_export_import_files_metadata_t*, size_t index, size_t* len);
+extern C_ROCKSDB_LIBRARY_API const char*
+crocksdb_export_import_files_metadata_largestkey(
+    const crocksdb_export_import_files_metadata_t*, size_t index, size_t* len);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_export_import_files_metadata_smallest_seqno(
+    const crocksdb_export_import_files_metadata_t*, size_t index);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_export_import_files_metadata_largest_seqno(
+    const crocksdb_export_import_files_metadata_t*, size_t index);
+
+/* Creates a column family holding the data of the exported files. The files
+   in the export dir are left untouched. Returns NULL on error. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_column_family_handle_t*
+crocksdb_create_column_family_with_import(
+    crocksdb_t* db, const crocksdb_options_t* column_family_options,
+    const char* column_family_name,
+    const crocksdb_export_import_files_metadata_t* metadata, char** errptr);
 
 /* ColumnFamilyMetaData */
 extern C_ROCKSDB_LIBRARY_API void crocksdb_get_column_family_meta_data(
@@ -2445,6 +2965,117 @@ crocksdb_sst_partitioner_factory_create_partitioner(
     crocksdb_sst_partitioner_factory_t* factory,
     crocksdb_sst_partitioner_context_t* context);
 
+/* Block cache warm-up */
+
+/* A recorder keeps the `max_keys` most recently used keys sampled from the
+   query trace of a DB. It can be saved at any time, e.g. periodically or
+   before shutdown. Recording uses the DB tracer, which takes one trace at a
+   time, so starting it fails with Busy while another trace runs. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_block_cache_recorder_t*
+crocksdb_block_cache_recorder_create(size_t max_keys);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_block_cache_recorder_destroy(
+    crocksdb_block_cache_recorder_t* recorder);
+extern C_ROCKSDB_LIBRARY_API size_t crocksdb_block_cache_recorder_count(
+    crocksdb_block_cache_recorder_t* recorder);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_block_cache_recorder_save(
+    crocksdb_block_cache_recorder_t* recorder, const char* path,
+    char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_start_block_cache_recording(
+    crocksdb_t* db, crocksdb_block_cache_recorder_t* recorder,
+    uint64_t sampling_frequency, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_end_block_cache_recording(
+    crocksdb_t* db, char** errptr);
+
+/* Loads the blocks of the keys saved in `path` into the block cache from a
+   background thread, hottest first. `limiter` may be NULL. Keys of column
+   families not in `column_families` are skipped. The warmer must be
+   destroyed before the DB is closed; destroying it stops the warm-up. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_block_cache_warmer_t*
+crocksdb_block_cache_warmup_start(
+    crocksdb_t* db, crocksdb_column_family_handle_t** column_families,
+    size_t num_column_families, const char* path,
+    crocksdb_ratelimiter_t* limiter, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_block_cache_warmer_destroy(
+    crocksdb_block_cache_warmer_t* warmer);
+extern C_ROCKSDB_LIBRARY_API unsigned char crocksdb_block_cache_warmer_is_done(
+    crocksdb_block_cache_warmer_t* warmer);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_block_cache_warmer_keys_total(
+    crocksdb_block_cache_warmer_t* warmer);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_block_cache_warmer_keys_loaded(
+    crocksdb_block_cache_warmer_t* warmer);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_block_cache_warmer_bytes_loaded(
+    crocksdb_block_cache_warmer_t* warmer);
+
+/* Block cache trace */
+
+/* Traces block cache accesses of the DB into `trace_path`. One in
+   `sampling_frequency` requests is traced; tracing stops once the file
+   reaches `max_trace_file_size` bytes. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_start_block_cache_trace(
+    crocksdb_t* db, const char* trace_path, uint64_t sampling_frequency,
+    uint64_t max_trace_file_size, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_end_block_cache_trace(
+    crocksdb_t* db, char** errptr);
+
+/* Replays a block cache trace against simulated caches, all in one pass.
+   Caches are numbered in the order they are added. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_block_cache_simulator_t*
+crocksdb_block_cache_simulator_create();
+extern C_ROCKSDB_LIBRARY_API void crocksdb_block_cache_simulator_destroy(
+    crocksdb_block_cache_simulator_t* simulator);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_block_cache_simulator_add_lru_cache(
+    crocksdb_block_cache_simulator_t* simulator, size_t capacity,
+    int num_shard_bits);
+extern C_ROCKSDB_LIBRARY_API void
+crocksdb_block_cache_simulator_add_clock_cache(
+    crocksdb_block_cache_simulator_t* simulator, size_t capacity,
+    int num_shard_bits, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_block_cache_simulator_run(
+    crocksdb_block_cache_simulator_t* simulator, const char* trace_path,
+    char** errptr);
+extern C_ROCKSDB_LIBRARY_API uint64_t
+crocksdb_block_cache_simulator_num_accesses(
+    crocksdb_block_cache_simulator_t* simulator);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_block_cache_simulator_num_misses(
+    crocksdb_block_cache_simulator_t* simulator, size_t index);
+
+/* Query trace */
+
+/* Traces Get, Seek and Write requests of the DB into `trace_path`. One in
+   `sampling_frequency` requests is traced; tracing stops once the file
+   reaches `max_trace_file_size` bytes. Fails with Busy while a block cache
+   recording runs, as both use the DB tracer. */
+extern C_ROCKSDB_LIBRARY_API void crocksdb_start_trace(
+    crocksdb_t* db, const char* trace_path, uint64_t sampling_frequency,
+    uint64_t max_trace_file_size, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_end_trace(crocksdb_t* db,
+                                                     char** errptr);
+
+/* Replays a query trace against `db`. Requests of column families not in
+   `column_families` are skipped, except writes. A speed of 1.0 keeps the
+   original timing, 2.0 replays twice as fast and 0 as fast as possible.
+   Latencies are kept per op type: 0 for Get, 1 for Seek, 2 for Write. */
+extern C_ROCKSDB_LIBRARY_API crocksdb_trace_replayer_t*
+crocksdb_trace_replayer_create(
+    crocksdb_t* db, crocksdb_column_family_handle_t** column_families,
+    size_t num_column_families, const char* trace_path, char** errptr);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_trace_replayer_destroy(
+    crocksdb_trace_replayer_t* replayer);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_trace_replayer_set_speed(
+    crocksdb_trace_replayer_t* replayer, double speed);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_trace_replayer_set_threads(
+    crocksdb_trace_replayer_t* replayer, int num_threads);
+extern C_ROCKSDB_LIBRARY_API void crocksdb_trace_replayer_replay(
+    crocksdb_trace_replayer_t* replayer, char** errptr);
+extern C_ROCKSDB_LIBRARY_API uint64_t crocksdb_trace_replayer_get_num_ops(
+    crocksdb_trace_replayer_t* replayer, int op_type);
+extern C_ROCKSDB_LIBRARY_API unsigned char
+crocksdb_trace_replayer_get_histogram(crocksdb_trace_replayer_t* replayer,
+                                      int op_type, double* median,
+                                      double* percentile95,
+                                      double* percentile99, double* average,
+                                      double* standard_deviation, double* max);
+
 extern C_ROCKSDB_LIBRARY_API void crocksdb_run_ldb_tool(
     int argc, char** argv, const crocksdb_options_t* opts);
 extern C_ROCKSDB_LIBRARY_API void crocksdb_run_sst_dump_tool(
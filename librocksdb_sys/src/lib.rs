@@ -64,6 +64,10 @@ pub struct DBLRUCacheOptions(c_void);
 #[repr(C)]
 pub struct DBCache(c_void);
 #[repr(C)]
+pub struct DBWriteBufferManager(c_void);
+#[repr(C)]
+pub struct DBPersistentCache(c_void);
+#[repr(C)]
 pub struct DBFilterPolicy(c_void);
 #[repr(C)]
 pub struct DBSnapshot(c_void);
@@ -93,12 +97,18 @@ pub struct SstFileWriter(c_void);
 #[repr(C)]
 pub struct ExternalSstFileInfo(c_void);
 #[repr(C)]
+pub struct ParallelSstFileWriter(c_void);
+#[repr(C)]
+pub struct DBSnapshotExporter(c_void);
+#[repr(C)]
 pub struct IngestExternalFileOptions(c_void);
 #[repr(C)]
 pub struct DBBackupEngine(c_void);
 #[repr(C)]
 pub struct DBRestoreOptions(c_void);
 #[repr(C)]
+pub struct DBBackupableDBOptions(c_void);
+#[repr(C)]
 pub struct DBSliceTransform(c_void);
 #[repr(C)]
 pub struct DBRateLimiter(c_void);
@@ -147,6 +157,14 @@ pub struct DBLevelMetaData(c_void);
 #[repr(C)]
 pub struct DBSstFileMetaData(c_void);
 #[repr(C)]
+pub struct DBExportImportFilesMetaData(c_void);
+#[repr(C)]
+pub struct DBLiveFiles(c_void);
+#[repr(C)]
+pub struct DBLiveFilesDiff(c_void);
+#[repr(C)]
+pub struct DBOpenProfile(c_void);
+#[repr(C)]
 pub struct DBCompactionOptions(c_void);
 #[repr(C)]
 pub struct DBPerfContext(c_void);
@@ -176,6 +194,14 @@ pub struct DBSstPartitionerFactory(c_void);
 pub struct DBWriteBatchIterator(c_void);
 #[repr(C)]
 pub struct DBFileSystemInspectorInstance(c_void);
+#[repr(C)]
+pub struct DBBlockCacheRecorder(c_void);
+#[repr(C)]
+pub struct DBBlockCacheWarmer(c_void);
+#[repr(C)]
+pub struct DBBlockCacheSimulator(c_void);
+#[repr(C)]
+pub struct DBTraceReplayer(c_void);
 
 #[derive(Copy, Clone, Debug, Eq, PartialEq)]
 #[repr(C)]
@@ -239,6 +265,13 @@ pub enum DBCompressionType {
     Disable = 0xff,
 }
 
+#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+#[repr(C)]
+pub enum DBFileChecksumType {
+    Crc32c = 1,
+    XXH64 = 2,
+}
+
 #[derive(Copy, Clone, Debug, Eq, PartialEq)]
 #[repr(C)]
 pub enum DBCompactionStyle {
@@ -264,6 +297,15 @@ pub enum DBRecoveryMode {
     SkipAnyCorruptedRecords = 3,
 }
 
+#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+#[repr(C)]
+pub enum DBOpenPhase {
+    ManifestReplay = 0,
+    TableOpening = 1,
+    WalRecovery = 2,
+    OptionsPersistence = 3,
+}
+
 #[derive(Copy, Clone, Debug, Eq, PartialEq)]
 #[repr(C)]
 pub enum CompactionPriority {
@@ -382,6 +424,14 @@ pub enum DBRateLimiterMode {
     AllIo = 3,
 }
 
+#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+#[repr(C)]
+pub enum DBTraceOpType {
+    Get = 0,
+    Seek = 1,
+    Write = 2,
+}
+
 #[derive(Copy, Clone, Debug, Eq, PartialEq)]
 #[repr(C)]
 pub enum DBTitanDBBlobRunMode {
@@ -398,6 +448,15 @@ pub enum IndexType {
     TwoLevelIndexSearch = 2,
 }
 
+#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+#[repr(C)]
+pub enum DBChecksumType {
+    NoChecksum = 0,
+    CRC32c = 1,
+    XXHash = 2,
+    XXHash64 = 3,
+}
+
 #[derive(Copy, Clone, Debug, Eq, PartialEq)]
 #[repr(C)]
 pub enum DBBackgroundErrorReason {
@@ -566,8 +625,47 @@ extern "C" {
         opt: *mut DBLRUCacheOptions,
         allocator: *mut DBMemoryAllocator,
     );
+    pub fn crocksdb_lru_cache_options_set_compressed_secondary_capacity(
+        opt: *mut DBLRUCacheOptions,
+        capacity: size_t,
+    );
+    pub fn crocksdb_lru_cache_options_set_compressed_secondary_num_shard_bits(
+        opt: *mut DBLRUCacheOptions,
+        num_shard_bits: c_int,
+    );
+    pub fn crocksdb_lru_cache_options_set_persistent_cache(
+        opt: *mut DBLRUCacheOptions,
+        cache: *mut DBPersistentCache,
+    );
     pub fn crocksdb_cache_create_lru(opt: *mut DBLRUCacheOptions) -> *mut DBCache;
     pub fn crocksdb_cache_destroy(cache: *mut DBCache);
+    pub fn crocksdb_cache_get_usage(cache: *mut DBCache) -> size_t;
+    pub fn crocksdb_cache_get_compressed_secondary_usage(cache: *mut DBCache) -> size_t;
+    pub fn crocksdb_cache_get_compressed_secondary_capacity(cache: *mut DBCache) -> size_t;
+
+    // WriteBufferManager
+    pub fn crocksdb_write_buffer_manager_create(
+        buffer_size: size_t,
+        cache: *mut DBCache,
+    ) -> *mut DBWriteBufferManager;
+    pub fn crocksdb_write_buffer_manager_destroy(manager: *mut DBWriteBufferManager);
+    pub fn crocksdb_write_buffer_manager_buffer_size(manager: *mut DBWriteBufferManager) -> size_t;
+    pub fn crocksdb_write_buffer_manager_memory_usage(manager: *mut DBWriteBufferManager)
+        -> size_t;
+    pub fn crocksdb_write_buffer_manager_mutable_memtable_memory_usage(
+        manager: *mut DBWriteBufferManager,
+    ) -> size_t;
+    pub fn crocksdb_write_buffer_manager_cost_to_cache(manager: *mut DBWriteBufferManager) -> bool;
+    pub fn crocksdb_write_buffer_manager_should_flush(manager: *mut DBWriteBufferManager) -> bool;
+
+    // Persistent Cache
+    pub fn crocksdb_persistent_cache_create(
+        path: *const c_char,
+        size: u64,
+        optimized_for_nvm: bool,
+        err: *mut *mut c_char,
+    ) -> *mut DBPersistentCache;
+    pub fn crocksdb_persistent_cache_destroy(cache: *mut DBPersistentCache);
 
     pub fn crocksdb_block_based_options_create() -> *mut DBBlockBasedTableOptions;
     pub fn crocksdb_block_based_options_destroy(opts: *mut DBBlockBasedTableOptions);
@@ -591,6 +689,10 @@ extern "C" {
         block_options: *mut DBBlockBasedTableOptions,
         v: IndexType,
     );
+    pub fn crocksdb_block_based_options_set_checksum(
+        block_options: *mut DBBlockBasedTableOptions,
+        v: DBChecksumType,
+    );
     pub fn crocksdb_block_based_options_set_hash_index_allow_collision(
         block_options: *mut DBBlockBasedTableOptions,
         v: c_uchar,
@@ -660,6 +762,17 @@ extern "C" {
     pub fn crocksdb_options_set_create_if_missing(options: *mut Options, v: bool);
     pub fn crocksdb_options_set_create_missing_column_families(options: *mut Options, v: bool);
     pub fn crocksdb_options_set_max_open_files(options: *mut Options, files: c_int);
+    pub fn crocksdb_options_set_max_file_opening_threads(options: *mut Options, n: c_int);
+    pub fn crocksdb_options_get_max_file_opening_threads(options: *mut Options) -> c_int;
+    pub fn crocksdb_options_set_skip_stats_update_on_db_open(options: *mut Options, v: bool);
+    pub fn crocksdb_options_get_skip_stats_update_on_db_open(options: *mut Options) -> bool;
+    pub fn crocksdb_options_set_skip_checking_sst_file_sizes_on_db_open(
+        options: *mut Options,
+        v: bool,
+    );
+    pub fn crocksdb_options_get_skip_checking_sst_file_sizes_on_db_open(
+        options: *mut Options,
+    ) -> bool;
     pub fn crocksdb_options_set_max_total_wal_size(options: *mut Options, size: u64);
     pub fn crocksdb_options_set_use_fsync(options: *mut Options, v: c_int);
     pub fn crocksdb_options_set_bytes_per_sync(options: *mut Options, bytes: u64);
@@ -691,6 +804,10 @@ extern "C" {
     pub fn crocksdb_options_get_level0_slowdown_writes_trigger(options: *mut Options) -> c_int;
     pub fn crocksdb_options_set_level0_stop_writes_trigger(options: *mut Options, no: c_int);
     pub fn crocksdb_options_get_level0_stop_writes_trigger(options: *mut Options) -> c_int;
+    pub fn crocksdb_options_set_write_buffer_manager(
+        options: *mut Options,
+        manager: *mut DBWriteBufferManager,
+    );
     pub fn crocksdb_options_set_write_buffer_size(options: *mut Options, bytes: u64);
     pub fn crocksdb_options_get_write_buffer_size(options: *mut Options) -> u64;
     pub fn crocksdb_options_set_target_file_size_base(options: *mut Options, bytes: u64);
@@ -770,6 +887,10 @@ extern "C" {
     pub fn crocksdb_options_set_report_bg_io_stats(options: *mut Options, v: c_int);
     pub fn crocksdb_options_set_compaction_readahead_size(options: *mut Options, v: size_t);
     pub fn crocksdb_options_set_wal_recovery_mode(options: *mut Options, mode: DBRecoveryMode);
+    pub fn crocksdb_options_set_avoid_flush_during_recovery(options: *mut Options, v: bool);
+    pub fn crocksdb_options_get_avoid_flush_during_recovery(options: *mut Options) -> bool;
+    pub fn crocksdb_options_set_avoid_flush_during_shutdown(options: *mut Options, v: bool);
+    pub fn crocksdb_options_get_avoid_flush_during_shutdown(options: *mut Options) -> bool;
     pub fn crocksdb_options_set_max_subcompactions(options: *mut Options, v: u32);
     pub fn crocksdb_options_set_wal_bytes_per_sync(options: *mut Options, v: u64);
     pub fn crocksdb_options_enable_statistics(options: *mut Options, v: bool);
@@ -833,6 +954,10 @@ extern "C" {
     pub fn crocksdb_options_set_force_consistency_checks(options: *mut Options, v: bool);
     pub fn crocksdb_options_get_force_consistency_checks(options: *mut Options) -> bool;
     pub fn crocksdb_options_set_ratelimiter(options: *mut Options, limiter: *mut DBRateLimiter);
+    pub fn crocksdb_options_set_shared_ratelimiter(
+        options: *mut Options,
+        limiter: *mut DBRateLimiter,
+    );
     pub fn crocksdb_options_get_ratelimiter(options: *mut Options) -> *mut DBRateLimiter;
     pub fn crocksdb_options_set_info_log(options: *mut Options, logger: *mut DBLogger);
     pub fn crocksdb_options_get_block_cache_usage(options: *const Options) -> usize;
@@ -870,6 +995,14 @@ extern "C" {
         mode: DBRateLimiterMode,
         auto_tuned: bool,
     ) -> *mut DBRateLimiter;
+    pub fn crocksdb_priority_ratelimiter_create(
+        rate_bytes_per_sec: i64,
+        refill_period_us: i64,
+        user_weight: i32,
+        mid_weight: i32,
+        low_weight: i32,
+        mode: DBRateLimiterMode,
+    ) -> *mut DBRateLimiter;
     pub fn crocksdb_ratelimiter_destroy(limiter: *mut DBRateLimiter);
     pub fn crocksdb_ratelimiter_set_bytes_per_second(
         limiter: *mut DBRateLimiter,
@@ -888,6 +1021,10 @@ extern "C" {
         limiter: *mut DBRateLimiter,
         pri: c_uchar,
     ) -> i64;
+    pub fn crocksdb_ratelimiter_get_total_wait_micros(
+        limiter: *mut DBRateLimiter,
+        pri: c_uchar,
+    ) -> u64;
     pub fn crocksdb_options_set_soft_pending_compaction_bytes_limit(options: *mut Options, v: u64);
     pub fn crocksdb_options_get_soft_pending_compaction_bytes_limit(options: *mut Options) -> u64;
     pub fn crocksdb_options_set_hard_pending_compaction_bytes_limit(options: *mut Options, v: u64);
@@ -905,6 +1042,8 @@ extern "C" {
     pub fn crocksdb_options_get_path_target_size(options: *mut Options, idx: size_t) -> u64;
     pub fn crocksdb_options_set_vector_memtable_factory(options: *mut Options, reserved_bytes: u64);
     pub fn crocksdb_options_set_atomic_flush(option: *mut Options, enable: bool);
+    pub fn crocksdb_options_set_allow_ingest_behind(option: *mut Options, v: bool);
+    pub fn crocksdb_options_get_allow_ingest_behind(option: *mut Options) -> bool;
     pub fn crocksdb_options_get_sst_partitioner_factory(
         option: *mut Options,
     ) -> *mut DBSstPartitionerFactory;
@@ -931,6 +1070,13 @@ extern "C" {
         error_if_log_file_exist: bool,
         err: *mut *mut c_char,
     ) -> *mut DBInstance;
+    pub fn crocksdb_open_as_secondary(
+        options: *mut Options,
+        path: *const c_char,
+        secondary_path: *const c_char,
+        err: *mut *mut c_char,
+    ) -> *mut DBInstance;
+    pub fn crocksdb_try_catch_up_with_primary(db: *mut DBInstance, err: *mut *mut c_char);
     pub fn crocksdb_writeoptions_create() -> *mut DBWriteOptions;
     pub fn crocksdb_writeoptions_destroy(writeopts: *mut DBWriteOptions);
     pub fn crocksdb_writeoptions_set_sync(writeopts: *mut DBWriteOptions, v: bool);
@@ -1324,6 +1470,41 @@ extern "C" {
         column_family_handles: *const *mut DBCFHandle,
         err: *mut *mut c_char,
     ) -> *mut DBInstance;
+    pub fn crocksdb_open_column_families_with_profile(
+        options: *const Options,
+        path: *const c_char,
+        num_column_families: c_int,
+        column_family_names: *const *const c_char,
+        column_family_options: *const *const Options,
+        column_family_handles: *const *mut DBCFHandle,
+        profile: *mut DBOpenProfile,
+        err: *mut *mut c_char,
+    ) -> *mut DBInstance;
+    pub fn crocksdb_open_profile_create() -> *mut DBOpenProfile;
+    pub fn crocksdb_open_profile_destroy(profile: *mut DBOpenProfile);
+    pub fn crocksdb_open_profile_duration_micros(
+        profile: *const DBOpenProfile,
+        phase: DBOpenPhase,
+    ) -> u64;
+    pub fn crocksdb_open_profile_file_count(
+        profile: *const DBOpenProfile,
+        phase: DBOpenPhase,
+    ) -> u64;
+    pub fn crocksdb_open_profile_total_micros(profile: *const DBOpenProfile) -> u64;
+    pub fn crocksdb_open_profile_wal_recovered_entries(profile: *const DBOpenProfile) -> u64;
+    pub fn crocksdb_open_profile_wal_file_count(profile: *const DBOpenProfile) -> size_t;
+    pub fn crocksdb_open_profile_wal_file_name(
+        profile: *const DBOpenProfile,
+        index: size_t,
+    ) -> *const c_char;
+    pub fn crocksdb_open_profile_wal_file_bytes(
+        profile: *const DBOpenProfile,
+        index: size_t,
+    ) -> u64;
+    pub fn crocksdb_open_profile_wal_file_micros(
+        profile: *const DBOpenProfile,
+        index: size_t,
+    ) -> u64;
     pub fn crocksdb_open_column_families_with_ttl(
         options: *const Options,
         path: *const c_char,
@@ -1345,6 +1526,16 @@ extern "C" {
         error_if_log_file_exist: bool,
         err: *mut *mut c_char,
     ) -> *mut DBInstance;
+    pub fn crocksdb_open_as_secondary_column_families(
+        options: *const Options,
+        path: *const c_char,
+        secondary_path: *const c_char,
+        num_column_families: c_int,
+        column_family_names: *const *const c_char,
+        column_family_options: *const *const Options,
+        column_family_handles: *const *mut DBCFHandle,
+        err: *mut *mut c_char,
+    ) -> *mut DBInstance;
     pub fn crocksdb_create_column_family(
         db: *mut DBInstance,
         column_family_options: *const Options,
@@ -1395,6 +1586,36 @@ extern "C" {
 
     pub fn crocksdb_get_latest_sequence_number(db: *mut DBInstance) -> u64;
 
+    pub fn crocksdb_livefiles_diff(
+        db: *mut DBInstance,
+        since: *const DBLiveFilesDiff,
+        err: *mut *mut c_char,
+    ) -> *mut DBLiveFilesDiff;
+    pub fn crocksdb_livefiles_diff_added(diff: *const DBLiveFilesDiff) -> *const DBLiveFiles;
+    pub fn crocksdb_livefiles_diff_removed(diff: *const DBLiveFilesDiff) -> *const DBLiveFiles;
+    pub fn crocksdb_livefiles_diff_release_files(diff: *mut DBLiveFilesDiff);
+    pub fn crocksdb_livefiles_diff_destroy(diff: *mut DBLiveFilesDiff);
+    pub fn crocksdb_livefiles_count(lf: *const DBLiveFiles) -> c_int;
+    pub fn crocksdb_livefiles_name(lf: *const DBLiveFiles, index: c_int) -> *const c_char;
+    pub fn crocksdb_livefiles_level(lf: *const DBLiveFiles, index: c_int) -> c_int;
+    pub fn crocksdb_livefiles_size(lf: *const DBLiveFiles, index: c_int) -> size_t;
+    pub fn crocksdb_livefiles_smallestkey(
+        lf: *const DBLiveFiles,
+        index: c_int,
+        size: *mut size_t,
+    ) -> *const u8;
+    pub fn crocksdb_livefiles_largestkey(
+        lf: *const DBLiveFiles,
+        index: c_int,
+        size: *mut size_t,
+    ) -> *const u8;
+    pub fn crocksdb_livefiles_smallest_seqno(lf: *const DBLiveFiles, index: c_int) -> u64;
+    pub fn crocksdb_livefiles_largest_seqno(lf: *const DBLiveFiles, index: c_int) -> u64;
+    pub fn crocksdb_livefiles_column_family_name(
+        lf: *const DBLiveFiles,
+        index: c_int,
+    ) -> *const c_char;
+
     pub fn crocksdb_approximate_sizes(
         db: *mut DBInstance,
         num_ranges: c_int,
@@ -1657,6 +1878,13 @@ extern "C" {
         opt: *mut IngestExternalFileOptions,
         write_global_seqno: bool,
     );
+    pub fn crocksdb_ingestexternalfileoptions_get_ingest_behind(
+        opt: *const IngestExternalFileOptions,
+    ) -> bool;
+    pub fn crocksdb_ingestexternalfileoptions_set_ingest_behind(
+        opt: *mut IngestExternalFileOptions,
+        ingest_behind: bool,
+    );
     pub fn crocksdb_ingestexternalfileoptions_destroy(opt: *mut IngestExternalFileOptions);
 
     // KeyManagedEncryptedEnv
@@ -1714,6 +1942,24 @@ extern "C" {
         link_file: extern "C" fn(*mut c_void, *const c_char, *const c_char) -> *const c_char,
     ) -> *mut DBEncryptionKeyManagerInstance;
     #[cfg(feature = "encryption")]
+    pub fn crocksdb_encryption_key_manager_create_with_cache(
+        state: *mut c_void,
+        destructor: extern "C" fn(*mut c_void),
+        get_file: extern "C" fn(
+            *mut c_void,
+            *const c_char,
+            *mut DBFileEncryptionInfo,
+        ) -> *const c_char,
+        new_file: extern "C" fn(
+            *mut c_void,
+            *const c_char,
+            *mut DBFileEncryptionInfo,
+        ) -> *const c_char,
+        delete_file: extern "C" fn(*mut c_void, *const c_char) -> *const c_char,
+        link_file: extern "C" fn(*mut c_void, *const c_char, *const c_char) -> *const c_char,
+        num_shard_bits: c_int,
+    ) -> *mut DBEncryptionKeyManagerInstance;
+    #[cfg(feature = "encryption")]
     pub fn crocksdb_encryption_key_manager_destroy(
         key_manager: *mut DBEncryptionKeyManagerInstance,
     );
@@ -1746,6 +1992,14 @@ extern "C" {
         base_env: *mut DBEnv,
         key_manager: *mut DBEncryptionKeyManagerInstance,
     ) -> *mut DBEnv;
+    #[cfg(feature = "encryption")]
+    pub fn crocksdb_aes_ctr_encrypted_env_create(
+        base_env: *mut DBEnv,
+        method: DBEncryptionMethod,
+        key: *const c_char,
+        keylen: size_t,
+        err: *mut *mut c_char,
+    ) -> *mut DBEnv;
 
     // FileSystemInspectedEnv
     pub fn crocksdb_file_system_inspector_create(
@@ -1766,6 +2020,23 @@ extern "C" {
         errptr: *mut *mut c_char,
     ) -> size_t;
 
+    pub fn crocksdb_token_bucket_file_system_inspector_create(
+        state: *mut c_void,
+        destructor: extern "C" fn(*mut c_void),
+        refill_read: extern "C" fn(*mut c_void, size_t, *mut *mut c_char) -> size_t,
+        refill_write: extern "C" fn(*mut c_void, size_t, *mut *mut c_char) -> size_t,
+        refill_period_us: u64,
+    ) -> *mut DBFileSystemInspectorInstance;
+    pub fn crocksdb_file_system_inspector_get_read_throttled_micros(
+        inspector: *mut DBFileSystemInspectorInstance,
+    ) -> u64;
+    pub fn crocksdb_file_system_inspector_get_write_throttled_micros(
+        inspector: *mut DBFileSystemInspectorInstance,
+    ) -> u64;
+    pub fn crocksdb_file_system_inspector_get_refill_count(
+        inspector: *mut DBFileSystemInspectorInstance,
+    ) -> u64;
+
     pub fn crocksdb_file_system_inspected_env_create(
         base_env: *mut DBEnv,
         inspector: *mut DBFileSystemInspectorInstance,
@@ -1808,6 +2079,13 @@ extern "C" {
         io_options: *const Options,
         cf: *mut DBCFHandle,
     ) -> *mut SstFileWriter;
+    pub fn crocksdb_sstfilewriter_create_with_file_checksum(
+        env: *mut EnvOptions,
+        io_options: *const Options,
+        cf: *mut DBCFHandle,
+        checksum_type: DBFileChecksumType,
+        err: *mut *mut c_char,
+    ) -> *mut SstFileWriter;
     pub fn crocksdb_sstfilewriter_open(
         writer: *mut SstFileWriter,
         name: *const c_char,
@@ -1851,6 +2129,102 @@ extern "C" {
     pub fn crocksdb_sstfilewriter_file_size(writer: *mut SstFileWriter) -> u64;
     pub fn crocksdb_sstfilewriter_destroy(writer: *mut SstFileWriter);
 
+    pub fn crocksdb_parallel_sstfilewriter_create(
+        env: *mut EnvOptions,
+        io_options: *const Options,
+        cf: *mut DBCFHandle,
+        path_prefix: *const c_char,
+        target_file_size: u64,
+        num_threads: c_int,
+    ) -> *mut ParallelSstFileWriter;
+    pub fn crocksdb_parallel_sstfilewriter_put(
+        writer: *mut ParallelSstFileWriter,
+        key: *const u8,
+        key_len: size_t,
+        val: *const u8,
+        val_len: size_t,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_parallel_sstfilewriter_merge(
+        writer: *mut ParallelSstFileWriter,
+        key: *const u8,
+        key_len: size_t,
+        val: *const u8,
+        val_len: size_t,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_parallel_sstfilewriter_delete(
+        writer: *mut ParallelSstFileWriter,
+        key: *const u8,
+        key_len: size_t,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_parallel_sstfilewriter_delete_range(
+        writer: *mut ParallelSstFileWriter,
+        begin_key: *const u8,
+        begin_key_len: size_t,
+        end_key: *const u8,
+        end_key_len: size_t,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_parallel_sstfilewriter_cut(
+        writer: *mut ParallelSstFileWriter,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_parallel_sstfilewriter_finish(
+        writer: *mut ParallelSstFileWriter,
+        err: *mut *mut c_char,
+    ) -> size_t;
+    pub fn crocksdb_parallel_sstfilewriter_get_file_info(
+        writer: *mut ParallelSstFileWriter,
+        index: size_t,
+        info: *mut ExternalSstFileInfo,
+    );
+    pub fn crocksdb_parallel_sstfilewriter_destroy(writer: *mut ParallelSstFileWriter);
+
+    pub fn crocksdb_snapshot_exporter_create(
+        db: *mut DBInstance,
+        snapshot: *const DBSnapshot,
+        dir: *const c_char,
+        num_threads: c_int,
+    ) -> *mut DBSnapshotExporter;
+    pub fn crocksdb_snapshot_exporter_set_target_file_size(
+        exporter: *mut DBSnapshotExporter,
+        target_file_size: u64,
+    );
+    pub fn crocksdb_snapshot_exporter_set_rate_limiter(
+        exporter: *mut DBSnapshotExporter,
+        limiter: *mut DBRateLimiter,
+    );
+    pub fn crocksdb_snapshot_exporter_add_range(
+        exporter: *mut DBSnapshotExporter,
+        cf: *mut DBCFHandle,
+        start_key: *const u8,
+        start_key_len: size_t,
+        end_key: *const u8,
+        end_key_len: size_t,
+    ) -> size_t;
+    pub fn crocksdb_snapshot_exporter_run(exporter: *mut DBSnapshotExporter, err: *mut *mut c_char);
+    pub fn crocksdb_snapshot_exporter_range_file_count(
+        exporter: *const DBSnapshotExporter,
+        range: size_t,
+    ) -> size_t;
+    pub fn crocksdb_snapshot_exporter_range_file_info(
+        exporter: *const DBSnapshotExporter,
+        range: size_t,
+        index: size_t,
+        info: *mut ExternalSstFileInfo,
+    );
+    pub fn crocksdb_snapshot_exporter_range_num_keys(
+        exporter: *const DBSnapshotExporter,
+        range: size_t,
+    ) -> u64;
+    pub fn crocksdb_snapshot_exporter_range_num_bytes(
+        exporter: *const DBSnapshotExporter,
+        range: size_t,
+    ) -> u64;
+    pub fn crocksdb_snapshot_exporter_destroy(exporter: *mut DBSnapshotExporter);
+
     // ExternalSstFileInfo
     pub fn crocksdb_externalsstfileinfo_create() -> *mut ExternalSstFileInfo;
     pub fn crocksdb_externalsstfileinfo_destroy(info: *mut ExternalSstFileInfo);
@@ -1869,6 +2243,21 @@ extern "C" {
     pub fn crocksdb_externalsstfileinfo_sequence_number(info: *mut ExternalSstFileInfo) -> u64;
     pub fn crocksdb_externalsstfileinfo_file_size(info: *mut ExternalSstFileInfo) -> u64;
     pub fn crocksdb_externalsstfileinfo_num_entries(info: *mut ExternalSstFileInfo) -> u64;
+    pub fn crocksdb_externalsstfileinfo_file_checksum(
+        info: *mut ExternalSstFileInfo,
+        size: *mut size_t,
+    ) -> *const u8;
+    pub fn crocksdb_externalsstfileinfo_file_checksum_func_name(
+        info: *mut ExternalSstFileInfo,
+    ) -> *const c_char;
+    pub fn crocksdb_verify_file_checksum(
+        env: *mut DBEnv,
+        path: *const c_char,
+        checksum_type: DBFileChecksumType,
+        expected: *const u8,
+        expected_len: size_t,
+        err: *mut *mut c_char,
+    );
 
     pub fn crocksdb_ingest_external_file(
         db: *mut DBInstance,
@@ -1893,14 +2282,80 @@ extern "C" {
         opt: *const IngestExternalFileOptions,
         err: *mut *mut c_char,
     ) -> bool;
+    pub fn crocksdb_ingest_external_files(
+        db: *mut DBInstance,
+        handles: *const *const DBCFHandle,
+        file_lists: *const *const *const c_char,
+        list_lens: *const size_t,
+        opts: *const *const IngestExternalFileOptions,
+        num_cfs: size_t,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_ingest_external_files_optimized(
+        db: *mut DBInstance,
+        handles: *const *const DBCFHandle,
+        file_lists: *const *const *const c_char,
+        list_lens: *const size_t,
+        opts: *const *const IngestExternalFileOptions,
+        num_cfs: size_t,
+        err: *mut *mut c_char,
+    ) -> bool;
 
     // Restore Option
     pub fn crocksdb_restore_options_create() -> *mut DBRestoreOptions;
     pub fn crocksdb_restore_options_destroy(ropts: *mut DBRestoreOptions);
     pub fn crocksdb_restore_options_set_keep_log_files(ropts: *mut DBRestoreOptions, v: c_int);
 
+    // BackupableDBOptions
+    pub fn crocksdb_backupable_db_options_create(
+        backup_dir: *const c_char,
+    ) -> *mut DBBackupableDBOptions;
+    pub fn crocksdb_backupable_db_options_destroy(opt: *mut DBBackupableDBOptions);
+    pub fn crocksdb_backupable_db_options_set_share_table_files(
+        opt: *mut DBBackupableDBOptions,
+        v: bool,
+    );
+    pub fn crocksdb_backupable_db_options_set_share_files_with_checksum(
+        opt: *mut DBBackupableDBOptions,
+        v: bool,
+    );
+    pub fn crocksdb_backupable_db_options_set_sync(opt: *mut DBBackupableDBOptions, v: bool);
+    pub fn crocksdb_backupable_db_options_set_backup_log_files(
+        opt: *mut DBBackupableDBOptions,
+        v: bool,
+    );
+    pub fn crocksdb_backupable_db_options_set_max_background_operations(
+        opt: *mut DBBackupableDBOptions,
+        v: c_int,
+    );
+    pub fn crocksdb_backupable_db_options_set_callback_trigger_interval_size(
+        opt: *mut DBBackupableDBOptions,
+        v: u64,
+    );
+    pub fn crocksdb_backupable_db_options_set_backup_rate_limiter(
+        opt: *mut DBBackupableDBOptions,
+        limiter: *mut DBRateLimiter,
+    );
+    pub fn crocksdb_backupable_db_options_set_restore_rate_limiter(
+        opt: *mut DBBackupableDBOptions,
+        limiter: *mut DBRateLimiter,
+    );
+
     // Backup engine
     // TODO: add more ffis about backup engine.
+    pub fn crocksdb_backup_engine_open_opt(
+        options: *const Options,
+        backup_options: *const DBBackupableDBOptions,
+        err: *mut *mut c_char,
+    ) -> *mut DBBackupEngine;
+    pub fn crocksdb_backup_engine_create_new_backup_with_progress(
+        be: *mut DBBackupEngine,
+        db: *mut DBInstance,
+        flush_before_backup: bool,
+        ctx: *mut c_void,
+        progress: Option<extern "C" fn(*mut c_void)>,
+        err: *mut *mut c_char,
+    );
     pub fn crocksdb_backup_engine_open(
         options: *const Options,
         path: *const c_char,
@@ -1919,6 +2374,12 @@ extern "C" {
         ropts: *const DBRestoreOptions,
         err: *mut *mut c_char,
     );
+    pub fn crocksdb_create_checkpoint(
+        db: *mut DBInstance,
+        checkpoint_dir: *const c_char,
+        log_size_for_flush: u64,
+        err: *mut *mut c_char,
+    );
     // SliceTransform
     pub fn crocksdb_slicetransform_create(
         state: *mut c_void,
@@ -2259,6 +2720,80 @@ extern "C" {
         err: *mut *mut c_char,
     ) -> u64;
 
+    pub fn crocksdb_set_external_sst_files_global_seq_no(
+        db: *mut DBInstance,
+        handle: *mut DBCFHandle,
+        files: *const *const c_char,
+        seq_nos: *const u64,
+        num_files: size_t,
+        num_threads: c_int,
+        pre_seq_nos: *mut u64,
+        err: *mut *mut c_char,
+    );
+
+    pub fn crocksdb_export_column_family(
+        db: *mut DBInstance,
+        handle: *mut DBCFHandle,
+        export_dir: *const c_char,
+        err: *mut *mut c_char,
+    ) -> *mut DBExportImportFilesMetaData;
+    pub fn crocksdb_export_import_files_metadata_create(
+        dir: *const c_char,
+    ) -> *mut DBExportImportFilesMetaData;
+    pub fn crocksdb_export_import_files_metadata_destroy(
+        metadata: *mut DBExportImportFilesMetaData,
+    );
+    pub fn crocksdb_export_import_files_metadata_add_file(
+        metadata: *mut DBExportImportFilesMetaData,
+        name: *const c_char,
+        level: c_int,
+        smallest_seqno: u64,
+        largest_seqno: u64,
+    );
+    pub fn crocksdb_export_import_files_metadata_dir(
+        metadata: *const DBExportImportFilesMetaData,
+    ) -> *const c_char;
+    pub fn crocksdb_export_import_files_metadata_count(
+        metadata: *const DBExportImportFilesMetaData,
+    ) -> size_t;
+    pub fn crocksdb_export_import_files_metadata_name(
+        metadata: *const DBExportImportFilesMetaData,
+        index: size_t,
+    ) -> *const c_char;
+    pub fn crocksdb_export_import_files_metadata_level(
+        metadata: *const DBExportImportFilesMetaData,
+        index: size_t,
+    ) -> c_int;
+    pub fn crocksdb_export_import_files_metadata_size(
+        metadata: *const DBExportImportFilesMetaData,
+        index: size_t,
+    ) -> size_t;
+    pub fn crocksdb_export_import_files_metadata_smallestkey(
+        metadata: *const DBExportImportFilesMetaData,
+        index: size_t,
+        len: *mut size_t,
+    ) -> *const u8;
+    pub fn crocksdb_export_import_files_metadata_largestkey(
+        metadata: *const DBExportImportFilesMetaData,
+        index: size_t,
+        len: *mut size_t,
+    ) -> *const u8;
+    pub fn crocksdb_export_import_files_metadata_smallest_seqno(
+        metadata: *const DBExportImportFilesMetaData,
+        index: size_t,
+    ) -> u64;
+    pub fn crocksdb_export_import_files_metadata_largest_seqno(
+        metadata: *const DBExportImportFilesMetaData,
+        index: size_t,
+    ) -> u64;
+    pub fn crocksdb_create_column_family_with_import(
+        db: *mut DBInstance,
+        column_family_options: *const Options,
+        column_family_name: *const c_char,
+        metadata: *const DBExportImportFilesMetaData,
+        err: *mut *mut c_char,
+    ) -> *mut DBCFHandle;
+
     pub fn crocksdb_get_column_family_meta_data(
         db: *mut DBInstance,
         cf: *mut DBCFHandle,
@@ -2317,6 +2852,103 @@ extern "C" {
         errptr: *mut *mut c_char,
     );
 
+    pub fn crocksdb_block_cache_recorder_create(max_keys: size_t) -> *mut DBBlockCacheRecorder;
+    pub fn crocksdb_block_cache_recorder_destroy(recorder: *mut DBBlockCacheRecorder);
+    pub fn crocksdb_block_cache_recorder_count(recorder: *mut DBBlockCacheRecorder) -> size_t;
+    pub fn crocksdb_block_cache_recorder_save(
+        recorder: *mut DBBlockCacheRecorder,
+        path: *const c_char,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_start_block_cache_recording(
+        db: *mut DBInstance,
+        recorder: *mut DBBlockCacheRecorder,
+        sampling_frequency: u64,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_end_block_cache_recording(db: *mut DBInstance, err: *mut *mut c_char);
+    pub fn crocksdb_block_cache_warmup_start(
+        db: *mut DBInstance,
+        column_families: *const *mut DBCFHandle,
+        num_column_families: size_t,
+        path: *const c_char,
+        limiter: *mut DBRateLimiter,
+        err: *mut *mut c_char,
+    ) -> *mut DBBlockCacheWarmer;
+    pub fn crocksdb_block_cache_warmer_destroy(warmer: *mut DBBlockCacheWarmer);
+    pub fn crocksdb_block_cache_warmer_is_done(warmer: *mut DBBlockCacheWarmer) -> bool;
+    pub fn crocksdb_block_cache_warmer_keys_total(warmer: *mut DBBlockCacheWarmer) -> u64;
+    pub fn crocksdb_block_cache_warmer_keys_loaded(warmer: *mut DBBlockCacheWarmer) -> u64;
+    pub fn crocksdb_block_cache_warmer_bytes_loaded(warmer: *mut DBBlockCacheWarmer) -> u64;
+
+    pub fn crocksdb_start_block_cache_trace(
+        db: *mut DBInstance,
+        trace_path: *const c_char,
+        sampling_frequency: u64,
+        max_trace_file_size: u64,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_end_block_cache_trace(db: *mut DBInstance, err: *mut *mut c_char);
+    pub fn crocksdb_block_cache_simulator_create() -> *mut DBBlockCacheSimulator;
+    pub fn crocksdb_block_cache_simulator_destroy(simulator: *mut DBBlockCacheSimulator);
+    pub fn crocksdb_block_cache_simulator_add_lru_cache(
+        simulator: *mut DBBlockCacheSimulator,
+        capacity: size_t,
+        num_shard_bits: c_int,
+    );
+    pub fn crocksdb_block_cache_simulator_add_clock_cache(
+        simulator: *mut DBBlockCacheSimulator,
+        capacity: size_t,
+        num_shard_bits: c_int,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_block_cache_simulator_run(
+        simulator: *mut DBBlockCacheSimulator,
+        trace_path: *const c_char,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_block_cache_simulator_num_accesses(
+        simulator: *mut DBBlockCacheSimulator,
+    ) -> u64;
+    pub fn crocksdb_block_cache_simulator_num_misses(
+        simulator: *mut DBBlockCacheSimulator,
+        index: size_t,
+    ) -> u64;
+
+    pub fn crocksdb_start_trace(
+        db: *mut DBInstance,
+        trace_path: *const c_char,
+        sampling_frequency: u64,
+        max_trace_file_size: u64,
+        err: *mut *mut c_char,
+    );
+    pub fn crocksdb_end_trace(db: *mut DBInstance, err: *mut *mut c_char);
+    pub fn crocksdb_trace_replayer_create(
+        db: *mut DBInstance,
+        column_families: *const *mut DBCFHandle,
+        num_column_families: size_t,
+        trace_path: *const c_char,
+        err: *mut *mut c_char,
+    ) -> *mut DBTraceReplayer;
+    pub fn crocksdb_trace_replayer_destroy(replayer: *mut DBTraceReplayer);
+    pub fn crocksdb_trace_replayer_set_speed(replayer: *mut DBTraceReplayer, speed: f64);
+    pub fn crocksdb_trace_replayer_set_threads(replayer: *mut DBTraceReplayer, num_threads: c_int);
+    pub fn crocksdb_trace_replayer_replay(replayer: *mut DBTraceReplayer, err: *mut *mut c_char);
+    pub fn crocksdb_trace_replayer_get_num_ops(
+        replayer: *mut DBTraceReplayer,
+        op_type: DBTraceOpType,
+    ) -> u64;
+    pub fn crocksdb_trace_replayer_get_histogram(
+        replayer: *mut DBTraceReplayer,
+        op_type: DBTraceOpType,
+        median: *mut f64,
+        percentile95: *mut f64,
+        percentile99: *mut f64,
+        average: *mut f64,
+        standard_deviation: *mut f64,
+        max: *mut f64,
+    ) -> bool;
+
     pub fn crocksdb_get_perf_level() -> c_int;
     pub fn crocksdb_set_perf_level(level: c_int);
     pub fn crocksdb_get_perf_context() -> *mut DBPerfContext;
@@ -0,0 +1,112 @@
+// Copyright 2020 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Replays a block cache trace written by `DB::start_block_cache_trace`
+//! against simulated caches and prints the miss ratio of every combination
+//! of cache type, capacity and shard count, for plotting miss ratio curves.
+//!
+//! Usage:
+//!   block_cache_trace_analyzer <trace_file> [--cache_types=lru,clock]
+//!       [--capacities=64M,256M,1G] [--num_shard_bits=0,4,6]
+
+extern crate rocksdb;
+
+use std::env;
+use std::process;
+
+use rocksdb::BlockCacheSimulator;
+
+fn usage() -> ! {
+    eprintln!(
+        "usage: block_cache_trace_analyzer <trace_file> [--cache_types=lru,clock] \
+         [--capacities=64M,256M,1G] [--num_shard_bits=0,4,6]"
+    );
+    process::exit(1);
+}
+
+fn parse_size(s: &str) -> Option<usize> {
+    let (num, shift) = match s.chars().last()? {
+        'K' | 'k' => (&s[..s.len() - 1], 10),
+        'M' | 'm' => (&s[..s.len() - 1], 20),
+        'G' | 'g' => (&s[..s.len() - 1], 30),
+        _ => (s, 0),
+    };
+    num.parse::<usize>().ok().map(|n| n << shift)
+}
+
+fn parse_list<T, F: Fn(&str) -> Option<T>>(s: &str, f: F) -> Vec<T> {
+    s.split(',')
+        .map(|v| f(v.trim()).unwrap_or_else(|| usage()))
+        .collect()
+}
+
+fn main() {
+    let mut trace_path = None;
+    let mut cache_types = vec!["lru".to_owned()];
+    let mut capacities = vec![64 << 20, 256 << 20, 1 << 30];
+    let mut num_shard_bits = vec![6];
+    for arg in env::args().skip(1) {
+        if let Some(v) = arg.strip_prefix("--cache_types=") {
+            cache_types = parse_list(v, |t| match t {
+                "lru" | "clock" => Some(t.to_owned()),
+                _ => None,
+            });
+        } else if let Some(v) = arg.strip_prefix("--capacities=") {
+            capacities = parse_list(v, parse_size);
+        } else if let Some(v) = arg.strip_prefix("--num_shard_bits=") {
+            num_shard_bits = parse_list(v, |b| b.parse().ok());
+        } else if arg.starts_with("--") || trace_path.is_some() {
+            usage();
+        } else {
+            trace_path = Some(arg);
+        }
+    }
+    let trace_path = trace_path.unwrap_or_else(|| usage());
+
+    let mut simulator = BlockCacheSimulator::new();
+    let mut configs = vec![];
+    for cache_type in &cache_types {
+        for &capacity in &capacities {
+            for &bits in &num_shard_bits {
+                let index = if cache_type == "clock" {
+                    simulator
+                        .add_clock_cache(capacity, bits)
+                        .unwrap_or_else(|e| {
+                            eprintln!("{}", e);
+                            process::exit(1);
+                        })
+                } else {
+                    simulator.add_lru_cache(capacity, bits)
+                };
+                configs.push((index, cache_type, capacity, bits));
+            }
+        }
+    }
+    if let Err(e) = simulator.run(&trace_path) {
+        eprintln!("failed to replay {}: {}", trace_path, e);
+        process::exit(1);
+    }
+
+    println!("accesses: {}", simulator.num_accesses());
+    println!("cache_type,capacity,num_shard_bits,misses,miss_ratio");
+    for (index, cache_type, capacity, bits) in configs {
+        println!(
+            "{},{},{},{},{:.4}",
+            cache_type,
+            capacity,
+            bits,
+            simulator.num_misses(index),
+            simulator.miss_ratio(index)
+        );
+    }
+}
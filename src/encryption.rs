@@ -205,6 +205,31 @@ impl DBEncryptionKeyManager {
         };
         DBEncryptionKeyManager { inner: instance }
     }
+
+    /// Like `new`, but caches the file info returned by `get_file` natively
+    /// in `1 << num_shard_bits` shards, so that reopening a file doesn't
+    /// call into `key_manager`. The cache is invalidated through `new_file`,
+    /// `delete_file` and `link_file`; file info must not be changed
+    /// through any other path while an env is using this key manager.
+    pub fn new_with_cache<T: EncryptionKeyManager>(
+        key_manager: T,
+        num_shard_bits: i32,
+    ) -> DBEncryptionKeyManager {
+        assert!(num_shard_bits >= 0 && num_shard_bits < 20);
+        let ctx = Box::into_raw(Box::new(key_manager)) as *mut c_void;
+        let instance = unsafe {
+            crocksdb_ffi::crocksdb_encryption_key_manager_create_with_cache(
+                ctx,
+                encryption_key_manager_destructor::<T>,
+                encryption_key_manager_get_file::<T>,
+                encryption_key_manager_new_file::<T>,
+                encryption_key_manager_delete_file::<T>,
+                encryption_key_manager_link_file::<T>,
+                num_shard_bits,
+            )
+        };
+        DBEncryptionKeyManager { inner: instance }
+    }
 }
 
 impl Drop for DBEncryptionKeyManager {
@@ -590,4 +615,48 @@ mod test {
             record.dst_fname.lock().unwrap().as_str()
         );
     }
+
+    #[test]
+    fn cached_get_file() {
+        let key_manager = Arc::new(Mutex::new(TestEncryptionKeyManager {
+            return_value: Some(FileEncryptionInfo {
+                method: DBEncryptionMethod::Aes128Ctr,
+                key: b"test_key_get_file".to_vec(),
+                iv: b"test_iv_get_file".to_vec(),
+            }),
+            ..Default::default()
+        }));
+        let db_key_manager = DBEncryptionKeyManager::new_with_cache(key_manager.clone(), 2);
+        let get_file_called = || {
+            let record = key_manager.lock().unwrap();
+            record.get_file_called.load(Ordering::SeqCst)
+        };
+        for _ in 0..3 {
+            let file_info = db_key_manager.get_file("get_file_path").unwrap();
+            assert_eq!(b"test_key_get_file", file_info.key.as_slice());
+        }
+        assert_eq!(1, get_file_called());
+        db_key_manager.get_file("other_path").unwrap();
+        assert_eq!(2, get_file_called());
+
+        // Each of new, delete and link invalidates the cached file info.
+        db_key_manager.new_file("get_file_path").unwrap();
+        db_key_manager.get_file("get_file_path").unwrap();
+        assert_eq!(3, get_file_called());
+        db_key_manager.delete_file("get_file_path").unwrap();
+        db_key_manager.get_file("get_file_path").unwrap();
+        assert_eq!(4, get_file_called());
+        db_key_manager
+            .link_file("other_path", "get_file_path")
+            .unwrap();
+        db_key_manager.get_file("get_file_path").unwrap();
+        db_key_manager.get_file("other_path").unwrap();
+        assert_eq!(5, get_file_called());
+
+        // Errors are not cached.
+        key_manager.lock().unwrap().return_value = None;
+        assert!(db_key_manager.get_file("error_path").is_err());
+        assert!(db_key_manager.get_file("error_path").is_err());
+        assert_eq!(7, get_file_called());
+    }
 }
@@ -10,7 +10,18 @@ pub trait FileSystemInspector: Sync + Send {
     fn write(&self, len: usize) -> Result<usize, String>;
 }
 
-extern "C" fn file_system_inspector_destructor<T: FileSystemInspector>(ctx: *mut c_void) {
+/// Budgets of a `TokenBucketInspector`. Unlike `FileSystemInspector`, it isn't
+/// called for every IO request, only to refill the native token buckets.
+pub trait FileSystemBudget: Sync + Send {
+    /// Returns the bytes that may be read until the next refill. `used` is the
+    /// bytes read since the last refill.
+    fn refill_read(&self, used: usize) -> Result<usize, String>;
+    /// Returns the bytes that may be written until the next refill. `used` is
+    /// the bytes written since the last refill.
+    fn refill_write(&self, used: usize) -> Result<usize, String>;
+}
+
+extern "C" fn file_system_inspector_destructor<T>(ctx: *mut c_void) {
     unsafe {
         // Recover from raw pointer and implicitly drop.
         Box::from_raw(ctx as *mut T);
@@ -51,6 +62,40 @@ extern "C" fn file_system_inspector_write<T: FileSystemInspector>(
     }
 }
 
+extern "C" fn file_system_budget_refill_read<T: FileSystemBudget>(
+    ctx: *mut c_void,
+    used: size_t,
+    errptr: *mut *mut c_char,
+) -> size_t {
+    let budget = unsafe { &*(ctx as *mut T) };
+    match budget.refill_read(used) {
+        Ok(ret) => ret,
+        Err(e) => {
+            unsafe {
+                *errptr = strdup(e.as_ptr() as *const c_char);
+            }
+            0
+        }
+    }
+}
+
+extern "C" fn file_system_budget_refill_write<T: FileSystemBudget>(
+    ctx: *mut c_void,
+    used: size_t,
+    errptr: *mut *mut c_char,
+) -> size_t {
+    let budget = unsafe { &*(ctx as *mut T) };
+    match budget.refill_write(used) {
+        Ok(ret) => ret,
+        Err(e) => {
+            unsafe {
+                *errptr = strdup(e.as_ptr() as *const c_char);
+            }
+            0
+        }
+    }
+}
+
 pub struct DBFileSystemInspector {
     pub inner: *mut DBFileSystemInspectorInstance,
 }
@@ -73,6 +118,52 @@ impl DBFileSystemInspector {
     }
 }
 
+/// A file system inspector with native token buckets for reads and writes. IO
+/// requests take bytes from the buckets without calling into Rust; the budget
+/// is asked for once every `refill_period_us`, or early when a bucket runs out.
+/// Requests finding an empty bucket wait for the next refill.
+pub struct TokenBucketInspector {
+    pub(crate) inner: DBFileSystemInspector,
+}
+
+impl TokenBucketInspector {
+    pub fn new<T: FileSystemBudget>(budget: T, refill_period_us: u64) -> TokenBucketInspector {
+        let ctx = Box::into_raw(Box::new(budget)) as *mut c_void;
+        let instance = unsafe {
+            crocksdb_ffi::crocksdb_token_bucket_file_system_inspector_create(
+                ctx,
+                file_system_inspector_destructor::<T>,
+                file_system_budget_refill_read::<T>,
+                file_system_budget_refill_write::<T>,
+                refill_period_us,
+            )
+        };
+        TokenBucketInspector {
+            inner: DBFileSystemInspector { inner: instance },
+        }
+    }
+
+    /// Total time reads spent waiting for a refill, in microseconds.
+    pub fn read_throttled_micros(&self) -> u64 {
+        unsafe {
+            crocksdb_ffi::crocksdb_file_system_inspector_get_read_throttled_micros(self.inner.inner)
+        }
+    }
+
+    /// Total time writes spent waiting for a refill, in microseconds.
+    pub fn write_throttled_micros(&self) -> u64 {
+        unsafe {
+            crocksdb_ffi::crocksdb_file_system_inspector_get_write_throttled_micros(
+                self.inner.inner,
+            )
+        }
+    }
+
+    pub fn refill_count(&self) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_file_system_inspector_get_refill_count(self.inner.inner) }
+    }
+}
+
 impl Drop for DBFileSystemInspector {
     fn drop(&mut self) {
         unsafe {
@@ -165,6 +256,47 @@ mod test {
         assert_eq!(1, drop_called.load(Ordering::SeqCst));
     }
 
+    struct TestFileSystemBudget {
+        budget: usize,
+        refills: AtomicUsize,
+        used: AtomicUsize,
+    }
+
+    impl FileSystemBudget for Arc<TestFileSystemBudget> {
+        fn refill_read(&self, used: usize) -> Result<usize, String> {
+            self.refills.fetch_add(1, Ordering::SeqCst);
+            self.used.fetch_add(used, Ordering::SeqCst);
+            Ok(self.budget)
+        }
+        fn refill_write(&self, _: usize) -> Result<usize, String> {
+            Err("write not allowed".into())
+        }
+    }
+
+    #[test]
+    fn test_token_bucket_inspector() {
+        let budget = Arc::new(TestFileSystemBudget {
+            budget: 4096,
+            refills: AtomicUsize::new(0),
+            used: AtomicUsize::new(0),
+        });
+        // A long period, so refills only happen when the bucket runs out.
+        let inspector = TokenBucketInspector::new(budget.clone(), 3_600_000_000);
+        let db_fs_inspector = &inspector.inner;
+        for _ in 0..4 {
+            assert_eq!(1024, db_fs_inspector.read(1024).unwrap());
+        }
+        assert_eq!(1, budget.refills.load(Ordering::SeqCst));
+        // The bucket is empty, the budget is refilled early once.
+        assert_eq!(2048, db_fs_inspector.read(2048).unwrap());
+        assert_eq!(2, budget.refills.load(Ordering::SeqCst));
+        assert_eq!(4096, budget.used.load(Ordering::SeqCst));
+        assert_eq!(2048, db_fs_inspector.read(8192).unwrap());
+        assert_eq!(0, inspector.read_throttled_micros());
+        assert!(db_fs_inspector.write(1).is_err());
+        assert_eq!(2, inspector.refill_count());
+    }
+
     #[test]
     fn test_inspected_operation() {
         let fs_inspector = Arc::new(Mutex::new(TestFileSystemInspector {
@@ -39,27 +39,34 @@ pub use event_listener::{
     CompactionJobInfo, EventListener, FlushJobInfo, IngestionInfo, SubcompactionJobInfo,
     WriteStallInfo,
 };
-pub use file_system::FileSystemInspector;
+pub use file_system::{FileSystemBudget, FileSystemInspector, TokenBucketInspector};
 pub use librocksdb_sys::{
     self as crocksdb_ffi, new_bloom_filter, CompactionPriority, CompactionReason,
-    DBBackgroundErrorReason, DBBottommostLevelCompaction, DBCompactionStyle, DBCompressionType,
-    DBEntryType, DBInfoLogLevel, DBRateLimiterMode, DBRecoveryMode,
-    DBSstPartitionerResult as SstPartitionerResult, DBStatisticsHistogramType,
+    DBBackgroundErrorReason, DBBottommostLevelCompaction, DBChecksumType, DBCompactionStyle,
+    DBCompressionType, DBEntryType, DBFileChecksumType, DBInfoLogLevel, DBRateLimiterMode,
+    DBRecoveryMode, DBSstPartitionerResult as SstPartitionerResult, DBStatisticsHistogramType,
     DBStatisticsTickerType, DBStatusPtr, DBTableFileCreationReason, DBTitanDBBlobRunMode,
-    DBValueType, IndexType, WriteStallCondition,
+    DBTraceOpType, DBValueType, IndexType, WriteStallCondition,
 };
 pub use logger::Logger;
 pub use merge_operator::MergeOperands;
-pub use metadata::{ColumnFamilyMetaData, LevelMetaData, SstFileMetaData};
+pub use metadata::{
+    ColumnFamilyMetaData, ExportImportFilesMetaData, ExportedFileMetaData, LevelMetaData,
+    LiveFileMetaData, LiveFilesDiff, SstFileMetaData,
+};
 pub use perf_context::{get_perf_level, set_perf_level, IOStatsContext, PerfContext, PerfLevel};
 pub use rocksdb::{
     load_latest_options, run_ldb_tool, run_sst_dump_tool, set_external_sst_file_global_seq_no,
-    BackupEngine, CFHandle, Cache, DBIterator, DBVector, Env, ExternalSstFileInfo, MapProperty,
-    MemoryAllocator, Range, SeekKey, SequentialFile, SstFileReader, SstFileWriter, Writable, DB,
+    set_external_sst_files_global_seq_no, BackupEngine, BlockCacheRecorder, BlockCacheSimulator,
+    BlockCacheWarmer, CFHandle, Cache, DBIterator, DBVector, Env, ExportedRange,
+    ExternalSstFileInfo, MapProperty, MemoryAllocator, OpenPhaseProfile, OpenProfile,
+    ParallelSstFileWriter, PersistentCache, Range, SeekKey, SequentialFile, SnapshotExporter,
+    SstFileReader, SstFileWriter, TraceReplayer, WalRecoveryProfile, Writable, WriteBufferManager,
+    DB,
 };
 pub use rocksdb_options::{
-    BlockBasedOptions, CColumnFamilyDescriptor, ColumnFamilyOptions, CompactOptions,
-    CompactionOptions, DBOptions, EnvOptions, FifoCompactionOptions, HistogramData,
+    BackupableDBOptions, BlockBasedOptions, CColumnFamilyDescriptor, ColumnFamilyOptions,
+    CompactOptions, CompactionOptions, DBOptions, EnvOptions, FifoCompactionOptions, HistogramData,
     IngestExternalFileOptions, LRUCacheOptions, RateLimiter, ReadOptions, RestoreOptions,
     WriteOptions,
 };
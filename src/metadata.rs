@@ -11,11 +11,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use crocksdb_ffi::{self, DBColumnFamilyMetaData, DBLevelMetaData, DBSstFileMetaData};
-use std::ffi::CStr;
+use crocksdb_ffi::{
+    self, DBColumnFamilyMetaData, DBExportImportFilesMetaData, DBLevelMetaData, DBLiveFiles,
+    DBLiveFilesDiff, DBSstFileMetaData,
+};
+use std::ffi::{CStr, CString};
+use std::marker::PhantomData;
 use std::slice;
 
-use libc::size_t;
+use libc::{c_int, size_t};
 
 pub struct ColumnFamilyMetaData {
     inner: *mut DBColumnFamilyMetaData,
@@ -120,3 +124,259 @@ impl<'a> SstFileMetaData<'a> {
         }
     }
 }
+
+/// The sst files of a column family exported by `DB::export_column_family`,
+/// which `DB::create_column_family_with_import` loads into another column family.
+pub struct ExportImportFilesMetaData {
+    pub(crate) inner: *mut DBExportImportFilesMetaData,
+}
+
+unsafe impl Send for ExportImportFilesMetaData {}
+
+impl ExportImportFilesMetaData {
+    /// Describes files exported to `dir` elsewhere, to be filled with `add_file`.
+    pub fn new(dir: &str) -> ExportImportFilesMetaData {
+        let c_dir = CString::new(dir).unwrap();
+        unsafe {
+            ExportImportFilesMetaData {
+                inner: crocksdb_ffi::crocksdb_export_import_files_metadata_create(c_dir.as_ptr()),
+            }
+        }
+    }
+
+    pub fn from_ptr(inner: *mut DBExportImportFilesMetaData) -> ExportImportFilesMetaData {
+        ExportImportFilesMetaData { inner }
+    }
+
+    /// `name` is relative to the export dir.
+    pub fn add_file(&mut self, name: &str, level: i32, smallest_seqno: u64, largest_seqno: u64) {
+        let c_name = CString::new(name).unwrap();
+        unsafe {
+            crocksdb_ffi::crocksdb_export_import_files_metadata_add_file(
+                self.inner,
+                c_name.as_ptr(),
+                level,
+                smallest_seqno,
+                largest_seqno,
+            );
+        }
+    }
+
+    pub fn get_dir(&self) -> String {
+        unsafe {
+            let ptr = crocksdb_ffi::crocksdb_export_import_files_metadata_dir(self.inner);
+            CStr::from_ptr(ptr).to_string_lossy().into_owned()
+        }
+    }
+
+    pub fn get_files(&self) -> Vec<ExportedFileMetaData> {
+        unsafe {
+            let n = crocksdb_ffi::crocksdb_export_import_files_metadata_count(self.inner);
+            (0..n)
+                .map(|index| ExportedFileMetaData {
+                    metadata: self,
+                    index,
+                })
+                .collect()
+        }
+    }
+}
+
+impl Drop for ExportImportFilesMetaData {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_export_import_files_metadata_destroy(self.inner);
+        }
+    }
+}
+
+pub struct ExportedFileMetaData<'a> {
+    metadata: &'a ExportImportFilesMetaData,
+    index: usize,
+}
+
+impl<'a> ExportedFileMetaData<'a> {
+    pub fn get_name(&self) -> String {
+        unsafe {
+            let ptr = crocksdb_ffi::crocksdb_export_import_files_metadata_name(
+                self.metadata.inner,
+                self.index,
+            );
+            CStr::from_ptr(ptr).to_string_lossy().into_owned()
+        }
+    }
+
+    pub fn get_level(&self) -> i32 {
+        unsafe {
+            crocksdb_ffi::crocksdb_export_import_files_metadata_level(
+                self.metadata.inner,
+                self.index,
+            )
+        }
+    }
+
+    pub fn get_size(&self) -> usize {
+        unsafe {
+            crocksdb_ffi::crocksdb_export_import_files_metadata_size(
+                self.metadata.inner,
+                self.index,
+            )
+        }
+    }
+
+    pub fn get_smallestkey(&self) -> &[u8] {
+        let mut len: size_t = 0;
+        unsafe {
+            let ptr = crocksdb_ffi::crocksdb_export_import_files_metadata_smallestkey(
+                self.metadata.inner,
+                self.index,
+                &mut len,
+            );
+            slice::from_raw_parts(ptr, len)
+        }
+    }
+
+    pub fn get_largestkey(&self) -> &[u8] {
+        let mut len: size_t = 0;
+        unsafe {
+            let ptr = crocksdb_ffi::crocksdb_export_import_files_metadata_largestkey(
+                self.metadata.inner,
+                self.index,
+                &mut len,
+            );
+            slice::from_raw_parts(ptr, len)
+        }
+    }
+
+    pub fn get_smallest_seqno(&self) -> u64 {
+        unsafe {
+            crocksdb_ffi::crocksdb_export_import_files_metadata_smallest_seqno(
+                self.metadata.inner,
+                self.index,
+            )
+        }
+    }
+
+    pub fn get_largest_seqno(&self) -> u64 {
+        unsafe {
+            crocksdb_ffi::crocksdb_export_import_files_metadata_largest_seqno(
+                self.metadata.inner,
+                self.index,
+            )
+        }
+    }
+}
+
+/// The live files added and removed between two calls of `DB::get_live_files_diff`.
+///
+/// While the diff lists added files, file deletions stay disabled so that
+/// they can be copied; call `release_files` once they are, or drop the diff.
+/// The diff can still be passed as the version token of the next call after
+/// it is released.
+pub struct LiveFilesDiff<'a> {
+    inner: *mut DBLiveFilesDiff,
+    _db: PhantomData<&'a ()>,
+}
+
+impl<'a> LiveFilesDiff<'a> {
+    pub(crate) fn from_ptr(inner: *mut DBLiveFilesDiff) -> LiveFilesDiff<'a> {
+        LiveFilesDiff {
+            inner,
+            _db: PhantomData,
+        }
+    }
+
+    pub(crate) fn get_inner(&self) -> *const DBLiveFilesDiff {
+        self.inner
+    }
+
+    pub fn get_added(&self) -> Vec<LiveFileMetaData> {
+        unsafe { self.get_files(crocksdb_ffi::crocksdb_livefiles_diff_added(self.inner)) }
+    }
+
+    pub fn get_removed(&self) -> Vec<LiveFileMetaData> {
+        unsafe { self.get_files(crocksdb_ffi::crocksdb_livefiles_diff_removed(self.inner)) }
+    }
+
+    unsafe fn get_files(&self, files: *const DBLiveFiles) -> Vec<LiveFileMetaData> {
+        let n = crocksdb_ffi::crocksdb_livefiles_count(files);
+        (0..n)
+            .map(|index| LiveFileMetaData {
+                files,
+                index,
+                _mark: self,
+            })
+            .collect()
+    }
+
+    /// Allows the DB to delete obsolete files again.
+    pub fn release_files(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_livefiles_diff_release_files(self.inner);
+        }
+    }
+}
+
+impl<'a> Drop for LiveFilesDiff<'a> {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_livefiles_diff_destroy(self.inner);
+        }
+    }
+}
+
+pub struct LiveFileMetaData<'a> {
+    files: *const DBLiveFiles,
+    index: c_int,
+    _mark: &'a LiveFilesDiff<'a>,
+}
+
+impl<'a> LiveFileMetaData<'a> {
+    /// The file name relative to the DB path, e.g. "/000012.sst".
+    pub fn get_name(&self) -> String {
+        unsafe {
+            let ptr = crocksdb_ffi::crocksdb_livefiles_name(self.files, self.index);
+            CStr::from_ptr(ptr).to_string_lossy().into_owned()
+        }
+    }
+
+    pub fn get_column_family_name(&self) -> String {
+        unsafe {
+            let ptr = crocksdb_ffi::crocksdb_livefiles_column_family_name(self.files, self.index);
+            CStr::from_ptr(ptr).to_string_lossy().into_owned()
+        }
+    }
+
+    pub fn get_level(&self) -> i32 {
+        unsafe { crocksdb_ffi::crocksdb_livefiles_level(self.files, self.index) }
+    }
+
+    pub fn get_size(&self) -> usize {
+        unsafe { crocksdb_ffi::crocksdb_livefiles_size(self.files, self.index) }
+    }
+
+    pub fn get_smallestkey(&self) -> &[u8] {
+        let mut len: size_t = 0;
+        unsafe {
+            let ptr =
+                crocksdb_ffi::crocksdb_livefiles_smallestkey(self.files, self.index, &mut len);
+            slice::from_raw_parts(ptr, len)
+        }
+    }
+
+    pub fn get_largestkey(&self) -> &[u8] {
+        let mut len: size_t = 0;
+        unsafe {
+            let ptr = crocksdb_ffi::crocksdb_livefiles_largestkey(self.files, self.index, &mut len);
+            slice::from_raw_parts(ptr, len)
+        }
+    }
+
+    pub fn get_smallest_seqno(&self) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_livefiles_smallest_seqno(self.files, self.index) }
+    }
+
+    pub fn get_largest_seqno(&self) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_livefiles_largest_seqno(self.files, self.index) }
+    }
+}
@@ -13,34 +13,40 @@
 // limitations under the License.
 
 use crocksdb_ffi::{
-    self, DBBackupEngine, DBCFHandle, DBCache, DBCompressionType, DBEnv, DBInstance, DBMapProperty,
-    DBPinnableSlice, DBSequentialFile, DBStatisticsHistogramType, DBStatisticsTickerType,
-    DBTablePropertiesCollection, DBTitanDBOptions, DBWriteBatch,
+    self, DBBackupEngine, DBBlockCacheRecorder, DBBlockCacheSimulator, DBBlockCacheWarmer,
+    DBCFHandle, DBCache, DBCompressionType, DBEnv, DBFileChecksumType, DBInstance, DBMapProperty,
+    DBOpenPhase, DBPersistentCache, DBPinnableSlice, DBSequentialFile, DBStatisticsHistogramType,
+    DBStatisticsTickerType, DBTablePropertiesCollection, DBTitanDBOptions, DBTraceOpType,
+    DBTraceReplayer, DBWriteBatch,
 };
 use libc::{self, c_char, c_int, c_void, size_t};
 use librocksdb_sys::DBMemoryAllocator;
-use metadata::ColumnFamilyMetaData;
+use metadata::{ColumnFamilyMetaData, ExportImportFilesMetaData, LiveFilesDiff};
 use rocksdb_options::{
-    CColumnFamilyDescriptor, ColumnFamilyDescriptor, ColumnFamilyOptions, CompactOptions,
-    CompactionOptions, DBOptions, EnvOptions, FlushOptions, HistogramData,
-    IngestExternalFileOptions, LRUCacheOptions, ReadOptions, RestoreOptions, UnsafeSnap,
-    WriteOptions,
+    BackupableDBOptions, CColumnFamilyDescriptor, ColumnFamilyDescriptor, ColumnFamilyOptions,
+    CompactOptions, CompactionOptions, DBOptions, EnvOptions, FlushOptions, HistogramData,
+    IngestExternalFileOptions, LRUCacheOptions, RateLimiter, ReadOptions, RestoreOptions,
+    UnsafeSnap, WriteOptions,
 };
 use std::collections::BTreeMap;
 use std::ffi::{CStr, CString};
 use std::fmt::{self, Debug, Formatter};
 use std::io;
+use std::marker::PhantomData;
 use std::mem;
 use std::ops::Deref;
 use std::path::{Path, PathBuf};
 use std::rc::Rc;
 use std::str::from_utf8;
 use std::sync::Arc;
+use std::time::Duration;
 use std::{fs, ptr, slice};
 
+#[cfg(feature = "encryption")]
+use crocksdb_ffi::DBEncryptionMethod;
 #[cfg(feature = "encryption")]
 use encryption::{DBEncryptionKeyManager, EncryptionKeyManager};
-use file_system::{DBFileSystemInspector, FileSystemInspector};
+use file_system::{DBFileSystemInspector, FileSystemInspector, TokenBucketInspector};
 use table_properties::{TableProperties, TablePropertiesCollection};
 use table_properties_rc::TablePropertiesCollection as RcTablePropertiesCollection;
 use titan::TitanDBOptions;
@@ -105,6 +111,43 @@ fn build_cstring_list(str_list: &[&str]) -> Vec<CString> {
         .collect()
 }
 
+// Arguments of `crocksdb_ingest_external_files`, kept alive together.
+struct IngestExternalFilesArgs {
+    _files: Vec<Vec<CString>>,
+    _file_ptrs: Vec<Vec<*const c_char>>,
+    handles: Vec<*const crocksdb_ffi::DBCFHandle>,
+    file_lists: Vec<*const *const c_char>,
+    list_lens: Vec<size_t>,
+    opts: Vec<*const crocksdb_ffi::IngestExternalFileOptions>,
+}
+
+impl IngestExternalFilesArgs {
+    fn new(args: &[(&CFHandle, &IngestExternalFileOptions, &[&str])]) -> IngestExternalFilesArgs {
+        let files: Vec<Vec<CString>> = args
+            .iter()
+            .map(|&(_, _, files)| build_cstring_list(files))
+            .collect();
+        let file_ptrs: Vec<Vec<*const c_char>> = files
+            .iter()
+            .map(|files| files.iter().map(|s| s.as_ptr()).collect())
+            .collect();
+        IngestExternalFilesArgs {
+            handles: args
+                .iter()
+                .map(|&(cf, _, _)| cf.inner as *const _)
+                .collect(),
+            file_lists: file_ptrs.iter().map(|ptrs| ptrs.as_ptr()).collect(),
+            list_lens: file_ptrs.iter().map(|ptrs| ptrs.len()).collect(),
+            opts: args
+                .iter()
+                .map(|&(_, opt, _)| opt.inner as *const _)
+                .collect(),
+            _file_ptrs: file_ptrs,
+            _files: files,
+        }
+    }
+}
+
 pub struct MapProperty {
     inner: *mut DBMapProperty,
 }
@@ -154,6 +197,59 @@ pub struct DB {
     readonly: bool,
 }
 
+/// Time spent in, and files touched by, one phase of `DB::open_cf_with_profile`.
+#[derive(Debug, Default, Clone, Copy)]
+pub struct OpenPhaseProfile {
+    pub duration: Duration,
+    pub file_count: u64,
+}
+
+/// The replay of one WAL during `DB::open_cf_with_profile`.
+#[derive(Debug, Default, Clone)]
+pub struct WalRecoveryProfile {
+    pub name: String,
+    pub bytes: u64,
+    /// From opening the WAL to its last read, which covers inserting the
+    /// records into the memtables and any flush in between.
+    pub duration: Duration,
+}
+
+/// The phases of a DB open, in the order they run. The phases are told apart
+/// by the files the open touches, so a phase lasts until the next one starts.
+#[derive(Debug, Default, Clone)]
+pub struct OpenProfile {
+    /// Reading the MANIFEST to rebuild the LSM tree.
+    pub manifest_replay: OpenPhaseProfile,
+    /// Opening table files, with `max_file_opening_threads` threads.
+    pub table_opening: OpenPhaseProfile,
+    /// Replaying the WALs, including flushes of the recovered data.
+    pub wal_recovery: OpenPhaseProfile,
+    /// Writing the OPTIONS file, and whatever follows until the open returns.
+    pub options_persistence: OpenPhaseProfile,
+    pub total: Duration,
+    /// The WALs replayed, in order.
+    pub wal_files: Vec<WalRecoveryProfile>,
+    /// Entries replayed from the WALs, whether flushed during recovery or
+    /// left in the memtables.
+    pub wal_recovered_entries: u64,
+}
+
+impl OpenProfile {
+    pub fn wal_recovered_bytes(&self) -> u64 {
+        self.wal_files.iter().map(|f| f.bytes).sum()
+    }
+
+    /// Entries replayed per second of the WAL recovery phase.
+    pub fn wal_recovered_entries_per_sec(&self) -> f64 {
+        let secs = self.wal_recovery.duration.as_secs() as f64
+            + self.wal_recovery.duration.subsec_nanos() as f64 / 1e9;
+        if secs == 0.0 {
+            return 0.0;
+        }
+        self.wal_recovered_entries as f64 / secs
+    }
+}
+
 impl Debug for DB {
     fn fmt(&self, f: &mut Formatter) -> fmt::Result {
         write!(f, "Db [path={}]", self.path)
@@ -511,7 +607,7 @@ impl DB {
     where
         T: Into<ColumnFamilyDescriptor<'a>>,
     {
-        DB::open_cf_internal(opts, path, cfds, &[], None)
+        DB::open_cf_internal(opts, path, cfds, &[], None, None, ptr::null_mut())
     }
 
     pub fn open_cf_with_ttl<'a, T>(
@@ -526,7 +622,7 @@ impl DB {
         if ttls.len() == 0 {
             return Err("ttls is empty in with_ttl function".to_owned());
         }
-        DB::open_cf_internal(opts, path, cfds, ttls, None)
+        DB::open_cf_internal(opts, path, cfds, ttls, None, None, ptr::null_mut())
     }
 
     pub fn open_for_read_only(
@@ -547,7 +643,100 @@ impl DB {
     where
         T: Into<ColumnFamilyDescriptor<'a>>,
     {
-        DB::open_cf_internal(opts, path, cfds, &[], Some(error_if_log_file_exist))
+        DB::open_cf_internal(
+            opts,
+            path,
+            cfds,
+            &[],
+            Some(error_if_log_file_exist),
+            None,
+            ptr::null_mut(),
+        )
+    }
+
+    /// Same as `open_cf`, also returning how long each phase of the open
+    /// took. Not supported by Titan.
+    pub fn open_cf_with_profile<'a, T>(
+        opts: DBOptions,
+        path: &str,
+        cfds: Vec<T>,
+    ) -> Result<(DB, OpenProfile), String>
+    where
+        T: Into<ColumnFamilyDescriptor<'a>>,
+    {
+        unsafe {
+            let profile = crocksdb_ffi::crocksdb_open_profile_create();
+            let res = DB::open_cf_internal(opts, path, cfds, &[], None, None, profile);
+            let phase = |p| OpenPhaseProfile {
+                duration: Duration::from_micros(
+                    crocksdb_ffi::crocksdb_open_profile_duration_micros(profile, p),
+                ),
+                file_count: crocksdb_ffi::crocksdb_open_profile_file_count(profile, p),
+            };
+            let num_wal_files = crocksdb_ffi::crocksdb_open_profile_wal_file_count(profile);
+            let wal_files = (0..num_wal_files)
+                .map(|i| {
+                    let name = crocksdb_ffi::crocksdb_open_profile_wal_file_name(profile, i);
+                    WalRecoveryProfile {
+                        name: CStr::from_ptr(name).to_string_lossy().into_owned(),
+                        bytes: crocksdb_ffi::crocksdb_open_profile_wal_file_bytes(profile, i),
+                        duration: Duration::from_micros(
+                            crocksdb_ffi::crocksdb_open_profile_wal_file_micros(profile, i),
+                        ),
+                    }
+                })
+                .collect();
+            let open_profile = OpenProfile {
+                manifest_replay: phase(DBOpenPhase::ManifestReplay),
+                table_opening: phase(DBOpenPhase::TableOpening),
+                wal_recovery: phase(DBOpenPhase::WalRecovery),
+                options_persistence: phase(DBOpenPhase::OptionsPersistence),
+                total: Duration::from_micros(crocksdb_ffi::crocksdb_open_profile_total_micros(
+                    profile,
+                )),
+                wal_files,
+                wal_recovered_entries: crocksdb_ffi::crocksdb_open_profile_wal_recovered_entries(
+                    profile,
+                ),
+            };
+            crocksdb_ffi::crocksdb_open_profile_destroy(profile);
+            res.map(|db| (db, open_profile))
+        }
+    }
+
+    /// Opens a secondary instance of the DB at `path`, which can be kept up
+    /// to date with the primary by `try_catch_up_with_primary`, unlike a read
+    /// only instance which stays at the state it was opened in. Info logs go
+    /// to `secondary_path`. Requires `max_open_files` to be -1.
+    pub fn open_as_secondary(
+        opts: DBOptions,
+        path: &str,
+        secondary_path: &str,
+    ) -> Result<DB, String> {
+        let cfds: Vec<&str> = vec![];
+        DB::open_cf_as_secondary(opts, path, secondary_path, cfds)
+    }
+
+    /// Same as `open_as_secondary`. Only the column families in `cfds` are
+    /// opened and caught up.
+    pub fn open_cf_as_secondary<'a, T>(
+        opts: DBOptions,
+        path: &str,
+        secondary_path: &str,
+        cfds: Vec<T>,
+    ) -> Result<DB, String>
+    where
+        T: Into<ColumnFamilyDescriptor<'a>>,
+    {
+        DB::open_cf_internal(
+            opts,
+            path,
+            cfds,
+            &[],
+            None,
+            Some(secondary_path),
+            ptr::null_mut(),
+        )
     }
 
     fn open_cf_internal<'a, T>(
@@ -558,6 +747,10 @@ impl DB {
         // if none, open for read write mode.
         // otherwise, open for read only.
         error_if_log_file_exist: Option<bool>,
+        // if some, open as a secondary instance.
+        secondary_path: Option<&str>,
+        // if not null, open for read write mode and fill the profile.
+        profile: *mut crocksdb_ffi::DBOpenProfile,
     ) -> Result<DB, String>
     where
         T: Into<ColumnFamilyDescriptor<'a>>,
@@ -575,6 +768,14 @@ impl DB {
                 e
             )
         })?;
+        let secondary_cpath = match secondary_path {
+            Some(p) => {
+                fs::create_dir_all(&Path::new(p))
+                    .map_err(|e| format!("Failed to create secondary directory: {:?}", e))?;
+                Some(CString::new(p.as_bytes()).map_err(|_| ERR_CONVERT_PATH.to_owned())?)
+            }
+            None => None,
+        };
 
         let mut descs = cfds.into_iter().map(|t| t.into()).collect();
         let mut ttls_vec = ttls.to_vec();
@@ -601,7 +802,7 @@ impl DB {
             })
             .collect();
 
-        let readonly = error_if_log_file_exist.is_some();
+        let readonly = error_if_log_file_exist.is_some() || secondary_path.is_some();
 
         let with_ttl = if ttls_vec.len() > 0 {
             if ttls_vec.len() == cf_names.len() {
@@ -627,15 +828,35 @@ impl DB {
                 unsafe {
                     crocksdb_ffi::ctitandb_options_set_rocksdb_options(titan_options, db_options);
                 }
-                if error_if_log_file_exist.is_some() {
+                if !profile.is_null() {
+                    return Err("TitanDB doesn't support open profile.".to_owned());
+                } else if error_if_log_file_exist.is_some() {
                     return Err("TitanDB doesn't support read only mode.".to_owned());
+                } else if secondary_path.is_some() {
+                    return Err("TitanDB doesn't support secondary mode.".to_owned());
                 } else if with_ttl {
                     return Err("TitanDB doesn't support ttl.".to_owned());
                 }
             }
 
+            if secondary_path.is_some() && with_ttl {
+                return Err("Secondary mode doesn't support ttl.".to_owned());
+            }
+
             if !with_ttl {
-                if let Some(flag) = error_if_log_file_exist {
+                if let Some(ref secondary_cpath) = secondary_cpath {
+                    unsafe {
+                        ffi_try!(crocksdb_open_as_secondary_column_families(
+                            db_options,
+                            db_path,
+                            secondary_cpath.as_ptr(),
+                            db_cfs_count,
+                            db_cf_ptrs,
+                            db_cf_opts,
+                            db_cf_handles
+                        ))
+                    }
+                } else if let Some(flag) = error_if_log_file_exist {
                     unsafe {
                         ffi_try!(crocksdb_open_for_read_only_column_families(
                             db_options,
@@ -647,6 +868,18 @@ impl DB {
                             flag
                         ))
                     }
+                } else if !profile.is_null() {
+                    unsafe {
+                        ffi_try!(crocksdb_open_column_families_with_profile(
+                            db_options,
+                            db_path,
+                            db_cfs_count,
+                            db_cf_ptrs,
+                            db_cf_opts,
+                            db_cf_handles,
+                            profile
+                        ))
+                    }
                 } else if titan_options.is_null() {
                     unsafe {
                         ffi_try!(crocksdb_open_column_families(
@@ -921,6 +1154,46 @@ impl DB {
         }
     }
 
+    /// Creates a column family holding the data of the files in `metadata`,
+    /// which are rewritten and ingested, leaving the export dir untouched.
+    /// Not supported by Titan.
+    pub fn create_column_family_with_import<'a, T>(
+        &mut self,
+        cfd: T,
+        metadata: &ExportImportFilesMetaData,
+    ) -> Result<&CFHandle, String>
+    where
+        T: Into<ColumnFamilyDescriptor<'a>>,
+    {
+        if self.is_titan() {
+            return Err("Importing a column family is not supported by Titan".to_owned());
+        }
+        let cfd = cfd.into();
+        let cname = match CString::new(cfd.name.as_bytes()) {
+            Ok(c) => c,
+            Err(_) => {
+                return Err("Failed to convert name to CString when importing".to_owned());
+            }
+        };
+        unsafe {
+            let cf_handler = ffi_try!(crocksdb_create_column_family_with_import(
+                self.inner,
+                cfd.options.inner,
+                cname.as_ptr(),
+                metadata.inner
+            ));
+            let handle = CFHandle { inner: cf_handler };
+            self._cf_opts.push(cfd.options);
+            let idx = handle.id() as usize;
+            while idx >= self.cfs.len() {
+                self.cfs.push(None);
+            }
+            self.cfs[idx] = Some((cfd.name.to_owned(), handle));
+            self.cfs_by_name.insert(cfd.name.to_owned(), idx);
+            Ok(&self.cfs[idx].as_ref().unwrap().1)
+        }
+    }
+
     pub fn drop_cf(&mut self, name: &str) -> Result<(), String> {
         let id = self.cfs_by_name.remove(name);
         let cf = match id {
@@ -1214,11 +1487,35 @@ impl DB {
         }
     }
 
+    /// Makes a secondary instance catch up with the primary by replaying
+    /// the MANIFEST and WAL written since the last call.
+    pub fn try_catch_up_with_primary(&self) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_try_catch_up_with_primary(self.inner));
+        }
+        Ok(())
+    }
+
     /// Get the sequence number of the most recent transaction.
     pub fn get_latest_sequence_number(&self) -> u64 {
         unsafe { crocksdb_ffi::crocksdb_get_latest_sequence_number(self.inner) }
     }
 
+    /// Returns the live sst files added and removed since the diff `since`,
+    /// or all of them if it's `None`, so that only changed files need to be
+    /// shipped to a follower. File deletions are held until the returned
+    /// diff is released or dropped, if it added any file.
+    pub fn get_live_files_diff(
+        &self,
+        since: Option<&LiveFilesDiff>,
+    ) -> Result<LiveFilesDiff, String> {
+        let since = since.map_or(ptr::null(), |d| d.get_inner());
+        unsafe {
+            let diff = ffi_try!(crocksdb_livefiles_diff(self.inner, since));
+            Ok(LiveFilesDiff::from_ptr(diff))
+        }
+    }
+
     /// Return the approximate file system space used by keys in each ranges.
     ///
     /// Note that the returned sizes measure file system space usage, so
@@ -1770,6 +2067,49 @@ impl DB {
         Ok(has_flush)
     }
 
+    /// Ingests each `(cf, options, files)` of `args` atomically, with a
+    /// single manifest write. Each column family may appear only once.
+    pub fn ingest_external_files(
+        &self,
+        args: &[(&CFHandle, &IngestExternalFileOptions, &[&str])],
+    ) -> Result<(), String> {
+        let c_args = IngestExternalFilesArgs::new(args);
+        unsafe {
+            ffi_try!(crocksdb_ingest_external_files(
+                self.inner,
+                c_args.handles.as_ptr(),
+                c_args.file_lists.as_ptr(),
+                c_args.list_lens.as_ptr(),
+                c_args.opts.as_ptr(),
+                args.len()
+            ));
+        }
+        Ok(())
+    }
+
+    /// An optimized version of `ingest_external_files`, like
+    /// `ingest_external_file_optimized`. Only the column families whose
+    /// memtables overlap their files are flushed, and nothing is ingested if
+    /// that flush fails. Returns true if memtables are flushed without
+    /// blocking.
+    pub fn ingest_external_files_optimized(
+        &self,
+        args: &[(&CFHandle, &IngestExternalFileOptions, &[&str])],
+    ) -> Result<bool, String> {
+        let c_args = IngestExternalFilesArgs::new(args);
+        let has_flush = unsafe {
+            ffi_try!(crocksdb_ingest_external_files_optimized(
+                self.inner,
+                c_args.handles.as_ptr(),
+                c_args.file_lists.as_ptr(),
+                c_args.list_lens.as_ptr(),
+                c_args.opts.as_ptr(),
+                args.len()
+            ))
+        };
+        Ok(has_flush)
+    }
+
     pub fn backup_at(&self, path: &str) -> Result<BackupEngine, String> {
         let backup_engine = BackupEngine::open(DBOptions::new(), path).unwrap();
         unsafe {
@@ -1819,6 +2159,51 @@ impl DB {
         DB::open_default(restore_db_path)
     }
 
+    /// Creates an openable snapshot of the DB at `path`, which must not exist.
+    /// Sst files are hard-linked if `path` is on the same filesystem, so this
+    /// takes time proportional to the number of files rather than their size.
+    /// The memtables are flushed first if the live WALs are at least
+    /// `log_size_for_flush` bytes, otherwise the WALs are copied instead.
+    pub fn create_checkpoint(&self, path: &str, log_size_for_flush: u64) -> Result<(), String> {
+        let c_path = match CString::new(path.as_bytes()) {
+            Ok(c) => c,
+            Err(_) => {
+                return Err("Failed to convert path to CString when creating checkpoint".to_owned());
+            }
+        };
+        unsafe {
+            ffi_try!(crocksdb_create_checkpoint(
+                self.inner,
+                c_path.as_ptr(),
+                log_size_for_flush
+            ));
+        }
+        Ok(())
+    }
+
+    /// Flushes `cf` and hard-links its sst files into `dir`, which must not
+    /// exist yet.
+    pub fn export_column_family(
+        &self,
+        cf: &CFHandle,
+        dir: &str,
+    ) -> Result<ExportImportFilesMetaData, String> {
+        let c_dir = match CString::new(dir.as_bytes()) {
+            Ok(c) => c,
+            Err(_) => {
+                return Err("Failed to convert path to CString when exporting".to_owned());
+            }
+        };
+        unsafe {
+            let metadata = ffi_try!(crocksdb_export_column_family(
+                self.inner,
+                cf.inner,
+                c_dir.as_ptr()
+            ));
+            Ok(ExportImportFilesMetaData::from_ptr(metadata))
+        }
+    }
+
     pub fn get_block_cache_usage(&self) -> u64 {
         self.get_options().get_block_cache_usage()
     }
@@ -1976,6 +2361,142 @@ impl DB {
             Ok(())
         }
     }
+
+    /// Samples the keys of point lookups and seeks into `recorder` until
+    /// `end_block_cache_recording` is called. One in `sampling_frequency` requests
+    /// is recorded.
+    ///
+    /// Recording is built on the DB tracer, so it fails while another trace runs.
+    pub fn start_block_cache_recording(
+        &self,
+        recorder: &BlockCacheRecorder,
+        sampling_frequency: u64,
+    ) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_start_block_cache_recording(
+                self.inner,
+                recorder.inner,
+                sampling_frequency
+            ));
+            Ok(())
+        }
+    }
+
+    pub fn end_block_cache_recording(&self) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_end_block_cache_recording(self.inner));
+            Ok(())
+        }
+    }
+
+    /// Loads the blocks of the hot keys saved by `BlockCacheRecorder::save` into
+    /// the block cache from a background thread, while the DB keeps serving
+    /// requests. Keys of column families not in `cfs` are skipped.
+    ///
+    /// The warm-up stops when the returned `BlockCacheWarmer` is dropped.
+    pub fn start_block_cache_warmup(
+        &self,
+        path: &str,
+        cfs: &[&CFHandle],
+        rate_limiter: Option<&RateLimiter>,
+    ) -> Result<BlockCacheWarmer<'_>, String> {
+        let cpath = CString::new(path.as_bytes()).unwrap();
+        let cf_handles: Vec<_> = cfs.iter().map(|cf| cf.inner).collect();
+        let limiter = rate_limiter.map_or_else(ptr::null_mut, |l| l.inner);
+        unsafe {
+            let warmer = ffi_try!(crocksdb_block_cache_warmup_start(
+                self.inner,
+                cf_handles.as_ptr(),
+                cf_handles.len(),
+                cpath.as_ptr(),
+                limiter
+            ));
+            Ok(BlockCacheWarmer {
+                inner: warmer,
+                _db: PhantomData,
+            })
+        }
+    }
+
+    /// Traces block cache accesses into `trace_path`, for replay with
+    /// `BlockCacheSimulator`. One in `sampling_frequency` requests is traced, and
+    /// tracing stops once the file reaches `max_trace_file_size` bytes.
+    pub fn start_block_cache_trace(
+        &self,
+        trace_path: &str,
+        sampling_frequency: u64,
+        max_trace_file_size: u64,
+    ) -> Result<(), String> {
+        let cpath = CString::new(trace_path.as_bytes()).unwrap();
+        unsafe {
+            ffi_try!(crocksdb_start_block_cache_trace(
+                self.inner,
+                cpath.as_ptr(),
+                sampling_frequency,
+                max_trace_file_size
+            ));
+            Ok(())
+        }
+    }
+
+    pub fn end_block_cache_trace(&self) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_end_block_cache_trace(self.inner));
+            Ok(())
+        }
+    }
+
+    /// Traces Get, Seek and Write requests into `trace_path`, for replay with
+    /// `TraceReplayer`. One in `sampling_frequency` requests is traced, and
+    /// tracing stops once the file reaches `max_trace_file_size` bytes. Fails while
+    /// a block cache recording runs, as both use the DB tracer.
+    pub fn start_trace(
+        &self,
+        trace_path: &str,
+        sampling_frequency: u64,
+        max_trace_file_size: u64,
+    ) -> Result<(), String> {
+        let cpath = CString::new(trace_path.as_bytes()).unwrap();
+        unsafe {
+            ffi_try!(crocksdb_start_trace(
+                self.inner,
+                cpath.as_ptr(),
+                sampling_frequency,
+                max_trace_file_size
+            ));
+            Ok(())
+        }
+    }
+
+    pub fn end_trace(&self) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_end_trace(self.inner));
+            Ok(())
+        }
+    }
+
+    /// Creates a replayer of the trace at `trace_path` against this DB. Reads of
+    /// column families not in `cfs` are skipped.
+    pub fn new_trace_replayer(
+        &self,
+        trace_path: &str,
+        cfs: &[&CFHandle],
+    ) -> Result<TraceReplayer<'_>, String> {
+        let cpath = CString::new(trace_path.as_bytes()).unwrap();
+        let cf_handles: Vec<_> = cfs.iter().map(|cf| cf.inner).collect();
+        unsafe {
+            let replayer = ffi_try!(crocksdb_trace_replayer_create(
+                self.inner,
+                cf_handles.as_ptr(),
+                cf_handles.len(),
+                cpath.as_ptr()
+            ));
+            Ok(TraceReplayer {
+                inner: replayer,
+                _db: PhantomData,
+            })
+        }
+    }
 }
 
 impl Writable for DB {
@@ -2218,40 +2739,359 @@ impl DBVector {
     }
 }
 
-pub struct BackupEngine {
-    inner: *mut DBBackupEngine,
+/// The most recently used keys of a DB, sampled by `DB::start_block_cache_recording`.
+pub struct BlockCacheRecorder {
+    inner: *mut DBBlockCacheRecorder,
 }
 
-impl BackupEngine {
-    pub fn open(opts: DBOptions, path: &str) -> Result<BackupEngine, String> {
-        let cpath = match CString::new(path.as_bytes()) {
-            Ok(c) => c,
-            Err(_) => {
-                return Err(
-                    "Failed to convert path to CString when opening rocksdb backup engine"
-                        .to_owned(),
-                );
-            }
-        };
+unsafe impl Send for BlockCacheRecorder {}
+unsafe impl Sync for BlockCacheRecorder {}
 
-        if let Err(e) = fs::create_dir_all(path) {
-            return Err(format!(
-                "Failed to create rocksdb backup directory: {:?}",
-                e
-            ));
+impl BlockCacheRecorder {
+    pub fn new(max_keys: usize) -> BlockCacheRecorder {
+        unsafe {
+            BlockCacheRecorder {
+                inner: crocksdb_ffi::crocksdb_block_cache_recorder_create(max_keys),
+            }
         }
+    }
 
-        let backup_engine =
-            unsafe { ffi_try!(crocksdb_backup_engine_open(opts.inner, cpath.as_ptr())) };
+    pub fn len(&self) -> usize {
+        unsafe { crocksdb_ffi::crocksdb_block_cache_recorder_count(self.inner) }
+    }
 
-        Ok(BackupEngine {
-            inner: backup_engine,
-        })
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
     }
-}
 
-impl Drop for BackupEngine {
-    fn drop(&mut self) {
+    /// Saves the recorded keys, hottest first. The file is replaced atomically, so
+    /// it can be saved periodically while recording.
+    pub fn save(&self, path: &str) -> Result<(), String> {
+        let cpath = CString::new(path.as_bytes()).unwrap();
+        unsafe {
+            ffi_try!(crocksdb_block_cache_recorder_save(
+                self.inner,
+                cpath.as_ptr()
+            ));
+            Ok(())
+        }
+    }
+}
+
+impl Drop for BlockCacheRecorder {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_block_cache_recorder_destroy(self.inner);
+        }
+    }
+}
+
+/// A running block cache warm-up started by `DB::start_block_cache_warmup`.
+pub struct BlockCacheWarmer<'a> {
+    inner: *mut DBBlockCacheWarmer,
+    _db: PhantomData<&'a DB>,
+}
+
+impl<'a> BlockCacheWarmer<'a> {
+    pub fn is_done(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_block_cache_warmer_is_done(self.inner) }
+    }
+
+    pub fn keys_total(&self) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_block_cache_warmer_keys_total(self.inner) }
+    }
+
+    pub fn keys_loaded(&self) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_block_cache_warmer_keys_loaded(self.inner) }
+    }
+
+    /// Bytes read from SST files to fill the block cache so far.
+    pub fn bytes_loaded(&self) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_block_cache_warmer_bytes_loaded(self.inner) }
+    }
+}
+
+impl<'a> Drop for BlockCacheWarmer<'a> {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_block_cache_warmer_destroy(self.inner);
+        }
+    }
+}
+
+/// Replays a block cache trace against simulated caches to measure their miss
+/// ratios. All caches are simulated in one pass over the trace.
+pub struct BlockCacheSimulator {
+    inner: *mut DBBlockCacheSimulator,
+    num_caches: usize,
+}
+
+unsafe impl Send for BlockCacheSimulator {}
+
+impl BlockCacheSimulator {
+    pub fn new() -> BlockCacheSimulator {
+        unsafe {
+            BlockCacheSimulator {
+                inner: crocksdb_ffi::crocksdb_block_cache_simulator_create(),
+                num_caches: 0,
+            }
+        }
+    }
+
+    /// Adds an LRU cache, returning its index.
+    pub fn add_lru_cache(&mut self, capacity: usize, num_shard_bits: c_int) -> usize {
+        unsafe {
+            crocksdb_ffi::crocksdb_block_cache_simulator_add_lru_cache(
+                self.inner,
+                capacity,
+                num_shard_bits,
+            );
+        }
+        self.num_caches += 1;
+        self.num_caches - 1
+    }
+
+    /// Adds a clock cache, returning its index. Fails if RocksDB is built
+    /// without clock cache support.
+    pub fn add_clock_cache(
+        &mut self,
+        capacity: usize,
+        num_shard_bits: c_int,
+    ) -> Result<usize, String> {
+        unsafe {
+            ffi_try!(crocksdb_block_cache_simulator_add_clock_cache(
+                self.inner,
+                capacity,
+                num_shard_bits
+            ));
+        }
+        self.num_caches += 1;
+        Ok(self.num_caches - 1)
+    }
+
+    pub fn run(&mut self, trace_path: &str) -> Result<(), String> {
+        let cpath = CString::new(trace_path.as_bytes()).unwrap();
+        unsafe {
+            ffi_try!(crocksdb_block_cache_simulator_run(
+                self.inner,
+                cpath.as_ptr()
+            ));
+            Ok(())
+        }
+    }
+
+    pub fn num_accesses(&self) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_block_cache_simulator_num_accesses(self.inner) }
+    }
+
+    pub fn num_misses(&self, index: usize) -> u64 {
+        assert!(index < self.num_caches);
+        unsafe { crocksdb_ffi::crocksdb_block_cache_simulator_num_misses(self.inner, index) }
+    }
+
+    pub fn miss_ratio(&self, index: usize) -> f64 {
+        let accesses = self.num_accesses();
+        if accesses == 0 {
+            return 0.0;
+        }
+        self.num_misses(index) as f64 / accesses as f64
+    }
+}
+
+impl Drop for BlockCacheSimulator {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_block_cache_simulator_destroy(self.inner);
+        }
+    }
+}
+
+/// Replays a query trace written by `DB::start_trace` and measures the latency
+/// of every operation.
+pub struct TraceReplayer<'a> {
+    inner: *mut DBTraceReplayer,
+    _db: PhantomData<&'a DB>,
+}
+
+impl<'a> TraceReplayer<'a> {
+    /// Sets the replay speed relative to the original timing. 0 replays as fast
+    /// as possible. The default is 1.0.
+    pub fn set_speed(&mut self, speed: f64) {
+        unsafe {
+            crocksdb_ffi::crocksdb_trace_replayer_set_speed(self.inner, speed);
+        }
+    }
+
+    /// Sets the number of threads issuing the requests. The default is 1, which
+    /// keeps the original order.
+    pub fn set_threads(&mut self, num_threads: usize) {
+        unsafe {
+            crocksdb_ffi::crocksdb_trace_replayer_set_threads(self.inner, num_threads as c_int);
+        }
+    }
+
+    /// Replays the whole trace, blocking until all requests are done.
+    pub fn replay(&mut self) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_trace_replayer_replay(self.inner));
+            Ok(())
+        }
+    }
+
+    pub fn num_ops(&self, op_type: DBTraceOpType) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_trace_replayer_get_num_ops(self.inner, op_type) }
+    }
+
+    /// Latencies of the replayed requests of `op_type`, in microseconds.
+    pub fn histogram(&self, op_type: DBTraceOpType) -> Option<HistogramData> {
+        unsafe {
+            let mut data = HistogramData::default();
+            let ret = crocksdb_ffi::crocksdb_trace_replayer_get_histogram(
+                self.inner,
+                op_type,
+                &mut data.median,
+                &mut data.percentile95,
+                &mut data.percentile99,
+                &mut data.average,
+                &mut data.standard_deviation,
+                &mut data.max,
+            );
+            if !ret {
+                return None;
+            }
+            Some(data)
+        }
+    }
+}
+
+impl<'a> Drop for TraceReplayer<'a> {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_trace_replayer_destroy(self.inner);
+        }
+    }
+}
+
+pub struct BackupEngine {
+    inner: *mut DBBackupEngine,
+}
+
+impl BackupEngine {
+    pub fn open(opts: DBOptions, path: &str) -> Result<BackupEngine, String> {
+        let cpath = match CString::new(path.as_bytes()) {
+            Ok(c) => c,
+            Err(_) => {
+                return Err(
+                    "Failed to convert path to CString when opening rocksdb backup engine"
+                        .to_owned(),
+                );
+            }
+        };
+
+        if let Err(e) = fs::create_dir_all(path) {
+            return Err(format!(
+                "Failed to create rocksdb backup directory: {:?}",
+                e
+            ));
+        }
+
+        let backup_engine =
+            unsafe { ffi_try!(crocksdb_backup_engine_open(opts.inner, cpath.as_ptr())) };
+
+        Ok(BackupEngine {
+            inner: backup_engine,
+        })
+    }
+
+    /// Opens a backup engine with `backup_opts`. `opts` only provides the env.
+    pub fn open_opt(
+        opts: DBOptions,
+        backup_opts: &BackupableDBOptions,
+    ) -> Result<BackupEngine, String> {
+        if let Err(e) = fs::create_dir_all(backup_opts.backup_dir()) {
+            return Err(format!(
+                "Failed to create rocksdb backup directory: {:?}",
+                e
+            ));
+        }
+
+        let backup_engine = unsafe {
+            ffi_try!(crocksdb_backup_engine_open_opt(
+                opts.inner,
+                backup_opts.inner
+            ))
+        };
+
+        Ok(BackupEngine {
+            inner: backup_engine,
+        })
+    }
+
+    pub fn create_new_backup(&self, db: &DB, flush_before_backup: bool) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_backup_engine_create_new_backup_with_progress(
+                self.inner,
+                db.inner,
+                flush_before_backup,
+                ptr::null_mut(),
+                None
+            ));
+        }
+        Ok(())
+    }
+
+    /// Like `create_new_backup`, calling `progress` every
+    /// `callback_trigger_interval_size` bytes. It may be called concurrently
+    /// from several copying threads.
+    pub fn create_new_backup_with_progress<F>(
+        &self,
+        db: &DB,
+        flush_before_backup: bool,
+        progress: F,
+    ) -> Result<(), String>
+    where
+        F: Fn() + Sync,
+    {
+        extern "C" fn progress_callback<F: Fn()>(ctx: *mut c_void) {
+            let progress = unsafe { &*(ctx as *const F) };
+            progress();
+        }
+        unsafe {
+            ffi_try!(crocksdb_backup_engine_create_new_backup_with_progress(
+                self.inner,
+                db.inner,
+                flush_before_backup,
+                &progress as *const F as *mut c_void,
+                Some(progress_callback::<F>)
+            ));
+        }
+        Ok(())
+    }
+
+    /// Restores the latest backup, copying up to `max_background_operations`
+    /// files at a time.
+    pub fn restore_db_from_latest_backup(
+        &self,
+        db_dir: &str,
+        wal_dir: &str,
+        ropts: &RestoreOptions,
+    ) -> Result<(), String> {
+        let c_db_dir = CString::new(db_dir).unwrap();
+        let c_wal_dir = CString::new(wal_dir).unwrap();
+        unsafe {
+            ffi_try!(crocksdb_backup_engine_restore_db_from_latest_backup(
+                self.inner,
+                c_db_dir.as_ptr(),
+                c_wal_dir.as_ptr(),
+                ropts.inner
+            ));
+        }
+        Ok(())
+    }
+}
+
+impl Drop for BackupEngine {
+    fn drop(&mut self) {
         unsafe {
             crocksdb_ffi::crocksdb_backup_engine_close(self.inner);
         }
@@ -2394,6 +3234,32 @@ impl SstFileWriter {
         }
     }
 
+    /// Creates a writer that also computes a checksum of each whole file it
+    /// writes, returned by `ExternalSstFileInfo::file_checksum` after `finish`.
+    /// The checksum is taken as the file is written, so the writer never uses
+    /// direct writes.
+    pub fn new_with_file_checksum(
+        env_opt: EnvOptions,
+        opt: ColumnFamilyOptions,
+        cf: Option<&CFHandle>,
+        checksum_type: DBFileChecksumType,
+    ) -> Result<SstFileWriter, String> {
+        let cf = cf.map_or(ptr::null_mut(), |cf| cf.inner);
+        unsafe {
+            let inner = ffi_try!(crocksdb_sstfilewriter_create_with_file_checksum(
+                env_opt.inner,
+                opt.inner,
+                cf,
+                checksum_type
+            ));
+            Ok(SstFileWriter {
+                inner,
+                _env_opt: env_opt,
+                _opt: opt,
+            })
+        }
+    }
+
     /// Prepare SstFileWriter to write into file located at "file_path".
     pub fn open(&mut self, name: &str) -> Result<(), String> {
         let path = match CString::new(name.to_owned()) {
@@ -2478,6 +3344,282 @@ impl Drop for SstFileWriter {
     }
 }
 
+/// ParallelSstFileWriter creates a sequence of sst files from sorted input,
+/// building and compressing up to `num_threads` files at a time. A file is
+/// cut once its uncompressed input reaches `target_file_size`, or when `cut`
+/// is called. A cut waits until no range deletion is open, i.e. until a key
+/// after its end is added, so the files never overlap. Files are named
+/// `<path_prefix>000001.sst`, and so on.
+pub struct ParallelSstFileWriter {
+    inner: *mut crocksdb_ffi::ParallelSstFileWriter,
+}
+
+unsafe impl Send for ParallelSstFileWriter {}
+
+impl ParallelSstFileWriter {
+    pub fn new(
+        env_opt: EnvOptions,
+        opt: ColumnFamilyOptions,
+        path_prefix: &str,
+        target_file_size: u64,
+        num_threads: usize,
+    ) -> ParallelSstFileWriter {
+        ParallelSstFileWriter::create(
+            env_opt,
+            opt,
+            ptr::null_mut(),
+            path_prefix,
+            target_file_size,
+            num_threads,
+        )
+    }
+
+    pub fn new_cf(
+        env_opt: EnvOptions,
+        opt: ColumnFamilyOptions,
+        cf: &CFHandle,
+        path_prefix: &str,
+        target_file_size: u64,
+        num_threads: usize,
+    ) -> ParallelSstFileWriter {
+        ParallelSstFileWriter::create(
+            env_opt,
+            opt,
+            cf.inner,
+            path_prefix,
+            target_file_size,
+            num_threads,
+        )
+    }
+
+    fn create(
+        env_opt: EnvOptions,
+        opt: ColumnFamilyOptions,
+        cf: *mut crocksdb_ffi::DBCFHandle,
+        path_prefix: &str,
+        target_file_size: u64,
+        num_threads: usize,
+    ) -> ParallelSstFileWriter {
+        let path_prefix = CString::new(path_prefix).unwrap();
+        // The options are copied, so they don't need to outlive the writer.
+        unsafe {
+            ParallelSstFileWriter {
+                inner: crocksdb_ffi::crocksdb_parallel_sstfilewriter_create(
+                    env_opt.inner,
+                    opt.inner,
+                    cf,
+                    path_prefix.as_ptr(),
+                    target_file_size,
+                    num_threads as c_int,
+                ),
+            }
+        }
+    }
+
+    /// REQUIRES: key is after any previously added key according to comparator.
+    pub fn put(&mut self, key: &[u8], val: &[u8]) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_parallel_sstfilewriter_put(
+                self.inner,
+                key.as_ptr(),
+                key.len(),
+                val.as_ptr(),
+                val.len()
+            ));
+            Ok(())
+        }
+    }
+
+    pub fn merge(&mut self, key: &[u8], val: &[u8]) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_parallel_sstfilewriter_merge(
+                self.inner,
+                key.as_ptr(),
+                key.len(),
+                val.as_ptr(),
+                val.len()
+            ));
+            Ok(())
+        }
+    }
+
+    pub fn delete(&mut self, key: &[u8]) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_parallel_sstfilewriter_delete(
+                self.inner,
+                key.as_ptr(),
+                key.len()
+            ));
+            Ok(())
+        }
+    }
+
+    /// REQUIRES: begin_key is after any previously added key, and before
+    /// end_key. Later keys are ordered after begin_key, and may fall inside
+    /// the range.
+    pub fn delete_range(&mut self, begin_key: &[u8], end_key: &[u8]) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_parallel_sstfilewriter_delete_range(
+                self.inner,
+                begin_key.as_ptr(),
+                begin_key.len(),
+                end_key.as_ptr(),
+                end_key.len()
+            ));
+            Ok(())
+        }
+    }
+
+    /// Ends the current file here, e.g. at a region boundary. Does nothing
+    /// if nothing has been added since the last cut. While a range deletion
+    /// is open, the file ends before the first key added after its end.
+    pub fn cut(&mut self) -> Result<(), String> {
+        unsafe {
+            ffi_try!(crocksdb_parallel_sstfilewriter_cut(self.inner));
+            Ok(())
+        }
+    }
+
+    /// Waits for all files to be written and returns them in key order,
+    /// ready to be passed to a single `ingest_external_file_cf`. On error,
+    /// all files written so far are removed.
+    pub fn finish(&mut self) -> Result<Vec<ExternalSstFileInfo>, String> {
+        unsafe {
+            let num_files = ffi_try!(crocksdb_parallel_sstfilewriter_finish(self.inner));
+            let mut infos = Vec::with_capacity(num_files);
+            for i in 0..num_files {
+                let info = ExternalSstFileInfo::new();
+                crocksdb_ffi::crocksdb_parallel_sstfilewriter_get_file_info(
+                    self.inner, i, info.inner,
+                );
+                infos.push(info);
+            }
+            Ok(infos)
+        }
+    }
+}
+
+impl Drop for ParallelSstFileWriter {
+    fn drop(&mut self) {
+        unsafe { crocksdb_ffi::crocksdb_parallel_sstfilewriter_destroy(self.inner) }
+    }
+}
+
+/// SnapshotExporter writes the data a snapshot sees in a set of key ranges
+/// into sst files under a directory, scanning up to `num_threads` ranges at
+/// a time. Files are named `<dir>/<range>_<n>.sst`.
+pub struct SnapshotExporter<'a> {
+    inner: *mut crocksdb_ffi::DBSnapshotExporter,
+    num_ranges: usize,
+    _snap: PhantomData<&'a UnsafeSnap>,
+}
+
+/// The files and counts of one range exported by `SnapshotExporter`.
+pub struct ExportedRange {
+    pub files: Vec<ExternalSstFileInfo>,
+    pub num_keys: u64,
+    pub num_bytes: u64,
+}
+
+impl<'a> SnapshotExporter<'a> {
+    pub fn new<D: Deref<Target = DB>>(
+        snap: &'a Snapshot<D>,
+        dir: &str,
+        num_threads: usize,
+    ) -> SnapshotExporter<'a> {
+        let dir = CString::new(dir).unwrap();
+        unsafe {
+            SnapshotExporter {
+                inner: crocksdb_ffi::crocksdb_snapshot_exporter_create(
+                    snap.db.inner,
+                    snap.snap.get_inner(),
+                    dir.as_ptr(),
+                    num_threads as c_int,
+                ),
+                num_ranges: 0,
+                _snap: PhantomData,
+            }
+        }
+    }
+
+    /// Cuts each range into files of about `target_file_size` bytes, which
+    /// also bounds the memory used to build them. 0, the default, writes one
+    /// file per range.
+    pub fn set_target_file_size(&mut self, target_file_size: u64) {
+        unsafe {
+            crocksdb_ffi::crocksdb_snapshot_exporter_set_target_file_size(
+                self.inner,
+                target_file_size,
+            );
+        }
+    }
+
+    /// Limits the rate at which the files are written, as low priority
+    /// requests.
+    pub fn set_rate_limiter(&mut self, rate_limiter: &RateLimiter) {
+        unsafe {
+            crocksdb_ffi::crocksdb_snapshot_exporter_set_rate_limiter(
+                self.inner,
+                rate_limiter.inner,
+            );
+        }
+    }
+
+    /// Adds the range `[start_key, end_key)` of `cf`. An empty `end_key`
+    /// means no upper bound.
+    pub fn add_range(&mut self, cf: &CFHandle, start_key: &[u8], end_key: &[u8]) {
+        unsafe {
+            crocksdb_ffi::crocksdb_snapshot_exporter_add_range(
+                self.inner,
+                cf.inner,
+                start_key.as_ptr(),
+                start_key.len(),
+                end_key.as_ptr(),
+                end_key.len(),
+            );
+        }
+        self.num_ranges += 1;
+    }
+
+    /// Exports all ranges and returns them in the order they were added. A
+    /// range without any key has no files. On error, all files written so
+    /// far are removed. An exporter can only run once.
+    pub fn run(&mut self) -> Result<Vec<ExportedRange>, String> {
+        unsafe {
+            ffi_try!(crocksdb_snapshot_exporter_run(self.inner));
+            let mut ranges = Vec::with_capacity(self.num_ranges);
+            for range in 0..self.num_ranges {
+                let num_files =
+                    crocksdb_ffi::crocksdb_snapshot_exporter_range_file_count(self.inner, range);
+                let mut files = Vec::with_capacity(num_files);
+                for i in 0..num_files {
+                    let info = ExternalSstFileInfo::new();
+                    crocksdb_ffi::crocksdb_snapshot_exporter_range_file_info(
+                        self.inner, range, i, info.inner,
+                    );
+                    files.push(info);
+                }
+                ranges.push(ExportedRange {
+                    files,
+                    num_keys: crocksdb_ffi::crocksdb_snapshot_exporter_range_num_keys(
+                        self.inner, range,
+                    ),
+                    num_bytes: crocksdb_ffi::crocksdb_snapshot_exporter_range_num_bytes(
+                        self.inner, range,
+                    ),
+                });
+            }
+            Ok(ranges)
+        }
+    }
+}
+
+impl<'a> Drop for SnapshotExporter<'a> {
+    fn drop(&mut self) {
+        unsafe { crocksdb_ffi::crocksdb_snapshot_exporter_destroy(self.inner) }
+    }
+}
+
 pub struct ExternalSstFileInfo {
     inner: *mut crocksdb_ffi::ExternalSstFileInfo,
 }
@@ -2527,6 +3669,25 @@ impl ExternalSstFileInfo {
     pub fn num_entries(&self) -> u64 {
         unsafe { crocksdb_ffi::crocksdb_externalsstfileinfo_num_entries(self.inner) as u64 }
     }
+
+    /// The checksum of the whole file in big endian, empty unless the file is
+    /// written by `SstFileWriter::new_with_file_checksum`.
+    pub fn file_checksum(&self) -> &[u8] {
+        let mut len: size_t = 0;
+        unsafe {
+            let ptr =
+                crocksdb_ffi::crocksdb_externalsstfileinfo_file_checksum(self.inner, &mut len);
+            slice::from_raw_parts(ptr, len as usize)
+        }
+    }
+
+    pub fn file_checksum_func_name(&self) -> &str {
+        unsafe {
+            let ptr =
+                crocksdb_ffi::crocksdb_externalsstfileinfo_file_checksum_func_name(self.inner);
+            CStr::from_ptr(ptr).to_str().unwrap()
+        }
+    }
 }
 
 impl Drop for ExternalSstFileInfo {
@@ -2627,6 +3788,28 @@ impl Env {
         })
     }
 
+    // Create an env encrypting every file with AES-CTR under `key`, with a random
+    // IV per file. The key length must match `method`.
+    #[cfg(feature = "encryption")]
+    pub fn new_aes_ctr_encrypted_env(
+        base_env: Arc<Env>,
+        method: DBEncryptionMethod,
+        key: &[u8],
+    ) -> Result<Env, String> {
+        let env = unsafe {
+            ffi_try!(crocksdb_aes_ctr_encrypted_env_create(
+                base_env.inner,
+                method,
+                key.as_ptr() as *const c_char,
+                key.len()
+            ))
+        };
+        Ok(Env {
+            inner: env,
+            base: Some(base_env),
+        })
+    }
+
     pub fn new_file_system_inspected_env<T: FileSystemInspector>(
         base_env: Arc<Env>,
         file_system_inspector: T,
@@ -2644,6 +3827,24 @@ impl Env {
         })
     }
 
+    /// Creates an env throttling IO of `base_env` with `inspector`. The inspector
+    /// can be shared by several envs, which then share its budgets.
+    pub fn new_token_bucket_inspected_env(
+        base_env: Arc<Env>,
+        inspector: &TokenBucketInspector,
+    ) -> Result<Env, String> {
+        let env = unsafe {
+            crocksdb_ffi::crocksdb_file_system_inspected_env_create(
+                base_env.inner,
+                inspector.inner.inner,
+            )
+        };
+        Ok(Env {
+            inner: env,
+            base: Some(base_env),
+        })
+    }
+
     pub fn new_sequential_file(
         &self,
         path: &str,
@@ -2675,6 +3876,27 @@ impl Env {
             Ok(())
         }
     }
+
+    /// Reads the file and fails unless its whole-file checksum is `expected`,
+    /// e.g. to check a file before ingesting it or after backing it up.
+    pub fn verify_file_checksum(
+        &self,
+        path: &str,
+        checksum_type: DBFileChecksumType,
+        expected: &[u8],
+    ) -> Result<(), String> {
+        unsafe {
+            let file_path = CString::new(path).unwrap();
+            ffi_try!(crocksdb_verify_file_checksum(
+                self.inner,
+                file_path.as_ptr(),
+                checksum_type,
+                expected.as_ptr(),
+                expected.len()
+            ));
+            Ok(())
+        }
+    }
 }
 
 impl Drop for Env {
@@ -2746,6 +3968,19 @@ impl Cache {
             }
         }
     }
+
+    pub fn get_usage(&self) -> usize {
+        unsafe { crocksdb_ffi::crocksdb_cache_get_usage(self.inner) }
+    }
+
+    /// Returns 0 if no compressed secondary tier is configured.
+    pub fn get_compressed_secondary_usage(&self) -> usize {
+        unsafe { crocksdb_ffi::crocksdb_cache_get_compressed_secondary_usage(self.inner) }
+    }
+
+    pub fn get_compressed_secondary_capacity(&self) -> usize {
+        unsafe { crocksdb_ffi::crocksdb_cache_get_compressed_secondary_capacity(self.inner) }
+    }
 }
 
 impl Drop for Cache {
@@ -2756,6 +3991,89 @@ impl Drop for Cache {
     }
 }
 
+/// Bounds the memtable memory of every DB it is set on with
+/// `DBOptions::set_write_buffer_manager`, flushing once the usage exceeds
+/// `buffer_size`. If a cache is given, the memtable memory is also charged to
+/// it, so memtables and blocks share one capacity.
+pub struct WriteBufferManager {
+    pub inner: *mut crocksdb_ffi::DBWriteBufferManager,
+}
+
+unsafe impl Send for WriteBufferManager {}
+unsafe impl Sync for WriteBufferManager {}
+
+impl WriteBufferManager {
+    /// A `buffer_size` of 0 only tracks the usage.
+    pub fn new(buffer_size: usize, cache: Option<&Cache>) -> WriteBufferManager {
+        let cache = cache.map_or(ptr::null_mut(), |c| c.inner);
+        unsafe {
+            WriteBufferManager {
+                inner: crocksdb_ffi::crocksdb_write_buffer_manager_create(buffer_size, cache),
+            }
+        }
+    }
+
+    pub fn buffer_size(&self) -> usize {
+        unsafe { crocksdb_ffi::crocksdb_write_buffer_manager_buffer_size(self.inner) }
+    }
+
+    pub fn memory_usage(&self) -> usize {
+        unsafe { crocksdb_ffi::crocksdb_write_buffer_manager_memory_usage(self.inner) }
+    }
+
+    pub fn mutable_memtable_memory_usage(&self) -> usize {
+        unsafe {
+            crocksdb_ffi::crocksdb_write_buffer_manager_mutable_memtable_memory_usage(self.inner)
+        }
+    }
+
+    pub fn cost_to_cache(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_write_buffer_manager_cost_to_cache(self.inner) }
+    }
+
+    pub fn should_flush(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_write_buffer_manager_should_flush(self.inner) }
+    }
+}
+
+impl Drop for WriteBufferManager {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_write_buffer_manager_destroy(self.inner);
+        }
+    }
+}
+
+/// A block cache tier backed by log-structured files on local storage.
+///
+/// Attach it to a cache with `LRUCacheOptions::set_persistent_cache`. Blocks
+/// missed by the in-memory cache are looked up here before reading the SST file.
+pub struct PersistentCache {
+    pub inner: *mut DBPersistentCache,
+}
+
+impl PersistentCache {
+    pub fn new(path: &str, size: u64, optimized_for_nvm: bool) -> Result<PersistentCache, String> {
+        let cpath = CString::new(path.as_bytes()).unwrap();
+        unsafe {
+            let cache = ffi_try!(crocksdb_persistent_cache_create(
+                cpath.as_ptr(),
+                size,
+                optimized_for_nvm
+            ));
+            Ok(PersistentCache { inner: cache })
+        }
+    }
+}
+
+impl Drop for PersistentCache {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_persistent_cache_destroy(self.inner);
+        }
+    }
+}
+
 pub struct MemoryAllocator {
     pub inner: *mut DBMemoryAllocator,
 }
@@ -2798,6 +4116,35 @@ pub fn set_external_sst_file_global_seq_no(
     }
 }
 
+/// Sets the global seq no of every `(file, seq_no)` in `files`, rewriting up
+/// to `num_threads` files at a time, and returns their previous seq nos.
+pub fn set_external_sst_files_global_seq_no(
+    db: &DB,
+    cf: &CFHandle,
+    files: &[(&str, u64)],
+    num_threads: usize,
+) -> Result<Vec<u64>, String> {
+    let c_files: Vec<CString> = files
+        .iter()
+        .map(|&(f, _)| CString::new(f).unwrap())
+        .collect();
+    let c_file_ptrs: Vec<*const c_char> = c_files.iter().map(|f| f.as_ptr()).collect();
+    let seq_nos: Vec<u64> = files.iter().map(|&(_, seq_no)| seq_no).collect();
+    let mut pre_seq_nos = vec![0; files.len()];
+    unsafe {
+        ffi_try!(crocksdb_set_external_sst_files_global_seq_no(
+            db.inner,
+            cf.inner,
+            c_file_ptrs.as_ptr(),
+            seq_nos.as_ptr(),
+            files.len(),
+            num_threads as c_int,
+            pre_seq_nos.as_mut_ptr()
+        ));
+    }
+    Ok(pre_seq_nos)
+}
+
 pub fn load_latest_options(
     dbpath: &str,
     env: &Env,
@@ -3104,6 +4451,52 @@ mod test {
         }
     }
 
+    #[test]
+    fn backup_with_options_test() {
+        use std::sync::atomic::{AtomicUsize, Ordering};
+
+        let db_dir = tempdir_with_prefix("_rust_rocksdb_backup_options_test");
+        let db = DB::open_default(db_dir.path().to_str().unwrap()).unwrap();
+        let value = vec![b'v'; 1024];
+        for i in 0..1000 {
+            db.put(format!("k{:04}", i).as_bytes(), &value).unwrap();
+        }
+
+        let backup_dir = tempdir_with_prefix("_rust_rocksdb_backup_options_test_backup");
+        let mut backup_opts = BackupableDBOptions::new(backup_dir.path().to_str().unwrap());
+        backup_opts.set_share_files_with_checksum(true);
+        backup_opts.set_max_background_operations(4);
+        backup_opts.set_callback_trigger_interval_size(64 * 1024);
+        let limiter = RateLimiter::new(1 << 30, 100 * 1000, 10);
+        backup_opts.set_backup_rate_limiter(&limiter);
+        backup_opts.set_restore_rate_limiter(&limiter);
+        let backup_engine = BackupEngine::open_opt(DBOptions::new(), &backup_opts).unwrap();
+
+        let progress = AtomicUsize::new(0);
+        backup_engine
+            .create_new_backup_with_progress(&db, true, || {
+                progress.fetch_add(1, Ordering::SeqCst);
+            })
+            .unwrap();
+        assert!(progress.load(Ordering::SeqCst) > 0);
+        assert!(limiter.get_total_bytes_through(RateLimiter::PRIORITY_TOTAL) > 0);
+
+        // An unchanged table file isn't copied again.
+        db.put(b"k9999", &value).unwrap();
+        backup_engine.create_new_backup(&db, true).unwrap();
+        let shared = backup_dir.path().join("shared_checksum");
+        assert_eq!(fs::read_dir(&shared).unwrap().count(), 2);
+
+        let restore_dir = tempdir_with_prefix("_rust_rocksdb_backup_options_test_restore");
+        let restore_path = restore_dir.path().to_str().unwrap();
+        backup_engine
+            .restore_db_from_latest_backup(restore_path, restore_path, &RestoreOptions::new())
+            .unwrap();
+        let restored_db = DB::open_default(restore_path).unwrap();
+        assert_eq!(restored_db.get(b"k0000").unwrap().unwrap(), &value[..]);
+        assert_eq!(restored_db.get(b"k9999").unwrap().unwrap(), &value[..]);
+    }
+
     #[test]
     fn log_dir_test() {
         let db_dir = tempdir_with_prefix("_rust_rocksdb_logdirtest");
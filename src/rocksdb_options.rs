@@ -19,12 +19,12 @@ use compaction_filter::{
 };
 use comparator::{self, compare_callback, ComparatorCallback};
 use crocksdb_ffi::{
-    self, DBBlockBasedTableOptions, DBBottommostLevelCompaction, DBCompactOptions,
-    DBCompactionOptions, DBCompressionType, DBFifoCompactionOptions, DBFlushOptions,
-    DBInfoLogLevel, DBInstance, DBLRUCacheOptions, DBRateLimiter, DBRateLimiterMode, DBReadOptions,
-    DBRecoveryMode, DBRestoreOptions, DBSnapshot, DBStatisticsHistogramType,
-    DBStatisticsTickerType, DBTitanDBOptions, DBTitanReadOptions, DBWriteOptions, IndexType,
-    Options,
+    self, DBBackupableDBOptions, DBBlockBasedTableOptions, DBBottommostLevelCompaction,
+    DBChecksumType, DBCompactOptions, DBCompactionOptions, DBCompressionType,
+    DBFifoCompactionOptions, DBFlushOptions, DBInfoLogLevel, DBInstance, DBLRUCacheOptions,
+    DBRateLimiter, DBRateLimiterMode, DBReadOptions, DBRecoveryMode, DBRestoreOptions, DBSnapshot,
+    DBStatisticsHistogramType, DBStatisticsTickerType, DBTitanDBOptions, DBTitanReadOptions,
+    DBWriteOptions, IndexType, Options,
 };
 use event_listener::{new_event_listener, EventListener};
 use libc::{self, c_double, c_int, c_uchar, c_void, size_t};
@@ -32,7 +32,7 @@ use logger::{new_logger, Logger};
 use merge_operator::MergeFn;
 use merge_operator::{self, full_merge_callback, partial_merge_callback, MergeOperatorCallback};
 use rocksdb::Env;
-use rocksdb::{Cache, MemoryAllocator};
+use rocksdb::{Cache, MemoryAllocator, PersistentCache, WriteBufferManager};
 use slice_transform::{new_slice_transform, SliceTransform};
 use sst_partitioner::{new_sst_partitioner_factory, SstPartitionerFactory};
 use std::ffi::{CStr, CString};
@@ -103,6 +103,16 @@ impl BlockBasedOptions {
         }
     }
 
+    /// Sets the checksum written along with every block. xxHash64 is usually
+    /// cheaper to verify than the default crc32c on machines without a crc32
+    /// instruction. Files keep the type they were written with, so changing it
+    /// only affects new files.
+    pub fn set_checksum(&mut self, checksum: DBChecksumType) {
+        unsafe {
+            crocksdb_ffi::crocksdb_block_based_options_set_checksum(self.inner, checksum);
+        }
+    }
+
     pub fn set_block_cache(&mut self, cache: &Cache) {
         unsafe {
             crocksdb_ffi::crocksdb_block_based_options_set_block_cache(self.inner, cache.inner);
@@ -191,13 +201,23 @@ impl BlockBasedOptions {
 }
 
 pub struct RateLimiter {
-    inner: *mut DBRateLimiter,
+    pub inner: *mut DBRateLimiter,
 }
 
 unsafe impl Send for RateLimiter {}
 unsafe impl Sync for RateLimiter {}
 
 impl RateLimiter {
+    /// The priorities passed as `pri` to `request` and the statistics getters.
+    /// `PRIORITY_TOTAL` sums all priorities in the getters. Only a priority rate
+    /// limiter serves mid and user separately; other limiters request them as low
+    /// and high, and report 0 for them in the getters.
+    pub const PRIORITY_LOW: c_uchar = 0;
+    pub const PRIORITY_HIGH: c_uchar = 1;
+    pub const PRIORITY_TOTAL: c_uchar = 2;
+    pub const PRIORITY_MID: c_uchar = 3;
+    pub const PRIORITY_USER: c_uchar = 4;
+
     pub fn new(rate_bytes_per_sec: i64, refill_period_us: i64, fairness: i32) -> RateLimiter {
         let limiter = unsafe {
             crocksdb_ffi::crocksdb_ratelimiter_create(
@@ -247,6 +267,31 @@ impl RateLimiter {
         RateLimiter { inner: limiter }
     }
 
+    /// Creates a rate limiter with high, mid, low and user priorities, passed as
+    /// the `PRIORITY_*` constants to `request`. Flushes (high) are always served first;
+    /// the rest of the budget is shared between user, mid and low requests in
+    /// proportion to their weights. Compactions request at low priority.
+    pub fn new_priority(
+        rate_bytes_per_sec: i64,
+        refill_period_us: i64,
+        user_weight: i32,
+        mid_weight: i32,
+        low_weight: i32,
+        mode: DBRateLimiterMode,
+    ) -> RateLimiter {
+        let limiter = unsafe {
+            crocksdb_ffi::crocksdb_priority_ratelimiter_create(
+                rate_bytes_per_sec,
+                refill_period_us,
+                user_weight,
+                mid_weight,
+                low_weight,
+                mode,
+            )
+        };
+        RateLimiter { inner: limiter }
+    }
+
     pub fn set_bytes_per_second(&self, bytes_per_sec: i64) {
         unsafe {
             crocksdb_ffi::crocksdb_ratelimiter_set_bytes_per_second(self.inner, bytes_per_sec);
@@ -274,6 +319,12 @@ impl RateLimiter {
     pub fn get_total_requests(&self, pri: c_uchar) -> i64 {
         unsafe { crocksdb_ffi::crocksdb_ratelimiter_get_total_requests(self.inner, pri) }
     }
+
+    /// Time requests of `pri` spent waiting for the limiter. Only accounted by a
+    /// priority rate limiter.
+    pub fn get_total_wait_micros(&self, pri: c_uchar) -> u64 {
+        unsafe { crocksdb_ffi::crocksdb_ratelimiter_get_total_wait_micros(self.inner, pri) }
+    }
 }
 
 impl Drop for RateLimiter {
@@ -588,6 +639,9 @@ impl CompactOptions {
         }
     }
 
+    /// Splits the compaction into up to `v` key ranges whose output files are
+    /// built, and compressed, on separate threads. Overrides the DB option
+    /// when positive.
     pub fn set_max_subcompactions(&mut self, v: i32) {
         unsafe {
             crocksdb_ffi::crocksdb_compactoptions_set_max_subcompactions(self.inner, v);
@@ -760,6 +814,46 @@ impl DBOptions {
         }
     }
 
+    /// The number of threads used to open table files on DB open when
+    /// `max_open_files` is -1.
+    pub fn set_max_file_opening_threads(&mut self, n: c_int) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_max_file_opening_threads(self.inner, n);
+        }
+    }
+
+    pub fn get_max_file_opening_threads(&self) -> i32 {
+        unsafe { crocksdb_ffi::crocksdb_options_get_max_file_opening_threads(self.inner) }
+    }
+
+    /// Skips reading table properties of up to 20 files on DB open to
+    /// initialize the stats used for compaction.
+    pub fn set_skip_stats_update_on_db_open(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_skip_stats_update_on_db_open(self.inner, v);
+        }
+    }
+
+    pub fn get_skip_stats_update_on_db_open(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_options_get_skip_stats_update_on_db_open(self.inner) }
+    }
+
+    /// Skips getting the size of every table file on DB open to check it
+    /// against the MANIFEST.
+    pub fn set_skip_checking_sst_file_sizes_on_db_open(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_skip_checking_sst_file_sizes_on_db_open(
+                self.inner, v,
+            );
+        }
+    }
+
+    pub fn get_skip_checking_sst_file_sizes_on_db_open(&self) -> bool {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_get_skip_checking_sst_file_sizes_on_db_open(self.inner)
+        }
+    }
+
     pub fn set_max_total_wal_size(&mut self, size: u64) {
         unsafe {
             crocksdb_ffi::crocksdb_options_set_max_total_wal_size(self.inner, size);
@@ -844,6 +938,9 @@ impl DBOptions {
         unsafe { crocksdb_ffi::crocksdb_options_get_max_background_flushes(self.inner) as i32 }
     }
 
+    /// Maximum number of threads a single L0 or manual compaction is split
+    /// across. Each thread compresses its own output files, so this is what
+    /// spreads compression of one compaction over several cores.
     pub fn set_max_subcompactions(&mut self, n: u32) {
         unsafe {
             crocksdb_ffi::crocksdb_options_set_max_subcompactions(self.inner, n);
@@ -862,6 +959,29 @@ impl DBOptions {
         }
     }
 
+    /// Keeps the data replayed from the WALs in the memtables on open
+    /// instead of flushing it, unless it doesn't fit in the write buffers.
+    pub fn set_avoid_flush_during_recovery(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_avoid_flush_during_recovery(self.inner, v);
+        }
+    }
+
+    pub fn get_avoid_flush_during_recovery(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_options_get_avoid_flush_during_recovery(self.inner) }
+    }
+
+    /// Skips flushing the memtables on close when the data is in the WAL.
+    pub fn set_avoid_flush_during_shutdown(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_avoid_flush_during_shutdown(self.inner, v);
+        }
+    }
+
+    pub fn get_avoid_flush_during_shutdown(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_options_get_avoid_flush_during_shutdown(self.inner) }
+    }
+
     pub fn set_delayed_write_rate(&mut self, rate: u64) {
         unsafe {
             crocksdb_ffi::crocksdb_options_set_delayed_write_rate(self.inner, rate);
@@ -1075,6 +1195,33 @@ impl DBOptions {
         }
     }
 
+    /// Shares `rate_limiter` with the DB. Unlike the other setters, the limiter
+    /// stays usable by the application afterwards.
+    pub fn set_shared_rate_limiter(&mut self, rate_limiter: &RateLimiter) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_shared_ratelimiter(self.inner, rate_limiter.inner);
+        }
+    }
+
+    /// Returns a handle to the rate limiter of the options, if any. A priority
+    /// limiter set on these options keeps serving and accounting all of its
+    /// priorities through it.
+    pub fn get_rate_limiter(&self) -> Option<RateLimiter> {
+        let limiter = unsafe { crocksdb_ffi::crocksdb_options_get_ratelimiter(self.inner) };
+        if limiter.is_null() {
+            return None;
+        }
+        Some(RateLimiter { inner: limiter })
+    }
+
+    /// Shares `manager` with the DB, overriding `db_write_buffer_size`. The same
+    /// manager can be set on several DBs to bound their memtables together.
+    pub fn set_write_buffer_manager(&mut self, manager: &WriteBufferManager) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_write_buffer_manager(self.inner, manager.inner);
+        }
+    }
+
     pub fn set_rate_bytes_per_sec(&mut self, rate_bytes_per_sec: i64) -> Result<(), String> {
         let limiter = unsafe { crocksdb_ffi::crocksdb_options_get_ratelimiter(self.inner) };
         if limiter.is_null() {
@@ -1223,6 +1370,20 @@ impl DBOptions {
         }
     }
 
+    /// Reserves the bottommost level for files ingested with
+    /// `IngestExternalFileOptions::set_ingest_behind`. Must be set when the
+    /// DB is created, and requires universal compaction with at least 3
+    /// levels.
+    pub fn set_allow_ingest_behind(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_options_set_allow_ingest_behind(self.inner, v);
+        }
+    }
+
+    pub fn get_allow_ingest_behind(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_options_get_allow_ingest_behind(self.inner) }
+    }
+
     pub fn get_db_paths_num(&self) -> usize {
         unsafe { crocksdb_ffi::crocksdb_options_get_db_paths_num(self.inner) }
     }
@@ -2090,6 +2251,9 @@ impl IngestExternalFileOptions {
 
     /// If set to true, a global_seqno will be written to a given offset in the external SST file
     /// for backward compatibility.
+    ///
+    /// If set to false, the assigned seqno is only recorded in the MANIFEST, which saves a write
+    /// and an fsync per file. Such files can't be read by RocksDB versions before 5.16.
     pub fn set_write_global_seqno(&mut self, whether_write: bool) {
         unsafe {
             crocksdb_ffi::crocksdb_ingestexternalfileoptions_set_write_global_seqno(
@@ -2098,6 +2262,23 @@ impl IngestExternalFileOptions {
             );
         }
     }
+
+    pub fn get_ingest_behind(&self) -> bool {
+        unsafe { crocksdb_ffi::crocksdb_ingestexternalfileoptions_get_ingest_behind(self.inner) }
+    }
+
+    /// If set to true, the files are ingested into the bottommost level with
+    /// sequence number 0, behind all existing data. Keys that already exist
+    /// in the DB are not overwritten, and no global seqno is assigned.
+    /// Requires `DBOptions::set_allow_ingest_behind`.
+    pub fn set_ingest_behind(&mut self, whether_behind: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_ingestexternalfileoptions_set_ingest_behind(
+                self.inner,
+                whether_behind,
+            );
+        }
+    }
 }
 
 impl Drop for IngestExternalFileOptions {
@@ -2162,6 +2343,104 @@ impl Drop for RestoreOptions {
     }
 }
 
+/// Options of a `BackupEngine`, for the backup directory `backup_dir`.
+pub struct BackupableDBOptions {
+    pub inner: *mut DBBackupableDBOptions,
+    backup_dir: String,
+}
+
+impl BackupableDBOptions {
+    pub fn new(backup_dir: &str) -> BackupableDBOptions {
+        let c_dir = CString::new(backup_dir).unwrap();
+        unsafe {
+            BackupableDBOptions {
+                inner: crocksdb_ffi::crocksdb_backupable_db_options_create(c_dir.as_ptr()),
+                backup_dir: backup_dir.to_owned(),
+            }
+        }
+    }
+
+    pub fn backup_dir(&self) -> &str {
+        &self.backup_dir
+    }
+
+    /// If set to false, every backup is self-contained and table files are
+    /// copied into each of them. Defaults to true.
+    pub fn set_share_table_files(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_share_table_files(self.inner, v);
+        }
+    }
+
+    /// Shares table files by checksum and size rather than by file number,
+    /// so identical files are stored once even across DBs, and an
+    /// incremental backup only copies the table files it hasn't seen.
+    pub fn set_share_files_with_checksum(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_share_files_with_checksum(
+                self.inner, v,
+            );
+        }
+    }
+
+    pub fn set_sync(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_sync(self.inner, v);
+        }
+    }
+
+    pub fn set_backup_log_files(&mut self, v: bool) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_backup_log_files(self.inner, v);
+        }
+    }
+
+    /// Number of threads copying files, for both backups and restores.
+    pub fn set_max_background_operations(&mut self, v: i32) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_max_background_operations(
+                self.inner, v,
+            );
+        }
+    }
+
+    /// Number of bytes copied between two calls of a backup's progress
+    /// callback.
+    pub fn set_callback_trigger_interval_size(&mut self, v: u64) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_callback_trigger_interval_size(
+                self.inner, v,
+            );
+        }
+    }
+
+    pub fn set_backup_rate_limiter(&mut self, limiter: &RateLimiter) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_backup_rate_limiter(
+                self.inner,
+                limiter.inner,
+            );
+        }
+    }
+
+    pub fn set_restore_rate_limiter(&mut self, limiter: &RateLimiter) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_set_restore_rate_limiter(
+                self.inner,
+                limiter.inner,
+            );
+        }
+    }
+}
+
+impl Drop for BackupableDBOptions {
+    fn drop(&mut self) {
+        unsafe {
+            crocksdb_ffi::crocksdb_backupable_db_options_destroy(self.inner);
+        }
+    }
+}
+
 pub struct FifoCompactionOptions {
     pub inner: *mut DBFifoCompactionOptions,
 }
@@ -2257,6 +2536,33 @@ impl LRUCacheOptions {
             );
         }
     }
+
+    /// Attaches a tier of `capacity` bytes that keeps blocks in their compressed
+    /// on-disk form behind the cache. A hit in the tier is decompressed and promoted
+    /// into the primary cache, so it is much cheaper than a read from disk. Hits and
+    /// misses are counted by the `BlockCacheCompressed*` tickers.
+    pub fn set_compressed_secondary_capacity(&mut self, capacity: usize) {
+        unsafe {
+            crocksdb_ffi::crocksdb_lru_cache_options_set_compressed_secondary_capacity(
+                self.inner, capacity,
+            );
+        }
+    }
+
+    pub fn set_compressed_secondary_num_shard_bits(&mut self, num_shard_bits: c_int) {
+        unsafe {
+            crocksdb_ffi::crocksdb_lru_cache_options_set_compressed_secondary_num_shard_bits(
+                self.inner,
+                num_shard_bits,
+            );
+        }
+    }
+
+    pub fn set_persistent_cache(&mut self, cache: &PersistentCache) {
+        unsafe {
+            crocksdb_ffi::crocksdb_lru_cache_options_set_persistent_cache(self.inner, cache.inner);
+        }
+    }
 }
 
 impl Drop for LRUCacheOptions {
@@ -1,3 +1,6 @@
+mod test_block_cache_trace;
+mod test_block_cache_warmup;
+mod test_checkpoint;
 mod test_column_family;
 mod test_compact_range;
 mod test_compaction_filter;
@@ -20,6 +23,7 @@ mod test_statistics;
 mod test_table_properties;
 mod test_table_properties_rc;
 mod test_titan;
+mod test_trace_replay;
 mod test_ttl;
 
 fn tempdir_with_prefix(prefix: &str) -> tempfile::TempDir {
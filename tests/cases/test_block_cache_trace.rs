@@ -0,0 +1,54 @@
+// Copyright 2020 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use rocksdb::{BlockCacheSimulator, Writable, DB};
+
+use super::tempdir_with_prefix;
+
+#[test]
+fn test_block_cache_trace() {
+    let path = tempdir_with_prefix("_rust_rocksdb_block_cache_trace");
+    let db_path = path.path().join("db");
+    let trace_path = path.path().join("trace");
+    let trace_path = trace_path.to_str().unwrap();
+
+    let db = DB::open_default(db_path.to_str().unwrap()).unwrap();
+    for i in 0..1000 {
+        let key = format!("k{:04}", i);
+        db.put(key.as_bytes(), &[b'v'; 128]).unwrap();
+    }
+    db.flush(true).unwrap();
+
+    db.start_block_cache_trace(trace_path, 1, 64 << 20).unwrap();
+    for _ in 0..3 {
+        for i in 0..1000 {
+            let key = format!("k{:04}", i);
+            assert!(db.get(key.as_bytes()).unwrap().is_some());
+        }
+    }
+    db.end_block_cache_trace().unwrap();
+
+    let mut simulator = BlockCacheSimulator::new();
+    let small = simulator.add_lru_cache(1, 0);
+    let large = simulator.add_lru_cache(64 << 20, 4);
+    simulator.run(trace_path).unwrap();
+    assert!(simulator.num_accesses() > 0);
+    // A cache that fits nothing misses on every access.
+    assert_eq!(simulator.num_misses(small), simulator.num_accesses());
+    assert!(simulator.num_misses(large) < simulator.num_misses(small));
+    assert!(simulator.miss_ratio(large) < 0.5);
+
+    let mut simulator = BlockCacheSimulator::new();
+    simulator.add_lru_cache(1 << 20, 0);
+    assert!(simulator.run(&format!("{}.missing", trace_path)).is_err());
+}
@@ -0,0 +1,94 @@
+// Copyright 2020 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::thread;
+use std::time::Duration;
+
+use rocksdb::{
+    BlockBasedOptions, BlockCacheRecorder, Cache, ColumnFamilyOptions, DBOptions, LRUCacheOptions,
+    ReadOptions, SeekKey, Writable, DB,
+};
+
+use super::tempdir_with_prefix;
+
+fn open_with_cache(path: &str, cache: &Cache) -> DB {
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    let mut block_opts = BlockBasedOptions::new();
+    block_opts.set_block_cache(cache);
+    let mut cf_opts = ColumnFamilyOptions::new();
+    cf_opts.set_block_based_table_factory(&block_opts);
+    DB::open_cf(opts, path, vec![("default", cf_opts)]).unwrap()
+}
+
+fn new_cache() -> Cache {
+    let mut cache_opts = LRUCacheOptions::new();
+    cache_opts.set_capacity(8 << 20);
+    Cache::new_lru_cache(cache_opts)
+}
+
+#[test]
+fn test_block_cache_warmup() {
+    let path = tempdir_with_prefix("_rust_rocksdb_block_cache_warmup");
+    let db_path = path.path().join("db");
+    let db_path = db_path.to_str().unwrap();
+    let hot_keys = path.path().join("hot_keys");
+    let hot_keys = hot_keys.to_str().unwrap();
+
+    {
+        let cache = new_cache();
+        let db = open_with_cache(db_path, &cache);
+        for i in 0..1000 {
+            let key = format!("k{:04}", i);
+            db.put(key.as_bytes(), &[b'v'; 128]).unwrap();
+        }
+        db.flush(true).unwrap();
+
+        let recorder = BlockCacheRecorder::new(100);
+        db.start_block_cache_recording(&recorder, 1).unwrap();
+        // The DB tracer takes one trace at a time.
+        assert!(db.start_block_cache_recording(&recorder, 1).is_err());
+        let trace_path = path.path().join("trace");
+        assert!(db
+            .start_trace(trace_path.to_str().unwrap(), 1, 64 << 20)
+            .is_err());
+        assert!(db.end_trace().is_err());
+        for i in 0..200 {
+            let key = format!("k{:04}", i * 5);
+            assert!(db.get(key.as_bytes()).unwrap().is_some());
+        }
+        let mut iter = db.iter_opt(ReadOptions::new());
+        assert!(iter.seek(SeekKey::Key(b"k0500")).unwrap());
+        db.end_block_cache_recording().unwrap();
+        assert_eq!(recorder.len(), 100);
+        recorder.save(hot_keys).unwrap();
+    }
+
+    let cache = new_cache();
+    let db = open_with_cache(db_path, &cache);
+    let usage_before = cache.get_usage();
+    let warmer = db
+        .start_block_cache_warmup(hot_keys, &[db.cf_handle("default").unwrap()], None)
+        .unwrap();
+    while !warmer.is_done() {
+        thread::sleep(Duration::from_millis(10));
+    }
+    assert_eq!(warmer.keys_total(), 100);
+    assert_eq!(warmer.keys_loaded(), 100);
+    assert!(warmer.bytes_loaded() > 0);
+    assert!(cache.get_usage() > usage_before);
+
+    assert!(db
+        .start_block_cache_warmup(&format!("{}.missing", hot_keys), &[], None)
+        .is_err());
+}
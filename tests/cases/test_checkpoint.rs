@@ -0,0 +1,68 @@
+// Copyright 2020 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::fs;
+
+use rocksdb::{Writable, DB};
+
+use super::tempdir_with_prefix;
+
+fn sst_files(path: &str) -> Vec<fs::DirEntry> {
+    fs::read_dir(path)
+        .unwrap()
+        .map(|e| e.unwrap())
+        .filter(|e| e.file_name().to_str().unwrap().ends_with(".sst"))
+        .collect()
+}
+
+#[test]
+fn test_create_checkpoint() {
+    let path = tempdir_with_prefix("_rust_rocksdb_checkpoint");
+    let db_path = path.path().join("db");
+    let db = DB::open_default(db_path.to_str().unwrap()).unwrap();
+    db.put(b"k1", b"v1").unwrap();
+    db.flush(true).unwrap();
+    db.put(b"k2", b"v2").unwrap();
+
+    // Without a flush the unflushed write is carried over by the WAL.
+    let wal_checkpoint = path.path().join("wal_checkpoint");
+    let wal_checkpoint = wal_checkpoint.to_str().unwrap();
+    db.create_checkpoint(wal_checkpoint, u64::max_value())
+        .unwrap();
+    assert_eq!(sst_files(wal_checkpoint).len(), 1);
+    #[cfg(unix)]
+    {
+        use std::os::unix::fs::MetadataExt;
+        // Sst files are shared with the source DB.
+        let entry = &sst_files(wal_checkpoint)[0];
+        assert_eq!(entry.metadata().unwrap().nlink(), 2);
+    }
+
+    // With a flush every write ends up in an sst.
+    let flush_checkpoint = path.path().join("flush_checkpoint");
+    let flush_checkpoint = flush_checkpoint.to_str().unwrap();
+    db.create_checkpoint(flush_checkpoint, 0).unwrap();
+    assert_eq!(sst_files(flush_checkpoint).len(), 2);
+
+    // The target must not exist.
+    assert!(db.create_checkpoint(flush_checkpoint, 0).is_err());
+
+    db.put(b"k3", b"v3").unwrap();
+    drop(db);
+    for checkpoint in &[wal_checkpoint, flush_checkpoint] {
+        let db = DB::open_default(checkpoint).unwrap();
+        assert_eq!(db.get(b"k1").unwrap().unwrap(), b"v1");
+        assert_eq!(db.get(b"k2").unwrap().unwrap(), b"v2");
+        assert!(db.get(b"k3").unwrap().is_none());
+    }
+}
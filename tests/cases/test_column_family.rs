@@ -159,3 +159,73 @@ pub fn test_column_family_option_use_doubly_skiplist() {
     let memtable_name = cf_opts.get_memtable_factory_name();
     assert_eq!("DoublySkipListFactory", memtable_name.unwrap());
 }
+
+#[test]
+pub fn test_export_import_column_family() {
+    let path = tempdir_with_prefix("_rust_rocksdb_export_cf");
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    let mut db = DB::open(opts, path.path().to_str().unwrap()).unwrap();
+    db.create_cf("cf").unwrap();
+    let cf = db.cf_handle("cf").unwrap();
+    for i in 0..100u8 {
+        db.put_cf(cf, &[i], &[i]).unwrap();
+    }
+    db.flush_cf(cf, true).unwrap();
+    db.compact_range_cf(cf, None, None);
+    // Newer versions and deletions stay in level 0 above the compacted data.
+    for i in 0..10u8 {
+        db.put_cf(cf, &[i], b"new").unwrap();
+        db.delete_cf(cf, &[i + 10]).unwrap();
+    }
+    db.delete_range_cf(cf, &[20], &[30]).unwrap();
+    db.flush_cf(cf, true).unwrap();
+
+    let export_dir = tempdir_with_prefix("_rust_rocksdb_export_cf_dir");
+    let export_path = export_dir.path().join("export");
+    let metadata = db
+        .export_column_family(cf, export_path.to_str().unwrap())
+        .unwrap();
+    let files = metadata.get_files();
+    assert_eq!(files.len(), 2);
+    let mut levels: Vec<_> = files.iter().map(|f| f.get_level()).collect();
+    levels.sort();
+    assert_eq!(levels[0], 0);
+    assert!(levels[1] > 0);
+    for f in &files {
+        assert!(export_path
+            .join(f.get_name().trim_start_matches('/'))
+            .exists());
+    }
+    // The export dir must not exist yet.
+    assert!(db
+        .export_column_family(cf, export_path.to_str().unwrap())
+        .is_err());
+
+    let path2 = tempdir_with_prefix("_rust_rocksdb_import_cf");
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    let mut db2 = DB::open(opts, path2.path().to_str().unwrap()).unwrap();
+    db2.create_column_family_with_import("imported", &metadata)
+        .unwrap();
+    let imported = db2.cf_handle("imported").unwrap();
+    for i in 0..100u8 {
+        let value = db2.get_cf(imported, &[i]).unwrap();
+        if i < 10 {
+            assert_eq!(&*value.unwrap(), b"new");
+        } else if i < 30 {
+            assert!(value.is_none());
+        } else {
+            assert_eq!(&*value.unwrap(), &[i]);
+        }
+    }
+    // Exported files are left for other imports.
+    for f in &files {
+        assert!(export_path
+            .join(f.get_name().trim_start_matches('/'))
+            .exists());
+    }
+    assert!(db2
+        .create_column_family_with_import("imported", &metadata)
+        .is_err());
+}
@@ -11,8 +11,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::fs;
 use std::sync::Arc;
 
+#[cfg(feature = "encryption")]
+use rocksdb::DBEncryptionMethod;
 use rocksdb::{DBOptions, Env, Writable, DB};
 
 use super::tempdir_with_prefix;
@@ -36,6 +39,24 @@ fn test_ctr_encrypted_env() {
     }
 }
 
+#[cfg(feature = "encryption")]
+#[test]
+fn test_aes_ctr_encrypted_env() {
+    let methods = [
+        (DBEncryptionMethod::Aes128Ctr, 16),
+        (DBEncryptionMethod::Aes192Ctr, 24),
+        (DBEncryptionMethod::Aes256Ctr, 32),
+    ];
+    for &(method, keylen) in &methods {
+        let key = vec![7; keylen];
+        let env = Env::new_aes_ctr_encrypted_env(Arc::new(Env::default()), method, &key).unwrap();
+        test_ctr_encrypted_env_impl(Arc::new(env));
+        assert!(
+            Env::new_aes_ctr_encrypted_env(Arc::new(Env::default()), method, &key[1..]).is_err()
+        );
+    }
+}
+
 fn test_ctr_encrypted_env_impl(encrypted_env: Arc<Env>) {
     let path = tempdir_with_prefix("_rust_rocksdb_cryption_env");
     let path_str = path.path().to_str().unwrap();
@@ -77,4 +98,10 @@ fn test_ctr_encrypted_env_impl(encrypted_env: Arc<Env>) {
     for &(ref k, ref v) in &samples {
         assert_eq!(v.as_slice(), &*db.get(k).unwrap().unwrap());
     }
+
+    // no plaintext value on disk
+    for entry in fs::read_dir(path.path()).unwrap() {
+        let content = fs::read(entry.unwrap().path()).unwrap();
+        assert!(!content.windows(6).any(|w| w == b"value1"));
+    }
 }
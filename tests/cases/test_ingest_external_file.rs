@@ -19,6 +19,20 @@ use rocksdb::*;
 
 use super::tempdir_with_prefix;
 
+struct FixedPrefixTransform {
+    pub prefix_len: usize,
+}
+
+impl SliceTransform for FixedPrefixTransform {
+    fn transform<'a>(&mut self, key: &'a [u8]) -> &'a [u8] {
+        &key[..self.prefix_len]
+    }
+
+    fn in_domain(&mut self, key: &[u8]) -> bool {
+        key.len() >= self.prefix_len
+    }
+}
+
 pub fn gen_sst(
     opt: ColumnFamilyOptions,
     cf: Option<&CFHandle>,
@@ -471,6 +485,67 @@ fn test_set_external_sst_file_global_seq_no() {
     check_kv(&db, None, &[(b"k1", Some(b"v1")), (b"k2", Some(b"v2"))]);
 }
 
+#[test]
+fn test_set_external_sst_files_global_seq_no() {
+    let db_path = tempdir_with_prefix("_rust_rocksdb_set_external_sst_files_global_seq_no_db");
+    let db = create_default_database(&db_path);
+    let handle = db.cf_handle("default").unwrap();
+    let path = tempdir_with_prefix("_rust_rocksdb_set_external_sst_files_global_seq_no");
+    let mut files = vec![];
+    for i in 0..8 {
+        let file = path.path().join(format!("sst_file_{}", i));
+        let file = file.to_str().unwrap().to_owned();
+        let key = format!("k{}", i);
+        gen_sst(
+            ColumnFamilyOptions::new(),
+            Some(handle),
+            &file,
+            &[(key.as_bytes(), b"v")],
+        );
+        files.push(file);
+    }
+
+    let args: Vec<(&str, u64)> = files.iter().map(|f| (f.as_str(), 7)).collect();
+    let pre = set_external_sst_files_global_seq_no(&db, handle, &args, 4).unwrap();
+    assert_eq!(pre, vec![0; 8]);
+    let args: Vec<(&str, u64)> = files.iter().map(|f| (f.as_str(), 0)).collect();
+    let pre = set_external_sst_files_global_seq_no(&db, handle, &args, 4).unwrap();
+    assert_eq!(pre, vec![7; 8]);
+
+    let mut missing = args.clone();
+    missing.push(("not_exist", 0));
+    assert!(set_external_sst_files_global_seq_no(&db, handle, &missing, 4).is_err());
+}
+
+#[test]
+fn test_ingest_without_writing_global_seqno() {
+    let path = tempdir_with_prefix("_rust_rocksdb_ingest_without_writing_global_seqno");
+    let path_str = path.path().to_str().unwrap().to_owned();
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_ingest_without_writing_global_seqno_gen");
+    let file = gen_path.path().join("sst_file");
+    let file_str = file.to_str().unwrap();
+    {
+        let db = create_default_database(&path);
+        let handle = db.cf_handle("default").unwrap();
+        db.put(b"k1", b"old").unwrap();
+        db.flush(true).unwrap();
+        gen_sst(
+            ColumnFamilyOptions::new(),
+            Some(handle),
+            file_str,
+            &[(b"k1", b"new")],
+        );
+        let mut ingest_opt = IngestExternalFileOptions::new();
+        ingest_opt.set_write_global_seqno(false);
+        db.ingest_external_file(&ingest_opt, &[file_str]).unwrap();
+        check_kv(&db, None, &[(b"k1", Some(b"new"))]);
+    }
+    // The ingested copy keeps a zero global seqno, so after a restart the
+    // assigned one must come from the MANIFEST.
+    let db = DB::open_default(&path_str).unwrap();
+    check_kv(&db, None, &[(b"k1", Some(b"new"))]);
+}
+
 #[test]
 fn test_ingest_external_file_optimized() {
     let path = tempdir_with_prefix("_rust_rocksdb_ingest_sst_optimized");
@@ -508,6 +583,77 @@ fn test_ingest_external_file_optimized() {
     assert_eq!(db.get_cf(handle, b"k3").unwrap().unwrap(), b"c");
 }
 
+#[test]
+fn test_ingest_external_files() {
+    let path = tempdir_with_prefix("_rust_rocksdb_ingest_external_files");
+    let mut db = create_default_database(&path);
+    db.create_cf("write").unwrap();
+    db.create_cf("lock").unwrap();
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_ingest_external_files_gen");
+    let mut files = vec![];
+    for name in &["default", "write", "lock"] {
+        let file = gen_path.path().join(name);
+        let file = file.to_str().unwrap().to_owned();
+        gen_sst(
+            ColumnFamilyOptions::new(),
+            Some(db.cf_handle(name).unwrap()),
+            &file,
+            &[(b"k1", name.as_bytes()), (b"k2", name.as_bytes())],
+        );
+        files.push(file);
+    }
+    let default = db.cf_handle("default").unwrap();
+    let write = db.cf_handle("write").unwrap();
+    let lock = db.cf_handle("lock").unwrap();
+    let ingest_opt = IngestExternalFileOptions::new();
+
+    // No overlap with any memtable.
+    db.put_cf(lock, b"k0", b"k0").unwrap();
+    let has_flush = db
+        .ingest_external_files_optimized(&[
+            (default, &ingest_opt, &[files[0].as_str()]),
+            (write, &ingest_opt, &[files[1].as_str()]),
+            (lock, &ingest_opt, &[files[2].as_str()]),
+        ])
+        .unwrap();
+    assert!(!has_flush);
+    for &(cf, name) in &[(default, "default"), (write, "write"), (lock, "lock")] {
+        assert_eq!(db.get_cf(cf, b"k1").unwrap().unwrap(), name.as_bytes());
+        assert_eq!(db.get_cf(cf, b"k2").unwrap().unwrap(), name.as_bytes());
+    }
+
+    // Overlap with one memtable. Only that one is flushed.
+    db.put_cf(default, b"k0", b"k0").unwrap();
+    db.put_cf(write, b"k1", b"k1").unwrap();
+    let has_flush = db
+        .ingest_external_files_optimized(&[
+            (default, &ingest_opt, &[files[0].as_str()]),
+            (write, &ingest_opt, &[files[1].as_str()]),
+        ])
+        .unwrap();
+    assert!(has_flush);
+    assert_eq!(db.get_cf(write, b"k1").unwrap().unwrap(), b"write");
+    let mem_entries = "rocksdb.num-entries-active-mem-table";
+    assert_eq!(db.get_property_int_cf(default, mem_entries), Some(1));
+    assert_eq!(db.get_property_int_cf(write, mem_entries), Some(0));
+
+    // Nothing is ingested if any column family fails.
+    db.delete_cf(lock, b"k1").unwrap();
+    let mut fail_opt = IngestExternalFileOptions::new();
+    fail_opt.allow_blocking_flush(false);
+    fail_opt.allow_global_seqno(false);
+    assert!(db
+        .ingest_external_files(&[
+            (default, &ingest_opt, &[files[0].as_str()]),
+            (lock, &fail_opt, &[files[2].as_str()]),
+        ])
+        .is_err());
+    assert!(db.get_cf(lock, b"k1").unwrap().is_none());
+    db.ingest_external_files(&[(lock, &ingest_opt, &[files[2].as_str()])])
+        .unwrap();
+    assert_eq!(db.get_cf(lock, b"k1").unwrap().unwrap(), b"lock");
+}
+
 #[test]
 fn test_read_sst() {
     let dir = tempdir_with_prefix("_rust_rocksdb_test_read_sst");
@@ -533,6 +679,51 @@ fn test_read_sst() {
     );
 }
 
+#[test]
+fn test_read_sst_with_checksum_type() {
+    let dir = tempdir_with_prefix("_rust_rocksdb_test_read_sst_with_checksum_type");
+    for (i, &checksum) in [
+        DBChecksumType::NoChecksum,
+        DBChecksumType::CRC32c,
+        DBChecksumType::XXHash,
+        DBChecksumType::XXHash64,
+    ]
+    .iter()
+    .enumerate()
+    {
+        let mut block_opts = BlockBasedOptions::new();
+        block_opts.set_checksum(checksum);
+        let mut cf_opts = ColumnFamilyOptions::new();
+        cf_opts.set_block_based_table_factory(&block_opts);
+        let sst_path = dir.path().join(format!("sst_{}", i));
+        let sst_path_str = sst_path.to_str().unwrap();
+        gen_sst(
+            cf_opts,
+            None,
+            sst_path_str,
+            &[(b"k1", b"v1"), (b"k2", b"v2"), (b"k3", b"v3")],
+        );
+
+        let mut reader = SstFileReader::new(ColumnFamilyOptions::default());
+        reader.open(sst_path_str).unwrap();
+        reader.verify_checksum().unwrap();
+        let mut it = reader.iter();
+        it.seek(SeekKey::Start).unwrap();
+        assert_eq!(it.collect::<Vec<_>>().len(), 3);
+        if checksum == DBChecksumType::NoChecksum {
+            continue;
+        }
+
+        // The first data block starts the file.
+        let mut data = fs::read(&sst_path).unwrap();
+        data[1] ^= 0xff;
+        fs::write(&sst_path, data).unwrap();
+        let mut reader = SstFileReader::new(ColumnFamilyOptions::default());
+        reader.open(sst_path_str).unwrap();
+        assert!(reader.verify_checksum().is_err());
+    }
+}
+
 #[test]
 fn test_read_invalid_sst() {
     let dir = tempdir_with_prefix("_rust_rocksdb_test_read_invalid_sst");
@@ -562,4 +753,358 @@ fn test_ingest_external_file_options() {
     assert_eq!(false, ingest_opt.get_write_global_seqno());
     ingest_opt.set_write_global_seqno(true);
     assert_eq!(true, ingest_opt.get_write_global_seqno());
+    assert_eq!(false, ingest_opt.get_ingest_behind());
+    ingest_opt.set_ingest_behind(true);
+    assert_eq!(true, ingest_opt.get_ingest_behind());
+}
+
+#[test]
+fn test_ingest_behind() {
+    let path = tempdir_with_prefix("_rust_rocksdb_ingest_behind");
+    let path_str = path.path().to_str().unwrap();
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    opts.set_allow_ingest_behind(true);
+    assert!(opts.get_allow_ingest_behind());
+    let mut cf_opts = ColumnFamilyOptions::new();
+    cf_opts.set_compaction_style(DBCompactionStyle::Universal);
+    cf_opts.set_num_levels(3);
+    let db = DB::open_cf(opts, path_str, vec![("default", cf_opts.clone())]).unwrap();
+    db.put(b"k1", b"new").unwrap();
+    db.flush(true).unwrap();
+    db.put(b"k2", b"new").unwrap();
+
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_ingest_behind_gen");
+    let sst_path = gen_path.path().join("behind.sst");
+    let sst_str = sst_path.to_str().unwrap();
+    gen_sst(
+        cf_opts,
+        None,
+        sst_str,
+        &[(b"k1", b"old"), (b"k2", b"old"), (b"k3", b"old")],
+    );
+    let mut ingest_opt = IngestExternalFileOptions::new();
+    ingest_opt.set_ingest_behind(true);
+    let handle = db.cf_handle("default").unwrap();
+    db.ingest_external_file_cf(handle, &ingest_opt, &[sst_str])
+        .unwrap();
+    // Existing keys, even in the memtable, shadow the ingested ones.
+    check_kv(
+        &db,
+        None,
+        &[
+            (b"k1", Some(b"new")),
+            (b"k2", Some(b"new")),
+            (b"k3", Some(b"old")),
+        ],
+    );
+    db.compact_range(None, None);
+    check_kv(
+        &db,
+        None,
+        &[
+            (b"k1", Some(b"new")),
+            (b"k2", Some(b"new")),
+            (b"k3", Some(b"old")),
+        ],
+    );
+
+    // Ingesting behind needs the DB to reserve the bottommost level.
+    let path2 = tempdir_with_prefix("_rust_rocksdb_ingest_behind_db2");
+    let db2 = create_default_database(&path2);
+    gen_sst(
+        ColumnFamilyOptions::new(),
+        None,
+        sst_str,
+        &[(b"k1", b"old")],
+    );
+    assert!(db2.ingest_external_file(&ingest_opt, &[sst_str]).is_err());
+}
+
+#[test]
+fn test_parallel_sst_file_writer() {
+    let path = tempdir_with_prefix("_rust_rocksdb_parallel_sst_file_writer");
+    let db = create_default_database(&path);
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_parallel_sst_file_writer_gen");
+    let prefix = gen_path.path().join("bulk_");
+
+    let mut writer = ParallelSstFileWriter::new(
+        EnvOptions::new(),
+        db.get_options(),
+        prefix.to_str().unwrap(),
+        4 * 1024,
+        4,
+    );
+    for i in 0..1000 {
+        let key = format!("k{:04}", i);
+        writer.put(key.as_bytes(), &[b'v'; 64]).unwrap();
+        if i == 10 {
+            // A caller supplied boundary.
+            writer.cut().unwrap();
+            writer.cut().unwrap();
+        }
+    }
+    // Keys must stay sorted across files.
+    assert!(writer.put(b"k0500", b"v").is_err());
+    let files = writer.finish().unwrap();
+    assert!(files.len() > 2);
+    assert_eq!(11, files[0].num_entries());
+    assert_eq!(b"k0010", files[0].largest_key());
+    assert_eq!(b"k0011", files[1].smallest_key());
+    for pair in files.windows(2) {
+        assert!(pair[0].largest_key() < pair[1].smallest_key());
+    }
+    let total: u64 = files.iter().map(|f| f.num_entries()).sum();
+    assert_eq!(1000, total);
+    assert!(writer.finish().is_err());
+
+    let paths: Vec<String> = files
+        .iter()
+        .map(|f| f.file_path().to_str().unwrap().to_owned())
+        .collect();
+    let paths: Vec<&str> = paths.iter().map(|p| p.as_str()).collect();
+    let ingest_opt = IngestExternalFileOptions::new();
+    db.ingest_external_file(&ingest_opt, &paths).unwrap();
+    assert_eq!(db.get(b"k0000").unwrap().unwrap(), &[b'v'; 64][..]);
+    assert_eq!(db.get(b"k0999").unwrap().unwrap(), &[b'v'; 64][..]);
+}
+
+#[test]
+fn test_parallel_sst_file_writer_range_deletion() {
+    let path = tempdir_with_prefix("_rust_rocksdb_parallel_sst_file_writer_range_deletion");
+    let db = create_default_database(&path);
+    for i in 0..1000 {
+        let key = format!("k{:04}", i);
+        db.put(key.as_bytes(), b"old").unwrap();
+    }
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_parallel_sst_file_writer_range_deletion_gen");
+    let prefix = gen_path.path().join("bulk_");
+
+    let mut writer = ParallelSstFileWriter::new(
+        EnvOptions::new(),
+        db.get_options(),
+        prefix.to_str().unwrap(),
+        4 * 1024,
+        4,
+    );
+    // Delete [k0100, k0200), [k0300, k0400), ... and rewrite the rest.
+    for i in 0..1000 {
+        let key = format!("k{:04}", i);
+        match i % 200 {
+            100 => {
+                let end = format!("k{:04}", i + 100);
+                writer.delete_range(key.as_bytes(), end.as_bytes()).unwrap();
+                // The cut waits for the range, which spans several files'
+                // worth of input.
+                writer.cut().unwrap();
+            }
+            101..=199 => {}
+            _ => writer.put(key.as_bytes(), &[b'v'; 64]).unwrap(),
+        }
+    }
+    // Range deletions are ordered by their begin key.
+    assert!(writer.delete_range(b"k0500", b"k0600").is_err());
+    assert!(writer.delete_range(b"k2000", b"k1000").is_err());
+    let files = writer.finish().unwrap();
+    assert!(files.len() > 5);
+    for pair in files.windows(2) {
+        assert!(pair[0].largest_key() < pair[1].smallest_key());
+    }
+
+    // The files only ingest together if no tombstone was split by a cut.
+    let paths: Vec<String> = files
+        .iter()
+        .map(|f| f.file_path().to_str().unwrap().to_owned())
+        .collect();
+    let paths: Vec<&str> = paths.iter().map(|p| p.as_str()).collect();
+    let ingest_opt = IngestExternalFileOptions::new();
+    db.ingest_external_file(&ingest_opt, &paths).unwrap();
+    for i in 0..1000 {
+        let key = format!("k{:04}", i);
+        let value = db.get(key.as_bytes()).unwrap();
+        if i % 200 >= 100 {
+            assert!(value.is_none(), "{} not deleted", key);
+        } else {
+            assert_eq!(value.unwrap(), &[b'v'; 64][..]);
+        }
+    }
+}
+
+#[test]
+fn test_snapshot_exporter() {
+    let path = tempdir_with_prefix("_rust_rocksdb_snapshot_exporter");
+    let mut db = create_default_database(&path);
+    create_cfs(&mut db, &["cf1"]);
+    let cf1 = db.cf_handle("cf1").unwrap();
+    for i in 0..1000 {
+        let key = format!("k{:04}", i);
+        db.put(key.as_bytes(), &[b'v'; 64]).unwrap();
+        db.put_cf(cf1, key.as_bytes(), b"cf1").unwrap();
+    }
+    db.flush(true).unwrap();
+    let snap = db.snapshot();
+    // Writes after the snapshot are not exported.
+    db.delete(b"k0000").unwrap();
+    db.put(b"k0001", b"new").unwrap();
+
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_snapshot_exporter_gen");
+    let default_cf = db.cf_handle("default").unwrap();
+    let mut exporter = SnapshotExporter::new(&snap, gen_path.path().to_str().unwrap(), 4);
+    exporter.set_target_file_size(8 * 1024);
+    let rate_limiter = RateLimiter::new(1024 * 1024, 100 * 1000, 10);
+    exporter.set_rate_limiter(&rate_limiter);
+    exporter.add_range(default_cf, b"k0000", b"k0500");
+    exporter.add_range(default_cf, b"k0500", b"");
+    exporter.add_range(cf1, b"k0100", b"k0110");
+    exporter.add_range(cf1, b"x", b"");
+    let ranges = exporter.run().unwrap();
+    assert_eq!(ranges.len(), 4);
+    assert_eq!(ranges[0].num_keys, 500);
+    assert_eq!(ranges[0].num_bytes, 500 * (5 + 64));
+    assert!(ranges[0].files.len() > 1);
+    assert_eq!(ranges[1].num_keys, 500);
+    assert_eq!(ranges[2].num_keys, 10);
+    assert_eq!(ranges[2].files.len(), 1);
+    assert_eq!(ranges[2].files[0].smallest_key(), b"k0100");
+    assert_eq!(ranges[2].files[0].largest_key(), b"k0109");
+    assert_eq!(ranges[3].num_keys, 0);
+    assert!(ranges[3].files.is_empty());
+    for range in &ranges {
+        let total: u64 = range.files.iter().map(|f| f.num_entries()).sum();
+        assert_eq!(total, range.num_keys);
+    }
+    // Every byte written went through the rate limiter, as low priority.
+    let file_bytes: u64 = ranges
+        .iter()
+        .flat_map(|r| r.files.iter())
+        .map(|f| f.file_size())
+        .sum();
+    let low_bytes = rate_limiter.get_total_bytes_through(RateLimiter::PRIORITY_LOW);
+    assert!(low_bytes as u64 >= file_bytes);
+
+    let path2 = tempdir_with_prefix("_rust_rocksdb_snapshot_exporter_import");
+    let db2 = create_default_database(&path2);
+    let paths: Vec<String> = ranges[..2]
+        .iter()
+        .flat_map(|r| r.files.iter())
+        .map(|f| f.file_path().to_str().unwrap().to_owned())
+        .collect();
+    let paths: Vec<&str> = paths.iter().map(|p| p.as_str()).collect();
+    db2.ingest_external_file(&IngestExternalFileOptions::new(), &paths)
+        .unwrap();
+    assert_eq!(db2.get(b"k0000").unwrap().unwrap(), &[b'v'; 64][..]);
+    assert_eq!(db2.get(b"k0001").unwrap().unwrap(), &[b'v'; 64][..]);
+    assert_eq!(db2.get(b"k0999").unwrap().unwrap(), &[b'v'; 64][..]);
+
+    // The files of the first run stay as they are.
+    assert!(exporter.run().is_err());
+    assert!(ranges[0].files[0].file_path().exists());
+}
+
+#[test]
+fn test_snapshot_exporter_with_prefix_bloom() {
+    let path = tempdir_with_prefix("_rust_rocksdb_snapshot_exporter_prefix_bloom");
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    let mut block_opts = BlockBasedOptions::new();
+    block_opts.set_bloom_filter(10, false);
+    block_opts.set_whole_key_filtering(false);
+    let mut cf_opts = ColumnFamilyOptions::new();
+    cf_opts.set_block_based_table_factory(&block_opts);
+    cf_opts
+        .set_prefix_extractor(
+            "FixedPrefixTransform",
+            Box::new(FixedPrefixTransform { prefix_len: 2 }),
+        )
+        .unwrap();
+    cf_opts.set_memtable_prefix_bloom_size_ratio(0.1);
+    cf_opts.set_disable_auto_compactions(true);
+    let db = DB::open_cf(
+        opts,
+        path.path().to_str().unwrap(),
+        vec![("default", cf_opts)],
+    )
+    .unwrap();
+    // One file per prefix, so that each prefix has its own bloom filter.
+    for prefix in &["k1", "k2", "k3"] {
+        for i in 0..10 {
+            db.put(format!("{}-{}", prefix, i).as_bytes(), b"v")
+                .unwrap();
+        }
+        db.flush(true).unwrap();
+    }
+    let snap = db.snapshot();
+
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_snapshot_exporter_prefix_bloom_gen");
+    let default_cf = db.cf_handle("default").unwrap();
+    let mut exporter = SnapshotExporter::new(&snap, gen_path.path().to_str().unwrap(), 1);
+    exporter.add_range(default_cf, b"k1-5", b"");
+    let ranges = exporter.run().unwrap();
+    assert_eq!(ranges[0].num_keys, 25);
+    assert_eq!(ranges[0].files[0].smallest_key(), b"k1-5");
+    assert_eq!(ranges[0].files[0].largest_key(), b"k3-9");
+}
+
+#[test]
+fn test_sst_file_writer_file_checksum() {
+    let path = tempdir_with_prefix("_rust_rocksdb_sst_file_checksum");
+    let db = create_default_database(&path);
+    let gen_path = tempdir_with_prefix("_rust_rocksdb_sst_file_checksum_gen");
+    let env = Env::default();
+
+    for &(checksum_type, len, name) in &[
+        (DBFileChecksumType::Crc32c, 4, "FileChecksumCrc32c"),
+        (DBFileChecksumType::XXH64, 8, "FileChecksumXXH64"),
+    ] {
+        let file = gen_path.path().join(name);
+        let file = file.to_str().unwrap();
+        let mut writer = SstFileWriter::new_with_file_checksum(
+            EnvOptions::new(),
+            db.get_options(),
+            None,
+            checksum_type,
+        )
+        .unwrap();
+        writer.open(file).unwrap();
+        for i in 0..100 {
+            let key = format!("{}_{:03}", name, i);
+            writer.put(key.as_bytes(), b"v").unwrap();
+        }
+        let info = writer.finish().unwrap();
+        assert_eq!(name, info.file_checksum_func_name());
+        let checksum = info.file_checksum().to_vec();
+        assert_eq!(len, checksum.len());
+
+        env.verify_file_checksum(file, checksum_type, &checksum)
+            .unwrap();
+        let mut wrong = checksum.clone();
+        wrong[0] ^= 0xff;
+        assert!(env
+            .verify_file_checksum(file, checksum_type, &wrong)
+            .is_err());
+
+        // A corrupted copy must not pass.
+        let copy = gen_path.path().join(format!("{}_copy", name));
+        let mut data = fs::read(file).unwrap();
+        data[0] ^= 0xff;
+        fs::write(&copy, data).unwrap();
+        assert!(env
+            .verify_file_checksum(copy.to_str().unwrap(), checksum_type, &checksum)
+            .is_err());
+
+        let ingest_opt = IngestExternalFileOptions::new();
+        db.ingest_external_file(&ingest_opt, &[file]).unwrap();
+    }
+    assert_eq!(db.get(b"FileChecksumXXH64_099").unwrap().unwrap(), b"v");
+
+    // A plain writer doesn't compute any checksum.
+    let file = gen_path.path().join("plain");
+    let info = {
+        let mut writer = SstFileWriter::new(EnvOptions::new(), db.get_options());
+        writer.open(file.to_str().unwrap()).unwrap();
+        writer.put(b"k", b"v").unwrap();
+        writer.finish().unwrap()
+    };
+    assert!(info.file_checksum().is_empty());
+    assert_eq!("", info.file_checksum_func_name());
 }
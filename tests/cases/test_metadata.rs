@@ -15,6 +15,8 @@ use rocksdb::{
     CFHandle, ColumnFamilyOptions, CompactionOptions, DBCompressionType, DBOptions, Writable, DB,
 };
 
+use std::path::Path;
+
 use super::tempdir_with_prefix;
 
 #[test]
@@ -105,3 +107,62 @@ fn test_compact_files() {
         .unwrap();
     assert_eq!(get_files_cf(&db, cf_handle, 0).len(), 1);
 }
+
+#[test]
+fn test_live_files_diff() {
+    let path = tempdir_with_prefix("_rust_rocksdb_test_live_files_diff");
+    let path_str = path.path().to_str().unwrap();
+    let mut opts = DBOptions::new();
+    opts.create_if_missing(true);
+    let db = DB::open(opts, path_str).unwrap();
+
+    db.put(b"k1", b"v1").unwrap();
+    db.flush(true).unwrap();
+    let mut first = db.get_live_files_diff(None).unwrap();
+    assert_eq!(first.get_added().len(), 1);
+    assert!(first.get_removed().is_empty());
+    first.release_files();
+
+    db.put(b"k1", b"v2").unwrap();
+    db.put(b"k2", b"v2").unwrap();
+    db.flush(true).unwrap();
+    let mut second = db.get_live_files_diff(Some(&first)).unwrap();
+    let first_files: Vec<_> = first.get_added().iter().map(|f| f.get_name()).collect();
+    {
+        let added = second.get_added();
+        assert_eq!(added.len(), 1);
+        assert_eq!(added[0].get_level(), 0);
+        assert_eq!(added[0].get_column_family_name(), "default");
+        assert_eq!(added[0].get_smallestkey(), b"k1");
+        assert_eq!(added[0].get_largestkey(), b"k2");
+        assert!(added[0].get_smallest_seqno() > 0);
+        assert!(added[0].get_largest_seqno() >= added[0].get_smallest_seqno());
+        assert!(added[0].get_size() > 0);
+        assert!(second.get_removed().is_empty());
+    }
+    let second_files: Vec<_> = second.get_added().iter().map(|f| f.get_name()).collect();
+
+    db.compact_range(None, None);
+    let third = db.get_live_files_diff(Some(&second)).unwrap();
+    let mut removed: Vec<_> = third.get_removed().iter().map(|f| f.get_name()).collect();
+    removed.sort();
+    let mut expected = first_files.clone();
+    expected.extend(second_files.clone());
+    expected.sort();
+    assert_eq!(removed, expected);
+    assert_eq!(third.get_added().len(), 1);
+    assert!(third.get_added()[0].get_level() > 0);
+
+    // The compacted files are kept for the diffs that are not released yet.
+    let exists = |name: &str| Path::new(&format!("{}{}", path_str, name)).exists();
+    assert!(second_files.iter().all(|f| exists(f)));
+    second.release_files();
+    assert!(second_files.iter().all(|f| exists(f)));
+    drop(second);
+
+    let fourth = db.get_live_files_diff(Some(&third)).unwrap();
+    assert!(fourth.get_added().is_empty());
+    assert!(fourth.get_removed().is_empty());
+    drop(third);
+    assert!(!second_files.iter().any(|f| exists(f)));
+}
@@ -11,9 +11,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::sync::Arc;
 use std::thread;
 
-use rocksdb::RateLimiter;
+use rocksdb::{DBOptions, DBRateLimiterMode, RateLimiter};
 
 #[test]
 fn test_rate_limiter() {
@@ -25,9 +26,9 @@ fn test_rate_limiter() {
 
     assert_eq!(rate_limiter.get_singleburst_bytes(), 2 * 1024 * 1024);
 
-    let low = 0;
-    let high = 1;
-    let total = 2;
+    let low = RateLimiter::PRIORITY_LOW;
+    let high = RateLimiter::PRIORITY_HIGH;
+    let total = RateLimiter::PRIORITY_TOTAL;
 
     assert_eq!(rate_limiter.get_total_bytes_through(total), 0);
 
@@ -45,8 +46,84 @@ fn test_rate_limiter_sendable() {
     let rate_limiter = RateLimiter::new(10 * 1024 * 1024, 100 * 1000, 10);
 
     let handle = thread::spawn(move || {
-        rate_limiter.request(1024, 0);
+        rate_limiter.request(1024, RateLimiter::PRIORITY_LOW);
     });
 
     handle.join().unwrap();
 }
+
+#[test]
+fn test_priority_rate_limiter() {
+    let low = RateLimiter::PRIORITY_LOW;
+    let high = RateLimiter::PRIORITY_HIGH;
+    let total = RateLimiter::PRIORITY_TOTAL;
+    let mid = RateLimiter::PRIORITY_MID;
+    let user = RateLimiter::PRIORITY_USER;
+
+    // 1MB/s with a 100KB burst every 100ms.
+    let rate_limiter = Arc::new(RateLimiter::new_priority(
+        1024 * 1024,
+        100 * 1000,
+        4,
+        2,
+        1,
+        DBRateLimiterMode::WriteOnly,
+    ));
+    assert_eq!(rate_limiter.get_singleburst_bytes(), 104857);
+
+    let handles: Vec<_> = [low, mid, user]
+        .iter()
+        .map(|&pri| {
+            let rate_limiter = rate_limiter.clone();
+            thread::spawn(move || {
+                for _ in 0..8 {
+                    rate_limiter.request(32 * 1024, pri);
+                }
+            })
+        })
+        .collect();
+    rate_limiter.request(1024, high);
+    for h in handles {
+        h.join().unwrap();
+    }
+
+    // Each priority is accounted on its own.
+    for &pri in &[low, mid, user] {
+        assert_eq!(rate_limiter.get_total_bytes_through(pri), 256 * 1024);
+        assert_eq!(rate_limiter.get_total_requests(pri), 8);
+    }
+    assert_eq!(rate_limiter.get_total_bytes_through(high), 1024);
+    assert_eq!(rate_limiter.get_total_requests(high), 1);
+    assert_eq!(
+        rate_limiter.get_total_bytes_through(total),
+        3 * 256 * 1024 + 1024
+    );
+    assert_eq!(rate_limiter.get_total_requests(total), 3 * 8 + 1);
+    // 768KB through a 1MB/s limiter can't all go through the first burst.
+    assert!(rate_limiter.get_total_wait_micros(total) > 0);
+
+    // The limiter stays usable after it is shared with a DB.
+    let mut opts = DBOptions::new();
+    opts.set_shared_rate_limiter(&rate_limiter);
+    assert_eq!(opts.get_rate_bytes_per_sec(), Some(1024 * 1024));
+    rate_limiter.request(1024, mid);
+    assert_eq!(rate_limiter.get_total_requests(mid), 9);
+    // Taken back from the options, it still tells the priorities apart.
+    let shared = opts.get_rate_limiter().unwrap();
+    shared.request(1024, user);
+    assert_eq!(rate_limiter.get_total_requests(user), 9);
+    assert_eq!(
+        shared.get_total_wait_micros(total),
+        rate_limiter.get_total_wait_micros(total)
+    );
+
+    // Other limiters treat mid and user as low and high.
+    let rate_limiter = RateLimiter::new(10 * 1024 * 1024, 100 * 1000, 10);
+    rate_limiter.request(1024, mid);
+    rate_limiter.request(2048, user);
+    assert_eq!(rate_limiter.get_total_bytes_through(low), 1024);
+    assert_eq!(rate_limiter.get_total_bytes_through(high), 2048);
+    assert_eq!(rate_limiter.get_total_bytes_through(mid), 0);
+    assert_eq!(rate_limiter.get_total_requests(user), 0);
+    assert_eq!(rate_limiter.get_total_wait_micros(total), 0);
+}
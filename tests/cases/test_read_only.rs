@@ -90,3 +90,39 @@ fn test_open_cf_for_read_only() {
         check_kv!(r2, cf2, b"cf2_k3", b"cf2_v3");
     }
 }
+
+#[test]
+fn test_open_as_secondary() {
+    let temp = tempdir_with_prefix("_rust_rocksdb_test_open_as_secondary");
+    let path = temp.path().to_str().unwrap();
+    let secondary_temp = tempdir_with_prefix("_rust_rocksdb_test_open_as_secondary_2nd");
+    let secondary_path = secondary_temp.path().to_str().unwrap();
+
+    let mut rw = DB::open_default(path).unwrap();
+    let _ = rw.create_cf("cf1").unwrap();
+    rw.put(b"k1", b"v1").unwrap();
+    rw.flush(true).unwrap();
+
+    let mut opts = DBOptions::new();
+    opts.set_max_open_files(-1);
+    let secondary =
+        DB::open_cf_as_secondary(opts.clone(), path, secondary_path, vec!["default", "cf1"])
+            .unwrap();
+    check_kv!(secondary, b"k1", b"v1");
+    assert!(secondary.put(b"k2", b"v2").is_err());
+
+    // Changes of the primary, flushed or only in the WAL, show up after
+    // catching up.
+    rw.put(b"k2", b"v2").unwrap();
+    rw.flush(true).unwrap();
+    let cf1 = rw.cf_handle("cf1").unwrap();
+    rw.put_cf(cf1, b"cf1_k1", b"cf1_v1").unwrap();
+    assert!(secondary.get(b"k2").unwrap().is_none());
+    secondary.try_catch_up_with_primary().unwrap();
+    check_kv!(secondary, b"k2", b"v2");
+    let secondary_cf1 = secondary.cf_handle("cf1").unwrap();
+    check_kv!(secondary, secondary_cf1, b"cf1_k1", b"cf1_v1");
+
+    opts.set_max_open_files(100);
+    assert!(DB::open_as_secondary(opts, path, secondary_path).is_err());
+}
@@ -11,6 +11,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::fs;
 use std::path::Path;
 use std::sync::Arc;
 use std::thread;
@@ -22,8 +23,8 @@ use rocksdb::crocksdb_ffi::{
 };
 use rocksdb::{
     BlockBasedOptions, Cache, ColumnFamilyOptions, CompactOptions, DBOptions, Env,
-    FifoCompactionOptions, IndexType, LRUCacheOptions, ReadOptions, SeekKey, SliceTransform,
-    Writable, WriteOptions, DB,
+    FifoCompactionOptions, IndexType, LRUCacheOptions, PersistentCache, ReadOptions, SeekKey,
+    SliceTransform, Writable, WriteBufferManager, WriteOptions, DB,
 };
 
 use super::tempdir_with_prefix;
@@ -166,6 +167,60 @@ fn test_set_ratelimiter() {
     drop(db);
 }
 
+#[test]
+fn test_shared_write_buffer_manager() {
+    let mut cache_opts = LRUCacheOptions::new();
+    cache_opts.set_capacity(64 * 1024 * 1024);
+    let cache = Cache::new_lru_cache(cache_opts);
+    let manager = WriteBufferManager::new(4 * 1024 * 1024, Some(&cache));
+    assert_eq!(4 * 1024 * 1024, manager.buffer_size());
+    assert!(manager.cost_to_cache());
+    assert!(!WriteBufferManager::new(0, None).cost_to_cache());
+
+    let open = |name: &str| {
+        let path = tempdir_with_prefix(name);
+        let mut opts = DBOptions::new();
+        opts.create_if_missing(true);
+        opts.set_write_buffer_manager(&manager);
+        let mut cf_opts = ColumnFamilyOptions::new();
+        // Alone, neither DB would ever fill a memtable.
+        cf_opts.set_write_buffer_size(64 * 1024 * 1024);
+        let db = DB::open_cf(
+            opts,
+            path.path().to_str().unwrap(),
+            vec![("default", cf_opts)],
+        )
+        .unwrap();
+        (path, db)
+    };
+    let (_path1, db1) = open("_rust_rocksdb_test_write_buffer_manager_1");
+    let (_path2, db2) = open("_rust_rocksdb_test_write_buffer_manager_2");
+
+    let value = vec![b'v'; 1024];
+    for i in 0..2048 {
+        db1.put(format!("k{:06}", i).as_bytes(), &value).unwrap();
+    }
+    assert!(manager.memory_usage() >= 2 * 1024 * 1024);
+    assert!(manager.mutable_memtable_memory_usage() >= 2 * 1024 * 1024);
+    // The memtables are charged to the block cache.
+    assert!(cache.get_usage() >= 2 * 1024 * 1024);
+
+    // Together they exceed the shared budget, so writes to db2 trigger a flush
+    // even though db2 holds less than the budget.
+    for i in 0..3072 {
+        db2.put(format!("k{:06}", i).as_bytes(), &value).unwrap();
+    }
+    let mut flushed = false;
+    for _ in 0..100 {
+        if db2.get_property_int("rocksdb.num-files-at-level0").unwrap() > 0 {
+            flushed = true;
+            break;
+        }
+        thread::sleep(Duration::from_millis(100));
+    }
+    assert!(flushed);
+}
+
 #[test]
 fn test_set_ratelimiter_with_auto_tuned() {
     let path = tempdir_with_prefix("_rust_rocksdb_test_set_rate_limiter_with_auto_tuned");
@@ -522,6 +577,99 @@ fn test_block_cache_capacity() {
     );
 }
 
+#[test]
+fn test_compressed_secondary_cache() {
+    let path = tempdir_with_prefix("_rust_rocksdb_compressed_secondary_cache");
+
+    let mut opts = DBOptions::new();
+    let mut cf_opts = ColumnFamilyOptions::new();
+    opts.create_if_missing(true);
+    opts.enable_statistics(true);
+    let mut block_opts = BlockBasedOptions::new();
+    let mut cache_opts = LRUCacheOptions::new();
+    cache_opts.set_capacity(64 * 1024);
+    cache_opts.set_num_shard_bits(0);
+    cache_opts.set_compressed_secondary_capacity(16 * 1024 * 1024);
+    let cache = Cache::new_lru_cache(cache_opts);
+    assert_eq!(cache.get_compressed_secondary_capacity(), 16 * 1024 * 1024);
+    block_opts.set_block_cache(&cache);
+    cf_opts.set_block_based_table_factory(&block_opts);
+    cf_opts.compression(DBCompressionType::Lz4);
+    let db = DB::open_cf(
+        opts,
+        path.path().to_str().unwrap(),
+        vec![("default", cf_opts)],
+    )
+    .unwrap();
+
+    let value = vec![b'v'; 1024];
+    for i in 0..2000 {
+        db.put(format!("k_{:04}", i).as_bytes(), &value).unwrap();
+    }
+    db.flush(true).unwrap();
+    // The working set is much larger than the primary cache, so the second pass
+    // has to be served by the compressed tier.
+    for _ in 0..2 {
+        for i in 0..2000 {
+            db.get(format!("k_{:04}", i).as_bytes()).unwrap().unwrap();
+        }
+    }
+
+    assert!(cache.get_compressed_secondary_usage() > 0);
+    assert!(db.get_statistics_ticker_count(TickerType::BlockCacheCompressedHit) > 0);
+}
+
+#[test]
+fn test_persistent_cache() {
+    let path = tempdir_with_prefix("_rust_rocksdb_persistent_cache");
+    let cache_path = tempdir_with_prefix("_rust_rocksdb_persistent_cache_files");
+
+    let mut opts = DBOptions::new();
+    let mut cf_opts = ColumnFamilyOptions::new();
+    opts.create_if_missing(true);
+    opts.enable_statistics(true);
+    let persistent_cache = PersistentCache::new(
+        cache_path.path().to_str().unwrap(),
+        64 * 1024 * 1024,
+        false, /* optimized_for_nvm */
+    )
+    .unwrap();
+    let mut block_opts = BlockBasedOptions::new();
+    let mut cache_opts = LRUCacheOptions::new();
+    cache_opts.set_capacity(64 * 1024);
+    cache_opts.set_num_shard_bits(0);
+    cache_opts.set_persistent_cache(&persistent_cache);
+    block_opts.set_block_cache(&Cache::new_lru_cache(cache_opts));
+    cf_opts.set_block_based_table_factory(&block_opts);
+    let db = DB::open_cf(
+        opts,
+        path.path().to_str().unwrap(),
+        vec![("default", cf_opts)],
+    )
+    .unwrap();
+    drop(persistent_cache);
+
+    let value = vec![b'v'; 1024];
+    for i in 0..2000 {
+        db.put(format!("k_{:04}", i).as_bytes(), &value).unwrap();
+    }
+    db.flush(true).unwrap();
+    // Blocks are inserted into the persistent tier by a background pipeline, so
+    // keep reading until they show up there.
+    let mut hit = false;
+    for _ in 0..100 {
+        for i in 0..2000 {
+            db.get(format!("k_{:04}", i).as_bytes()).unwrap().unwrap();
+        }
+        if db.get_statistics_ticker_count(TickerType::PersistentCacheHit) > 0 {
+            hit = true;
+            break;
+        }
+        thread::sleep(Duration::from_millis(100));
+    }
+    assert!(hit);
+}
+
 #[test]
 fn test_disable_block_cache() {
     let mut cf_opts = ColumnFamilyOptions::new();
@@ -599,6 +747,87 @@ fn test_set_max_background_compactions_and_flushes() {
     DB::open(opts, path.path().to_str().unwrap()).unwrap();
 }
 
+#[test]
+fn test_open_options_and_profile() {
+    let path = tempdir_with_prefix("_rust_rocksdb_open_profile");
+    let path_str = path.path().to_str().unwrap();
+    {
+        let db = DB::open_default(path_str).unwrap();
+        for i in 0..3 {
+            db.put(format!("k{}", i).as_bytes(), b"v").unwrap();
+            db.flush(true).unwrap();
+        }
+        // Left in the WAL.
+        db.put(b"k3", b"v").unwrap();
+    }
+
+    let mut opts = DBOptions::new();
+    opts.set_max_open_files(-1);
+    opts.set_max_file_opening_threads(4);
+    assert_eq!(opts.get_max_file_opening_threads(), 4);
+    opts.set_skip_stats_update_on_db_open(true);
+    assert!(opts.get_skip_stats_update_on_db_open());
+    opts.set_skip_checking_sst_file_sizes_on_db_open(true);
+    assert!(opts.get_skip_checking_sst_file_sizes_on_db_open());
+    let cfds: Vec<&str> = vec![];
+    let (db, profile) = DB::open_cf_with_profile(opts, path_str, cfds).unwrap();
+    assert_eq!(db.get(b"k3").unwrap().unwrap(), b"v");
+    assert!(profile.manifest_replay.file_count >= 1);
+    assert!(profile.table_opening.file_count >= 3);
+    assert!(profile.wal_recovery.file_count >= 1);
+    assert!(profile.options_persistence.file_count >= 1);
+    let phases = profile.manifest_replay.duration
+        + profile.table_opening.duration
+        + profile.wal_recovery.duration
+        + profile.options_persistence.duration;
+    assert!(phases <= profile.total);
+}
+
+#[test]
+fn test_wal_recovery_profile() {
+    let path = tempdir_with_prefix("_rust_rocksdb_wal_recovery_profile");
+    let path_str = path.path().to_str().unwrap();
+    let sst_count = || {
+        fs::read_dir(path_str)
+            .unwrap()
+            .filter(|e| e.as_ref().unwrap().path().extension() == Some("sst".as_ref()))
+            .count()
+    };
+    {
+        let mut opts = DBOptions::new();
+        opts.create_if_missing(true);
+        opts.set_avoid_flush_during_shutdown(true);
+        assert!(opts.get_avoid_flush_during_shutdown());
+        let db = DB::open(opts, path_str).unwrap();
+        for i in 0..100 {
+            db.put(format!("k{:03}", i).as_bytes(), b"v").unwrap();
+        }
+    }
+    assert_eq!(sst_count(), 0);
+
+    let cfds: Vec<&str> = vec![];
+    {
+        let mut opts = DBOptions::new();
+        opts.set_avoid_flush_during_recovery(true);
+        assert!(opts.get_avoid_flush_during_recovery());
+        let (db, profile) = DB::open_cf_with_profile(opts, path_str, cfds.clone()).unwrap();
+        assert_eq!(db.get(b"k099").unwrap().unwrap(), b"v");
+        assert_eq!(profile.wal_recovered_entries, 100);
+        assert!(!profile.wal_files.is_empty());
+        assert!(profile.wal_files[0].name.ends_with(".log"));
+        assert!(profile.wal_recovered_bytes() > 100 * 4);
+        // Nothing was flushed.
+        assert_eq!(sst_count(), 0);
+    }
+
+    // Replayed again, and flushed this time.
+    let (db, profile) = DB::open_cf_with_profile(DBOptions::new(), path_str, cfds).unwrap();
+    assert_eq!(db.get(b"k099").unwrap().unwrap(), b"v");
+    assert_eq!(profile.wal_recovered_entries, 100);
+    assert!(profile.wal_recovered_entries_per_sec() >= 0.0);
+    assert_eq!(sst_count(), 1);
+}
+
 #[test]
 fn test_set_compaction_pri() {
     let path = tempdir_with_prefix("_rust_rocksdb_compaction_pri");
@@ -0,0 +1,62 @@
+// Copyright 2020 PingCAP, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use rocksdb::{DBTraceOpType, ReadOptions, SeekKey, Writable, DB};
+
+use super::tempdir_with_prefix;
+
+#[test]
+fn test_trace_replay() {
+    let path = tempdir_with_prefix("_rust_rocksdb_trace_replay");
+    let trace_path = path.path().join("trace");
+    let trace_path = trace_path.to_str().unwrap();
+
+    {
+        let db = DB::open_default(path.path().join("db").to_str().unwrap()).unwrap();
+        db.start_trace(trace_path, 1, 64 << 20).unwrap();
+        for i in 0..100 {
+            let key = format!("k{:03}", i);
+            db.put(key.as_bytes(), b"v").unwrap();
+            assert!(db.get(key.as_bytes()).unwrap().is_some());
+        }
+        let mut iter = db.iter_opt(ReadOptions::new());
+        assert!(iter.seek(SeekKey::Key(b"k050")).unwrap());
+        db.end_trace().unwrap();
+    }
+
+    for &threads in &[1, 4] {
+        let db_path = path.path().join(format!("replay_{}", threads));
+        let db = DB::open_default(db_path.to_str().unwrap()).unwrap();
+        let mut replayer = db
+            .new_trace_replayer(trace_path, &[db.cf_handle("default").unwrap()])
+            .unwrap();
+        replayer.set_speed(0.0);
+        replayer.set_threads(threads);
+        replayer.replay().unwrap();
+        assert_eq!(replayer.num_ops(DBTraceOpType::Write), 100);
+        assert_eq!(replayer.num_ops(DBTraceOpType::Get), 100);
+        assert_eq!(replayer.num_ops(DBTraceOpType::Seek), 1);
+        let hist = replayer.histogram(DBTraceOpType::Get).unwrap();
+        assert!(hist.max >= hist.median);
+        drop(replayer);
+        for i in 0..100 {
+            let key = format!("k{:03}", i);
+            assert!(db.get(key.as_bytes()).unwrap().is_some());
+        }
+    }
+
+    let db = DB::open_default(path.path().join("db").to_str().unwrap()).unwrap();
+    assert!(db
+        .new_trace_replayer(&format!("{}.missing", trace_path), &[])
+        .is_err());
+}